@@ -30,6 +30,11 @@ inline CollectionData::iterator CollectionData::createIterator(
   return iterator(resources->getVariant(head_), head_);
 }
 
+inline CollectionData::iterator CollectionData::createIterator(
+    SlotId id, const ResourceManager* resources) const {
+  return iterator(resources->getVariant(id), id);
+}
+
 inline void CollectionData::appendOne(Slot<VariantData> slot,
                                       const ResourceManager* resources) {
   if (tail_ != NULL_SLOT) {
@@ -58,6 +63,9 @@ inline void CollectionData::appendPair(Slot<VariantData> key,
 }
 
 inline void CollectionData::clear(ResourceManager* resources) {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  resources->dropKeyIndex(this);
+#endif
   auto next = head_;
   while (next != NULL_SLOT) {
     auto currId = next;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Namespace.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
 #include <ArduinoJson/Polyfills/utility.hpp>
 
 #include <stdlib.h>  // for size_t
@@ -39,6 +40,7 @@ struct BoundedReader {
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
 
+#include <ArduinoJson/Deserialization/Readers/InPlaceReader.hpp>
 #include <ArduinoJson/Deserialization/Readers/IteratorReader.hpp>
 #include <ArduinoJson/Deserialization/Readers/RamReader.hpp>
 #include <ArduinoJson/Deserialization/Readers/VariantReader.hpp>
@@ -71,4 +73,15 @@ BoundedReader<TChar*> makeReader(TChar* input, size_t inputSize) {
   return BoundedReader<TChar*>{input, inputSize};
 }
 
+// Readers over contiguous memory expose position(), end(), and skip(), so the
+// deserializer can scan several characters at once
+template <typename TReader, typename Enable = void>
+struct IsContiguousReader : false_type {};
+
+template <typename TReader>
+struct IsContiguousReader<
+    TReader,
+    enable_if_t<is_convertible<decltype(declval<TReader&>().position()),
+                               const char*>::value>> : true_type {};
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,51 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Reads a mutable buffer that outlives the document.
+// The deserializer unescapes strings over the input and links them instead of
+// copying them into the string pool.
+class InPlaceReader {
+  char *ptr_, *end_;
+
+ public:
+  explicit InPlaceReader(char* begin, char* end) : ptr_(begin), end_(end) {}
+
+  int read() {
+    if (ptr_ < end_)
+      return static_cast<unsigned char>(*ptr_++);
+    else
+      return -1;
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t i = 0;
+    while (i < length && ptr_ < end_)
+      buffer[i++] = *ptr_++;
+    return i;
+  }
+
+  // Returns the address of the next character to be read.
+  char* position() const {
+    return ptr_;
+  }
+
+  const char* end() const {
+    return end_;
+  }
+
+  void skip(size_t n) {
+    ptr_ += n;
+  }
+};
+
+template <typename TReader>
+struct IsInPlaceReader : is_same<TReader, InPlaceReader> {};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
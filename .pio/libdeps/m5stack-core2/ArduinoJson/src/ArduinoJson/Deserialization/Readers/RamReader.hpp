@@ -35,6 +35,19 @@ struct Reader<TSource*, enable_if_t<IsCharOrVoid<TSource>::value>> {
       buffer[i] = *ptr_++;
     return length;
   }
+
+  const char* position() const {
+    return ptr_;
+  }
+
+  // The input is null-terminated, its end is unknown
+  const char* end() const {
+    return nullptr;
+  }
+
+  void skip(size_t n) {
+    ptr_ += n;
+  }
 };
 
 template <typename TSource>
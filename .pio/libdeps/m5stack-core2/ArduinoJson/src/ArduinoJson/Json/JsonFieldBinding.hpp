@@ -0,0 +1,401 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/JsonEventDeserializer.hpp>
+#include <ArduinoJson/Numbers/convertNumber.hpp>
+
+#include <stddef.h>  // offsetof
+#include <string.h>  // memcmp, memcpy
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+enum class JsonFieldKind : uint8_t {
+  Bool,
+  Int8,
+  UInt8,
+  Int16,
+  UInt16,
+  Int32,
+  UInt32,
+  Int64,
+  UInt64,
+  Float,
+  Double,
+  String,  // char[N], always null-terminated, truncated if needed
+};
+
+template <typename T, typename Enable = void>
+struct JsonFieldKindOf {
+  static_assert(sizeof(T) == 0, "unsupported field type");
+};
+
+template <>
+struct JsonFieldKindOf<bool> {
+  static constexpr JsonFieldKind value = JsonFieldKind::Bool;
+};
+
+template <typename T>
+struct JsonFieldKindOf<
+    T, enable_if_t<is_integral<T>::value && !is_same<T, bool>::value>> {
+  static constexpr JsonFieldKind value =
+      sizeof(T) == 1   ? (is_signed<T>::value ? JsonFieldKind::Int8
+                                              : JsonFieldKind::UInt8)
+      : sizeof(T) == 2 ? (is_signed<T>::value ? JsonFieldKind::Int16
+                                              : JsonFieldKind::UInt16)
+      : sizeof(T) == 4 ? (is_signed<T>::value ? JsonFieldKind::Int32
+                                              : JsonFieldKind::UInt32)
+                       : (is_signed<T>::value ? JsonFieldKind::Int64
+                                              : JsonFieldKind::UInt64);
+};
+
+template <typename T>
+struct JsonFieldKindOf<T, enable_if_t<is_floating_point<T>::value>> {
+  static constexpr JsonFieldKind value =
+      sizeof(T) == 4 ? JsonFieldKind::Float : JsonFieldKind::Double;
+};
+
+template <size_t N>
+struct JsonFieldKindOf<char[N]> {
+  static constexpr JsonFieldKind value = JsonFieldKind::String;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Tells deserializeJsonFields() where to store the value at a given path.
+// The path is a list of keys and array indexes separated by dots, like
+// "weather.0.main". Declare fields with ARDUINOJSON_FIELD().
+template <typename TStruct>
+struct JsonField {
+  const char* path;
+  size_t offset;
+  size_t size;
+  detail::JsonFieldKind kind;
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// The member pointer is only used to deduce the types
+template <typename TStruct, typename TMember>
+constexpr JsonField<TStruct> makeJsonField(const char* path, size_t offset,
+                                           TMember TStruct::*) {
+  return {path, offset, sizeof(TMember), JsonFieldKindOf<TMember>::value};
+}
+
+// Receives the events of JsonEventDeserializer and stores the values whose
+// path matches a field.
+// The fields still matching the keys and indexes seen so far are kept as a
+// bitmask per nesting level, so walking the table is like walking a trie of
+// the paths: each key is compared once per candidate, and the subtrees that
+// no field mentions are skipped without comparing anything.
+// The paths are split into segments once, by the constructor.
+template <typename TStruct, size_t N>
+class JsonFieldBinder : public JsonEventHandler {
+ public:
+  using Mask = uint32_t;
+  static const size_t maxFields = sizeof(Mask) * 8;
+  static const uint8_t maxDepth = 8;  // segments in a path
+
+  static_assert(N <= maxFields, "too many fields");
+
+  JsonFieldBinder(TStruct& target, const JsonField<TStruct> (&fields)[N])
+      : target_(reinterpret_cast<char*>(&target)), fields_(fields) {
+    for (size_t i = 0; i < N; i++)
+      splitPath(fields[i].path, paths_[i]);
+    // The root is the value every field descends from
+    valueMask_ = N >= maxFields ? Mask(-1) : (Mask(1) << N) - 1;
+  }
+
+  bool onStartObject() {
+    enter(false);
+    return true;
+  }
+
+  bool onStartArray() {
+    enter(true);
+    return true;
+  }
+
+  bool onEndObject() {
+    leave();
+    return true;
+  }
+
+  bool onEndArray() {
+    leave();
+    return true;
+  }
+
+  bool onKey(JsonString key) {
+    if (skippedLevels_)
+      return true;
+    Mask mask = 0;
+    for (size_t i = 0; i < N; i++) {
+      if ((levels_[depth_ - 1].mask >> i) & 1) {
+        const Segment& segment = paths_[i].segments[depth_ - 1];
+        if (segment.length == key.size() &&
+            memcmp(fields_[i].path + segment.start, key.c_str(),
+                   segment.length) == 0)
+          mask |= Mask(1) << i;
+      }
+    }
+    valueMask_ = mask;
+    return true;
+  }
+
+  bool onString(JsonString value) {
+    beforeValue();
+    for (size_t i = 0; i < N; i++) {
+      if (isLeafOfValue(i) && fields_[i].kind == JsonFieldKind::String) {
+        char* dst = target_ + fields_[i].offset;
+        size_t n = value.size() < fields_[i].size - 1 ? value.size()
+                                                       : fields_[i].size - 1;
+        memcpy(dst, value.c_str(), n);
+        dst[n] = 0;
+      }
+    }
+    return true;
+  }
+
+  bool onInteger(JsonInteger value) {
+    storeNumber(value);
+    return true;
+  }
+
+  bool onUnsignedInteger(JsonUInt value) {
+    storeNumber(value);
+    return true;
+  }
+
+  bool onFloat(JsonFloat value) {
+    storeNumber(value);
+    return true;
+  }
+
+  bool onBoolean(bool value) {
+    beforeValue();
+    for (size_t i = 0; i < N; i++) {
+      if (isLeafOfValue(i) && fields_[i].kind == JsonFieldKind::Bool)
+        store(i, value);
+    }
+    return true;
+  }
+
+  bool onNull() {
+    beforeValue();
+    return true;
+  }
+
+ private:
+  struct Level {
+    Mask mask;  // fields whose path goes through this container
+    bool isArray;
+    size_t index;  // of the next element, for arrays
+  };
+
+  static const uint16_t notAnIndex = 0xFFFF;
+
+  struct Segment {
+    uint8_t start;   // offset in the path
+    uint8_t length;  // up to the next dot
+    uint16_t index;  // the segment as an array index, or notAnIndex
+  };
+
+  struct Path {
+    Segment segments[maxDepth];
+    uint8_t depth;  // number of segments, maxDepth + 1 if too deep to match
+  };
+
+  // Paths are up to 255 characters, and indexes up to 65534
+  static void splitPath(const char* path, Path& result) {
+    result.depth = 0;
+    size_t start = 0;
+    for (size_t i = 0;; i++) {
+      ARDUINOJSON_ASSERT(i <= 255);
+      if (path[i] != '.' && path[i] != 0)
+        continue;
+      if (result.depth == maxDepth) {
+        result.depth++;
+        return;
+      }
+      Segment& segment = result.segments[result.depth++];
+      segment.start = uint8_t(start);
+      segment.length = uint8_t(i - start);
+      segment.index = parseIndex(path + start, i - start);
+      if (path[i] == 0)
+        return;
+      start = i + 1;
+    }
+  }
+
+  static uint16_t parseIndex(const char* s, size_t n) {
+    if (n == 0)
+      return notAnIndex;
+    size_t index = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (s[i] < '0' || s[i] > '9')
+        return notAnIndex;
+      index = index * 10 + size_t(s[i] - '0');
+      if (index >= notAnIndex)
+        return notAnIndex;
+    }
+    return uint16_t(index);
+  }
+
+  // Array elements are matched by index, just before their value
+  void beforeValue() {
+    if (skippedLevels_ || depth_ == 0)
+      return;
+    Level& level = levels_[depth_ - 1];
+    if (!level.isArray)
+      return;
+    Mask mask = 0;
+    for (size_t i = 0; i < N; i++) {
+      if ((level.mask >> i) & 1) {
+        uint16_t index = paths_[i].segments[depth_ - 1].index;
+        if (index != notAnIndex && index == level.index)
+          mask |= Mask(1) << i;
+      }
+    }
+    level.index++;
+    valueMask_ = mask;
+  }
+
+  bool isLeafOfValue(size_t i) {
+    return !skippedLevels_ && ((valueMask_ >> i) & 1) &&
+           paths_[i].depth == depth_;
+  }
+
+  void enter(bool isArray) {
+    beforeValue();
+    Mask mask = 0;
+    if (!skippedLevels_ && depth_ < maxDepth) {
+      for (size_t i = 0; i < N; i++) {
+        if (((valueMask_ >> i) & 1) && paths_[i].depth > depth_)
+          mask |= Mask(1) << i;
+      }
+    }
+    if (mask) {
+      levels_[depth_++] = {mask, isArray, 0};
+    } else {
+      skippedLevels_++;
+    }
+    valueMask_ = 0;
+  }
+
+  void leave() {
+    if (skippedLevels_)
+      skippedLevels_--;
+    else
+      depth_--;
+  }
+
+  template <typename T>
+  void storeNumber(T value) {
+    beforeValue();
+    for (size_t i = 0; i < N; i++) {
+      if (!isLeafOfValue(i))
+        continue;
+      switch (fields_[i].kind) {
+        case JsonFieldKind::Bool:
+          store(i, value != 0);
+          break;
+        case JsonFieldKind::Int8:
+          store(i, convertNumber<int8_t>(value));
+          break;
+        case JsonFieldKind::UInt8:
+          store(i, convertNumber<uint8_t>(value));
+          break;
+        case JsonFieldKind::Int16:
+          store(i, convertNumber<int16_t>(value));
+          break;
+        case JsonFieldKind::UInt16:
+          store(i, convertNumber<uint16_t>(value));
+          break;
+        case JsonFieldKind::Int32:
+          store(i, convertNumber<int32_t>(value));
+          break;
+        case JsonFieldKind::UInt32:
+          store(i, convertNumber<uint32_t>(value));
+          break;
+        case JsonFieldKind::Int64:
+          store(i, convertNumber<int64_t>(value));
+          break;
+        case JsonFieldKind::UInt64:
+          store(i, convertNumber<uint64_t>(value));
+          break;
+        case JsonFieldKind::Float:
+          store(i, convertNumber<float>(value));
+          break;
+        case JsonFieldKind::Double:
+          store(i, convertNumber<double>(value));
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  template <typename T>
+  void store(size_t i, T value) {
+    ARDUINOJSON_ASSERT(fields_[i].size == sizeof(T));
+    memcpy(target_ + fields_[i].offset, &value, sizeof(T));
+  }
+
+  char* target_;
+  const JsonField<TStruct>* fields_;
+  Path paths_[N];
+  Level levels_[maxDepth];
+  uint8_t depth_ = 0;
+  uint8_t skippedLevels_ = 0;  // nested containers that no field goes through
+  Mask valueMask_;             // fields matched by the last key or index
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+// Declares a JsonField for a member of a struct:
+// const JsonField<Weather> fields[] = {
+//   ARDUINOJSON_FIELD(Weather, temp, "main.temp"),
+//   ARDUINOJSON_FIELD(Weather, description, "weather.0.description"),
+// };
+#define ARDUINOJSON_FIELD(STRUCT, MEMBER, PATH)                          \
+  ArduinoJson::detail::makeJsonField(PATH, offsetof(STRUCT, MEMBER), \
+                                     &STRUCT::MEMBER)
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Parses a JSON input and stores the values of the fields straight into the
+// struct, without building a document.
+// Members that the input doesn't mention keep their value, and so do the
+// members whose value has the wrong type. Unlike deserializeJson(), a key
+// that appears twice stores both values in turn.
+template <typename TStruct, size_t N, typename TInput>
+inline DeserializationError deserializeJsonFields(
+    TStruct& dst, TInput&& input, const JsonField<TStruct> (&fields)[N],
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  using namespace detail;
+  JsonFieldBinder<TStruct, N> binder(dst, fields);
+  return deserializeJsonEvents(binder, detail::forward<TInput>(input),
+                               nestingLimit);
+}
+
+// Parses a JSON input of a given size and stores the values of the fields
+// straight into the struct.
+template <typename TStruct, size_t N, typename TChar, typename Size,
+          detail::enable_if_t<detail::is_integral<Size>::value, int> = 0>
+inline DeserializationError deserializeJsonFields(
+    TStruct& dst, TChar* input, Size inputSize,
+    const JsonField<TStruct> (&fields)[N],
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  using namespace detail;
+  JsonFieldBinder<TStruct, N> binder(dst, fields);
+  return deserializeJsonEvents(binder, input, inputSize, nestingLimit);
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
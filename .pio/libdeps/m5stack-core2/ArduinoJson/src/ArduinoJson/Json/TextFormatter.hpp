@@ -15,6 +15,10 @@
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 #include <ArduinoJson/Serialization/CountingDecorator.hpp>
 
+#if ARDUINOJSON_ENABLE_SHORTEST_FLOAT
+#  include <ArduinoJson/Numbers/FloatDigits.hpp>
+#endif
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 template <typename TWriter>
@@ -66,41 +70,18 @@ class TextFormatter {
 
   template <typename T>
   void writeFloat(T value) {
-    writeFloat(JsonFloat(value), sizeof(T) >= 8 ? 9 : 6);
-  }
-
-  void writeFloat(JsonFloat value, int8_t decimalPlaces) {
-    if (isnan(value))
-      return writeRaw(ARDUINOJSON_ENABLE_NAN ? "NaN" : "null");
-
-#if ARDUINOJSON_ENABLE_INFINITY
-    if (value < 0.0) {
-      writeRaw('-');
-      value = -value;
-    }
-
-    if (isinf(value))
-      return writeRaw("Infinity");
+    if (writeSignOrSpecialFloat(value))
+      return;
+#if ARDUINOJSON_ENABLE_SHORTEST_FLOAT
+    writeShortestFloat(value);
 #else
-    if (isinf(value))
-      return writeRaw("null");
-
-    if (value < 0.0) {
-      writeRaw('-');
-      value = -value;
-    }
+    writeDecimalFloat(JsonFloat(value), sizeof(T) >= 8 ? 9 : 6);
 #endif
+  }
 
-    auto parts = decomposeFloat(value, decimalPlaces);
-
-    writeInteger(parts.integral);
-    if (parts.decimalPlaces)
-      writeDecimals(parts.decimal, parts.decimalPlaces);
-
-    if (parts.exponent) {
-      writeRaw('e');
-      writeInteger(parts.exponent);
-    }
+  void writeFloat(JsonFloat value, int8_t decimalPlaces) {
+    if (!writeSignOrSpecialFloat(value))
+      writeDecimalFloat(value, decimalPlaces);
   }
 
   template <typename T>
@@ -170,6 +151,89 @@ class TextFormatter {
     writer_.write(static_cast<uint8_t>(c));
   }
 
+ private:
+  // Writes NaN and infinities, or the sign of a finite value.
+  // Returns true if nothing else must be written.
+  template <typename T>
+  bool writeSignOrSpecialFloat(T& value) {
+    if (isnan(value)) {
+      writeRaw(ARDUINOJSON_ENABLE_NAN ? "NaN" : "null");
+      return true;
+    }
+
+#if ARDUINOJSON_ENABLE_INFINITY
+    if (value < 0) {
+      writeRaw('-');
+      value = -value;
+    }
+
+    if (isinf(value)) {
+      writeRaw("Infinity");
+      return true;
+    }
+#else
+    if (isinf(value)) {
+      writeRaw("null");
+      return true;
+    }
+
+    if (value < 0) {
+      writeRaw('-');
+      value = -value;
+    }
+#endif
+    return false;
+  }
+
+  void writeDecimalFloat(JsonFloat value, int8_t decimalPlaces) {
+    auto parts = decomposeFloat(value, decimalPlaces);
+
+    writeInteger(parts.integral);
+    if (parts.decimalPlaces)
+      writeDecimals(parts.decimal, parts.decimalPlaces);
+
+    if (parts.exponent) {
+      writeRaw('e');
+      writeInteger(parts.exponent);
+    }
+  }
+
+#if ARDUINOJSON_ENABLE_SHORTEST_FLOAT
+  template <typename T>
+  void writeShortestFloat(T value) {
+    if (value == 0)
+      return writeRaw('0');
+
+    auto parts = shortestFloatDigits(value);
+    int length = parts.length;
+    int point = length + parts.exponent;  // position of the decimal point
+
+    if (value >= ARDUINOJSON_POSITIVE_EXPONENTIATION_THRESHOLD ||
+        value <= ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD) {
+      writeRaw(parts.digits[0]);
+      if (length > 1) {
+        writeRaw('.');
+        writeRaw(parts.digits + 1, size_t(length - 1));
+      }
+      writeRaw('e');
+      writeInteger(point - 1);
+    } else if (point >= length) {  // 1200
+      writeRaw(parts.digits, size_t(length));
+      for (int i = length; i < point; i++)
+        writeRaw('0');
+    } else if (point > 0) {  // 12.5
+      writeRaw(parts.digits, size_t(point));
+      writeRaw('.');
+      writeRaw(parts.digits + point, size_t(length - point));
+    } else {  // 0.0125
+      writeRaw("0.");
+      for (int i = point; i < 0; i++)
+        writeRaw('0');
+      writeRaw(parts.digits, size_t(length));
+    }
+  }
+#endif
+
  protected:
   CountingDecorator<TWriter> writer_;
 };
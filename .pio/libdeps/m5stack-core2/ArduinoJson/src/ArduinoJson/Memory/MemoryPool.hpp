@@ -93,6 +93,10 @@ class MemoryPool {
     return usage_;
   }
 
+  SlotCount capacity() const {
+    return capacity_;
+  }
+
   static SlotCount bytesToSlots(size_t n) {
     return static_cast<SlotCount>(n / sizeof(T));
   }
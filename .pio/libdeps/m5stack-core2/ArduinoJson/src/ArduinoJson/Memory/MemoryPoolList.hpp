@@ -137,6 +137,16 @@ class MemoryPoolList {
     return Pool::slotsToBytes(usage());
   }
 
+  // Bytes taken from the allocator, including the slots not used yet
+  size_t allocatedSize() const {
+    size_t total = 0;
+    if (pools_ != preallocatedPools_)
+      total += capacity_ * sizeof(Pool);
+    for (PoolCount i = 0; i < count_; i++)
+      total += Pool::slotsToBytes(pools_[i].capacity());
+    return total;
+  }
+
   void shrinkToFit(Allocator* allocator) {
     if (count_ > 0)
       pools_[count_ - 1].shrinkToFit(allocator);
@@ -20,10 +20,19 @@ class StringPool {
 
   ~StringPool() {
     ARDUINOJSON_ASSERT(strings_ == nullptr);
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    ARDUINOJSON_ASSERT(index_ == nullptr);
+#endif
   }
 
   friend void swap(StringPool& a, StringPool& b) {
     swap_(a.strings_, b.strings_);
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    swap_(a.index_, b.index_);
+    swap_(a.indexCapacity_, b.indexCapacity_);
+    swap_(a.indexUsed_, b.indexUsed_);
+    swap_(a.count_, b.count_);
+#endif
   }
 
   void clear(Allocator* allocator) {
@@ -32,12 +41,19 @@ class StringPool {
       strings_ = node->next;
       StringNode::destroy(node, allocator);
     }
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    dropIndex(allocator);
+    count_ = 0;
+#endif
   }
 
   size_t size() const {
     size_t total = 0;
     for (auto node = strings_; node; node = node->next)
       total += sizeofString(node->length);
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    total += indexCapacity_ * sizeof(StringNode*);
+#endif
     return total;
   }
 
@@ -45,7 +61,12 @@ class StringPool {
   StringNode* add(TAdaptedString str, Allocator* allocator) {
     ARDUINOJSON_ASSERT(str.isNull() == false);
 
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    uint32_t hash = stringHash(str);
+    auto node = find(str, hash);
+#else
     auto node = get(str);
+#endif
     if (node) {
       node->references++;
       return node;
@@ -59,26 +80,57 @@ class StringPool {
 
     stringGetChars(str, node->data, n);
     node->data[n] = 0;  // force NUL terminator
-    add(node);
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    node->hash = hash;
+    insert(node, allocator);
+#else
+    add(node, allocator);
+#endif
     return node;
   }
 
-  void add(StringNode* node) {
+  void add(StringNode* node, Allocator* allocator) {
     ARDUINOJSON_ASSERT(node != nullptr);
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    node->hash = stringHash(adaptString(node->data, node->length));
+    insert(node, allocator);
+#else
+    (void)allocator;
     node->next = strings_;
     strings_ = node;
+#endif
   }
 
   template <typename TAdaptedString>
   StringNode* get(const TAdaptedString& str) const {
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    return find(str, stringHash(str));
+#else
     for (auto node = strings_; node; node = node->next) {
       if (stringEquals(str, adaptString(node->data, node->length)))
         return node;
     }
     return nullptr;
+#endif
   }
 
   void dereference(const char* s, Allocator* allocator) {
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+    // s always comes from a node of this pool
+    auto node = reinterpret_cast<StringNode*>(const_cast<char*>(s) -
+                                              offsetof(StringNode, data));
+    if (--node->references == 0) {
+      if (node->prev)
+        node->prev->next = node->next;
+      else
+        strings_ = node->next;
+      if (node->next)
+        node->next->prev = node->prev;
+      unindex(node);
+      count_--;
+      StringNode::destroy(node, allocator);
+    }
+#else
     StringNode* prev = nullptr;
     for (auto node = strings_; node; node = node->next) {
       if (node->data == s) {
@@ -93,9 +145,117 @@ class StringPool {
       }
       prev = node;
     }
+#endif
   }
 
  private:
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+  // The index is an open-addressing table of nodes with linear probing.
+  // The list still owns the nodes: if the table can't grow, the pool drops
+  // it and falls back to walking the list until the next rebuild succeeds.
+  static const size_t minIndexCapacity = 16;  // must be a power of two
+
+  // Marks a removed node, so probing continues past it
+  static StringNode* tombstone() {
+    static StringNode node;
+    return &node;
+  }
+
+  template <typename TAdaptedString>
+  static bool matches(const StringNode* node, const TAdaptedString& str,
+                      uint32_t hash) {
+    return node->hash == hash && node->length == str.size() &&
+           stringEquals(str, adaptString(node->data, node->length));
+  }
+
+  template <typename TAdaptedString>
+  StringNode* find(const TAdaptedString& str, uint32_t hash) const {
+    if (index_) {
+      size_t mask = indexCapacity_ - 1;
+      for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        auto node = index_[i];
+        if (!node)
+          return nullptr;
+        if (node != tombstone() && matches(node, str, hash))
+          return node;
+      }
+    }
+    for (auto node = strings_; node; node = node->next) {
+      if (matches(node, str, hash))
+        return node;
+    }
+    return nullptr;
+  }
+
+  void insert(StringNode* node, Allocator* allocator) {
+    node->prev = nullptr;
+    node->next = strings_;
+    if (strings_)
+      strings_->prev = node;
+    strings_ = node;
+    count_++;
+
+    // Keep the load factor, tombstones included, under 3/4
+    if ((indexUsed_ + 1) * 4 > indexCapacity_ * 3)
+      rebuildIndex(allocator);  // indexes the new node too
+    else
+      indexNode(node);
+  }
+
+  void indexNode(StringNode* node) {
+    size_t mask = indexCapacity_ - 1;
+    size_t i = node->hash & mask;
+    while (index_[i] && index_[i] != tombstone())
+      i = (i + 1) & mask;
+    if (!index_[i])
+      indexUsed_++;
+    index_[i] = node;
+  }
+
+  void unindex(StringNode* node) {
+    if (!index_)
+      return;
+    size_t mask = indexCapacity_ - 1;
+    size_t i = node->hash & mask;
+    while (index_[i] != node) {
+      ARDUINOJSON_ASSERT(index_[i] != nullptr);
+      i = (i + 1) & mask;
+    }
+    index_[i] = tombstone();
+  }
+
+  void rebuildIndex(Allocator* allocator) {
+    dropIndex(allocator);
+
+    size_t capacity = minIndexCapacity;
+    while (capacity < count_ * 2)
+      capacity *= 2;
+
+    index_ = reinterpret_cast<StringNode**>(
+        allocator->allocate(capacity * sizeof(StringNode*)));
+    if (!index_)
+      return;
+    indexCapacity_ = capacity;
+    for (size_t i = 0; i < capacity; i++)
+      index_[i] = nullptr;
+    for (auto node = strings_; node; node = node->next)
+      indexNode(node);
+  }
+
+  void dropIndex(Allocator* allocator) {
+    if (index_)
+      allocator->deallocate(index_);
+    index_ = nullptr;
+    indexCapacity_ = 0;
+    indexUsed_ = 0;
+  }
+
+  StringNode** index_ = nullptr;
+  size_t indexCapacity_ = 0;
+  size_t indexUsed_ = 0;  // nodes and tombstones
+  size_t count_ = 0;
+#endif
+
   StringNode* strings_ = nullptr;
 };
 
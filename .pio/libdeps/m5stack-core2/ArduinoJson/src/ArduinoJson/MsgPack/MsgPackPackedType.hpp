@@ -0,0 +1,60 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// The extension type of an array packed by serializeMsgPackArray().
+// The payload is the big-endian values, one after the other:
+//   0x10 int8    0x11 uint8    0x12 int16   0x13 uint16
+//   0x14 int32   0x15 uint32   0x16 int64   0x17 uint64
+//   0x18 float32 0x19 float64
+template <typename T, typename Enable = void>
+struct MsgPackPackedType {
+  static_assert(sizeof(T) == 0, "only numbers can be packed");
+};
+
+template <typename T>
+struct MsgPackPackedType<
+    T, enable_if_t<is_integral<T>::value && !is_same<T, bool>::value>> {
+  static const int8_t value =
+      int8_t((sizeof(T) == 1   ? 0x10
+              : sizeof(T) == 2 ? 0x12
+              : sizeof(T) == 4 ? 0x14
+                               : 0x16) +
+             (is_signed<T>::value ? 0 : 1));
+};
+
+template <typename T>
+struct MsgPackPackedType<T, enable_if_t<is_floating_point<T>::value>> {
+  static const int8_t value = sizeof(T) == 4 ? 0x18 : 0x19;
+};
+
+// Returns the size of an element of a packed array, or 0 if the extension
+// type isn't one of the above
+inline uint8_t msgPackPackedElementSize(int8_t type) {
+  switch (type) {
+    case 0x10:
+    case 0x11:
+      return 1;
+    case 0x12:
+    case 0x13:
+      return 2;
+    case 0x14:
+    case 0x15:
+    case 0x18:
+      return 4;
+    case 0x16:
+    case 0x17:
+    case 0x19:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
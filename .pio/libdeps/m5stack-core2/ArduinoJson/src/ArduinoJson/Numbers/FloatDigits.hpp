@@ -0,0 +1,282 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Polyfills/alias_cast.hpp>
+#include <ArduinoJson/Polyfills/integer.hpp>
+#include <ArduinoJson/Polyfills/pgmspace_generic.hpp>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// The shortest digits that read back as the same float, computed with Grisu2
+// (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+// Integers", 2010). The result always round-trips; in rare cases, it has one
+// more digit than strictly needed.
+struct FloatDigits {
+  char digits[24];  // not null-terminated
+  int8_t length;
+  int16_t exponent;  // the value is digits * 10^exponent
+};
+
+// f * 2^e, with a 64-bit significand
+struct DiyFp {
+  uint64_t f;
+  int e;
+
+  DiyFp normalize() const {
+    int shift = countLeadingZeros(f);
+    return {f << shift, e - shift};
+  }
+
+  DiyFp operator-(const DiyFp& other) const {
+    return {f - other.f, e};
+  }
+
+  DiyFp operator*(const DiyFp& other) const {
+    Uint128 product = multiply64(f, other.f);
+    return {product.high + (product.low >> 63), e + other.e + 64};  // rounded
+  }
+};
+
+inline pgm_ptr<uint64_t> powersOfTenUint64() {
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(  //
+      uint64_t, factors,
+      {
+          1,
+          10,
+          100,
+          1000,
+          10000,
+          100000,
+          1000000,
+          10000000,
+          100000000,
+          1000000000,
+          10000000000,
+          100000000000,
+          1000000000000,
+          10000000000000,
+          100000000000000,
+          1000000000000000,
+          10000000000000000,
+          100000000000000000,
+          1000000000000000000,
+          10000000000000000000u,
+      });
+  return pgm_ptr<uint64_t>(factors);
+}
+
+// Returns the normalized 10^-k that brings a number with the binary exponent
+// e in Grisu's target range
+inline DiyFp cachedPowerOfTen(int e, int& k) {
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(  //
+      uint64_t, significands,
+      {
+          0xfa8fd5a0081c0288,  // 10^-348
+          0xbaaee17fa23ebf76,  // 10^-340
+          0x8b16fb203055ac76,  // 10^-332
+          0xcf42894a5dce35ea,  // 10^-324
+          0x9a6bb0aa55653b2d,  // 10^-316
+          0xe61acf033d1a45df,  // 10^-308
+          0xab70fe17c79ac6ca,  // 10^-300
+          0xff77b1fcbebcdc4f,  // 10^-292
+          0xbe5691ef416bd60c,  // 10^-284
+          0x8dd01fad907ffc3c,  // 10^-276
+          0xd3515c2831559a83,  // 10^-268
+          0x9d71ac8fada6c9b5,  // 10^-260
+          0xea9c227723ee8bcb,  // 10^-252
+          0xaecc49914078536d,  // 10^-244
+          0x823c12795db6ce57,  // 10^-236
+          0xc21094364dfb5637,  // 10^-228
+          0x9096ea6f3848984f,  // 10^-220
+          0xd77485cb25823ac7,  // 10^-212
+          0xa086cfcd97bf97f4,  // 10^-204
+          0xef340a98172aace5,  // 10^-196
+          0xb23867fb2a35b28e,  // 10^-188
+          0x84c8d4dfd2c63f3b,  // 10^-180
+          0xc5dd44271ad3cdba,  // 10^-172
+          0x936b9fcebb25c996,  // 10^-164
+          0xdbac6c247d62a584,  // 10^-156
+          0xa3ab66580d5fdaf6,  // 10^-148
+          0xf3e2f893dec3f126,  // 10^-140
+          0xb5b5ada8aaff80b8,  // 10^-132
+          0x87625f056c7c4a8b,  // 10^-124
+          0xc9bcff6034c13053,  // 10^-116
+          0x964e858c91ba2655,  // 10^-108
+          0xdff9772470297ebd,  // 10^-100
+          0xa6dfbd9fb8e5b88f,  // 10^-92
+          0xf8a95fcf88747d94,  // 10^-84
+          0xb94470938fa89bcf,  // 10^-76
+          0x8a08f0f8bf0f156b,  // 10^-68
+          0xcdb02555653131b6,  // 10^-60
+          0x993fe2c6d07b7fac,  // 10^-52
+          0xe45c10c42a2b3b06,  // 10^-44
+          0xaa242499697392d3,  // 10^-36
+          0xfd87b5f28300ca0e,  // 10^-28
+          0xbce5086492111aeb,  // 10^-20
+          0x8cbccc096f5088cc,  // 10^-12
+          0xd1b71758e219652c,  // 10^-4
+          0x9c40000000000000,  // 10^4
+          0xe8d4a51000000000,  // 10^12
+          0xad78ebc5ac620000,  // 10^20
+          0x813f3978f8940984,  // 10^28
+          0xc097ce7bc90715b3,  // 10^36
+          0x8f7e32ce7bea5c70,  // 10^44
+          0xd5d238a4abe98068,  // 10^52
+          0x9f4f2726179a2245,  // 10^60
+          0xed63a231d4c4fb27,  // 10^68
+          0xb0de65388cc8ada8,  // 10^76
+          0x83c7088e1aab65db,  // 10^84
+          0xc45d1df942711d9a,  // 10^92
+          0x924d692ca61be758,  // 10^100
+          0xda01ee641a708dea,  // 10^108
+          0xa26da3999aef774a,  // 10^116
+          0xf209787bb47d6b85,  // 10^124
+          0xb454e4a179dd1877,  // 10^132
+          0x865b86925b9bc5c2,  // 10^140
+          0xc83553c5c8965d3d,  // 10^148
+          0x952ab45cfa97a0b3,  // 10^156
+          0xde469fbd99a05fe3,  // 10^164
+          0xa59bc234db398c25,  // 10^172
+          0xf6c69a72a3989f5c,  // 10^180
+          0xb7dcbf5354e9bece,  // 10^188
+          0x88fcf317f22241e2,  // 10^196
+          0xcc20ce9bd35c78a5,  // 10^204
+          0x98165af37b2153df,  // 10^212
+          0xe2a0b5dc971f303a,  // 10^220
+          0xa8d9d1535ce3b396,  // 10^228
+          0xfb9b7cd9a4a7443c,  // 10^236
+          0xbb764c4ca7a44410,  // 10^244
+          0x8bab8eefb6409c1a,  // 10^252
+          0xd01fef10a657842c,  // 10^260
+          0x9b10a4e5e9913129,  // 10^268
+          0xe7109bfba19c0c9d,  // 10^276
+          0xac2820d9623bf429,  // 10^284
+          0x80444b5e7aa7cf85,  // 10^292
+          0xbf21e44003acdd2d,  // 10^300
+          0x8e679c2f5e44ff8f,  // 10^308
+          0xd433179d9c8cb841,  // 10^316
+          0x9e19db92b4e31ba9,  // 10^324
+          0xeb96bf6ebadf77d9,  // 10^332
+          0xaf87023b9bf0ee6b,  // 10^340
+      });
+
+  // ceil((-61 - e) * log10(2)), in fixed point
+  int x = -61 - e;
+  int ceiling = x == 0 ? 0 : ((x * 78913) >> 18) + 1;
+  int index = ((ceiling + 347) >> 3) + 1;
+  int decimalExponent = -348 + 8 * index;  // one power every eight
+  k = -decimalExponent;
+  // floor(decimalExponent * log2(10)) - 63, in fixed point
+  return {pgm_ptr<uint64_t>(significands)[index],
+          ((decimalExponent * 1741647) >> 19) - 63};
+}
+
+inline int countDecimalDigits(uint32_t n) {
+  int count = 1;
+  while (count < 10 && n >= uint32_t(powersOfTenUint64()[count]))
+    count++;
+  return count;
+}
+
+// Moves the last digit closer to w, while staying in the interval
+inline void grisuRound(FloatDigits& out, uint64_t delta, uint64_t rest,
+                       uint64_t tenKappa, uint64_t distance) {
+  while (rest < distance && delta - rest >= tenKappa &&
+         (rest + tenKappa < distance ||
+          distance - rest > rest + tenKappa - distance)) {
+    out.digits[out.length - 1]--;
+    rest += tenKappa;
+  }
+}
+
+// Generates the digits of mp, until they are within delta of it
+inline void generateDigits(DiyFp w, DiyFp mp, uint64_t delta,
+                           FloatDigits& out, int& k) {
+  auto powersOfTen = powersOfTenUint64();
+  const DiyFp one = {uint64_t(1) << -mp.e, mp.e};
+  const uint64_t distance = (mp - w).f;
+  uint32_t p1 = uint32_t(mp.f >> -one.e);  // integral part
+  uint64_t p2 = mp.f & (one.f - 1);        // fractional part
+  int kappa = countDecimalDigits(p1);
+  out.length = 0;
+
+  while (kappa > 0) {
+    uint32_t divisor = uint32_t(powersOfTen[kappa - 1]);
+    uint32_t digit = p1 / divisor;
+    p1 %= divisor;
+    if (digit || out.length)
+      out.digits[out.length++] = char('0' + digit);
+    kappa--;
+    uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      k += kappa;
+      grisuRound(out, delta, rest, powersOfTen[kappa] << -one.e, distance);
+      return;
+    }
+  }
+
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    char digit = char(p2 >> -one.e);
+    if (digit || out.length)
+      out.digits[out.length++] = char('0' + digit);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      k += kappa;
+      int index = -kappa;
+      grisuRound(out, delta, p2, one.f,
+                 distance * (index < 20 ? powersOfTen[index] : 0));
+      return;
+    }
+  }
+}
+
+// Returns the digits of a positive finite float
+template <typename T>
+inline FloatDigits shortestFloatDigits(T value) {
+  const int mantissa_bits = FloatTraits<T>::mantissa_bits;
+  const int exponent_bits = int(sizeof(T) * 8) - 1 - mantissa_bits;
+  const int bias = (1 << (exponent_bits - 1)) - 1 + mantissa_bits;
+  const uint64_t hiddenBit = uint64_t(1) << mantissa_bits;
+
+  uint64_t bits = alias_cast<uint_t<sizeof(T) * 8>>(value);
+  int biasedExponent = int(bits >> mantissa_bits) & ((1 << exponent_bits) - 1);
+  DiyFp v;
+  if (biasedExponent) {
+    v.f = (bits & (hiddenBit - 1)) | hiddenBit;
+    v.e = biasedExponent - bias;
+  } else {  // subnormal
+    v.f = bits & (hiddenBit - 1);
+    v.e = 1 - bias;
+  }
+
+  // Halfway to the neighbors; the lower one is closer for powers of two
+  DiyFp plus = DiyFp{(v.f << 1) + 1, v.e - 1}.normalize();
+  DiyFp minus = v.f == hiddenBit && biasedExponent > 1
+                    ? DiyFp{(v.f << 2) - 1, v.e - 2}
+                    : DiyFp{(v.f << 1) - 1, v.e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+
+  int k;
+  DiyFp c = cachedPowerOfTen(plus.e, k);
+  DiyFp w = v.normalize() * c;
+  DiyFp wPlus = plus * c;
+  DiyFp wMinus = minus * c;
+  // the products are off by up to one unit, stay on the safe side
+  wMinus.f++;
+  wPlus.f--;
+
+  FloatDigits result;
+  generateDigits(w, wPlus, wPlus.f - wMinus.f, result, k);
+  result.exponent = int16_t(k);
+  return result;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,407 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Numbers/powersOfFive.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/ctype.hpp>
+#include <ArduinoJson/Polyfills/integer.hpp>
+
+#include <string.h>  // memmove
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Correctly rounded conversion of decimal numbers to binary floats.
+// The fast path is the Eisel-Lemire algorithm, as described in Lemire,
+// "Number Parsing at a Gigabyte per Second" (2021). It only fails when the
+// input has too many digits to fit in 64 bits; these numbers go through a
+// slower arbitrary-precision decimal, like Go's strconv does.
+
+template <typename T, size_t = sizeof(T)>
+struct BinaryFormat {};
+
+template <typename T>
+struct BinaryFormat<T, 8 /*64bits*/> {
+  using bits_type = uint64_t;
+  static const int exponent_bits = 11;
+  static const int minimum_exponent = -1023;
+  static const int smallest_power_of_ten = -342;  // below rounds to zero
+  static const int largest_power_of_ten = 308;    // above is infinite
+  static const int min_exponent_round_to_even = -4;
+  static const int max_exponent_round_to_even = 23;
+  static const int max_exact_power_of_ten = 22;
+};
+
+template <typename T>
+struct BinaryFormat<T, 4 /*32bits*/> {
+  using bits_type = uint32_t;
+  static const int exponent_bits = 8;
+  static const int minimum_exponent = -127;
+  static const int smallest_power_of_ten = -64;
+  static const int largest_power_of_ten = 38;
+  static const int min_exponent_round_to_even = -17;
+  static const int max_exponent_round_to_even = 10;
+  static const int max_exact_power_of_ten = 10;
+};
+
+// A float as its biased exponent and its mantissa without the implicit bit
+struct BinaryFloat {
+  uint64_t mantissa;
+  int32_t exponent;
+
+  bool operator==(const BinaryFloat& other) const {
+    return mantissa == other.mantissa && exponent == other.exponent;
+  }
+
+  bool operator!=(const BinaryFloat& other) const {
+    return !(*this == other);
+  }
+};
+
+// Rounds w * 10^q to the nearest float, ties to even.
+// Exact for any w; if w holds the truncated digits of a longer number, the
+// caller must check that w + 1 gives the same result.
+template <typename T>
+inline BinaryFloat eiselLemire(uint64_t w, int q) {
+  using format = BinaryFormat<T>;
+  const int mantissa_bits = FloatTraits<T>::mantissa_bits;
+  const int32_t infinite_exponent = (1 << format::exponent_bits) - 1;
+
+  BinaryFloat result = {0, 0};
+  if (w == 0 || q < format::smallest_power_of_ten)
+    return result;
+  if (q > format::largest_power_of_ten) {
+    result.exponent = infinite_exponent;
+    return result;
+  }
+
+  int lz = countLeadingZeros(w);
+  w <<= lz;
+
+  // The high half of 5^q is enough, unless the bits below the precision we
+  // need are all ones: then the low half may carry into them
+  auto powers = powersOfFive();
+  int index = 2 * (q - smallestPowerOfFive);
+  Uint128 product = multiply64(w, powers[index]);
+  const uint64_t precisionMask = uint64_t(-1) >> (mantissa_bits + 3);
+  if ((product.high & precisionMask) == precisionMask) {
+    Uint128 second = multiply64(w, powers[index + 1]);
+    product.low += second.high;
+    if (second.high > product.low)
+      product.high++;
+  }
+
+  int upperBit = int(product.high >> 63);
+  int shift = upperBit + 64 - mantissa_bits - 3;
+  result.mantissa = product.high >> shift;
+  // floor(log2(10^q)) + 63, as ((152170 + 65536) * q) >> 16
+  int32_t power = (int32_t(217706) * q >> 16) + 63;
+  result.exponent = power + upperBit - lz - format::minimum_exponent;
+
+  if (result.exponent <= 0) {  // subnormal
+    if (-result.exponent + 1 >= 64) {
+      result.mantissa = 0;
+      result.exponent = 0;
+      return result;
+    }
+    result.mantissa >>= -result.exponent + 1;
+    result.mantissa += result.mantissa & 1;  // round up
+    result.mantissa >>= 1;
+    // rounding may have made it a normal number
+    result.exponent =
+        result.mantissa < (uint64_t(1) << mantissa_bits) ? 0 : 1;
+    return result;
+  }
+
+  // Exactly halfway: round to even instead of up
+  if (product.low <= 1 && q >= format::min_exponent_round_to_even &&
+      q <= format::max_exponent_round_to_even &&
+      (result.mantissa & 3) == 1 &&
+      (result.mantissa << shift) == product.high)
+    result.mantissa &= ~uint64_t(1);
+
+  result.mantissa += result.mantissa & 1;  // round up
+  result.mantissa >>= 1;
+  if (result.mantissa >= (uint64_t(2) << mantissa_bits)) {
+    result.mantissa = uint64_t(1) << mantissa_bits;
+    result.exponent++;
+  }
+  result.mantissa &= ~(uint64_t(1) << mantissa_bits);
+
+  if (result.exponent >= infinite_exponent) {
+    result.mantissa = 0;
+    result.exponent = infinite_exponent;
+  }
+  return result;
+}
+
+// A decimal number with enough digits to round any float exactly.
+// The value is 0.d[0]d[1]...d[count-1] * 10^point
+class Decimal {
+ public:
+  // Reads the number in [s, end), which must be valid
+  Decimal(const char* s, const char* end)
+      : count_(0), point_(0), truncated_(false) {
+    bool sawDot = false;
+    if (s < end && issign(*s))
+      s++;
+    for (; s < end; s++) {
+      char c = *s;
+      if (c == '.') {
+        sawDot = true;
+        point_ = count_;
+        continue;
+      }
+      if (!isdigit(c))
+        break;
+      if (c == '0' && count_ == 0) {  // leading zero
+        point_--;
+        continue;
+      }
+      if (count_ < capacity)
+        digits_[count_++] = uint8_t(c - '0');
+      else if (c != '0')
+        truncated_ = true;
+    }
+    if (!sawDot)
+      point_ = count_;
+
+    if (s < end && (*s == 'e' || *s == 'E')) {
+      s++;
+      bool negative = s < end && *s == '-';
+      if (s < end && issign(*s))
+        s++;
+      int exponent = 0;
+      for (; s < end && isdigit(*s); s++) {
+        if (exponent < 10000)
+          exponent = exponent * 10 + (*s - '0');
+      }
+      point_ += negative ? -exponent : exponent;
+    }
+  }
+
+  template <typename T>
+  BinaryFloat toBinary() {
+    using format = BinaryFormat<T>;
+    const int mantissa_bits = FloatTraits<T>::mantissa_bits;
+    const int bias = format::minimum_exponent;
+    const int32_t infinite_exponent = (1 << format::exponent_bits) - 1;
+    const BinaryFloat zero = {0, 0};
+    const BinaryFloat infinity = {0, infinite_exponent};
+    // shift needed to move the point by i digits, for small i
+    static const uint8_t powers[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+
+    if (count_ == 0 || point_ < -330)
+      return zero;
+    if (point_ > 310)
+      return infinity;
+
+    // Scale by powers of two until in [0.5, 1)
+    int exponent = 0;
+    while (point_ > 0) {
+      int n = point_ < 9 ? powers[point_] : 27;
+      shift(-n);
+      exponent += n;
+    }
+    while (point_ < 0 || (point_ == 0 && digits_[0] < 5)) {
+      int n = -point_ < 9 ? powers[-point_] : 27;
+      shift(n);
+      exponent -= n;
+    }
+    exponent--;  // [1, 2)
+
+    // Below the smallest exponent, the number becomes subnormal
+    if (exponent < bias + 1) {
+      int n = bias + 1 - exponent;
+      shift(-n);
+      exponent += n;
+    }
+    if (exponent - bias >= infinite_exponent)
+      return infinity;
+
+    shift(1 + mantissa_bits);
+    uint64_t mantissa = roundedInteger();
+    if (mantissa == uint64_t(2) << mantissa_bits) {  // rounding carried
+      mantissa >>= 1;
+      exponent++;
+      if (exponent - bias >= infinite_exponent)
+        return infinity;
+    }
+    if (!(mantissa & (uint64_t(1) << mantissa_bits)))
+      exponent = bias;  // subnormal
+
+    BinaryFloat result;
+    result.mantissa = mantissa & ((uint64_t(1) << mantissa_bits) - 1);
+    result.exponent = exponent - bias;
+    return result;
+  }
+
+ private:
+  static const int capacity = 800;
+  static const int maxShift = 60;
+  static const int maxShiftDigits = 19;  // digits added by a left shift
+
+  void shift(int k) {
+    if (count_ == 0)
+      return;
+    for (; k > maxShift; k -= maxShift)
+      shiftLeft(maxShift);
+    for (; k < -maxShift; k += maxShift)
+      shiftRight(maxShift);
+    if (k > 0)
+      shiftLeft(k);
+    else if (k < 0)
+      shiftRight(-k);
+  }
+
+  // Multiplies by 2^k, writing the digits right-aligned in the spare room at
+  // the end of the buffer, then moving them to the front
+  void shiftLeft(int k) {
+    int write = count_ + maxShiftDigits;
+    uint64_t n = 0;
+    for (int read = count_ - 1; read >= 0; read--) {
+      n += uint64_t(digits_[read]) << k;
+      uint64_t quotient = n / 10;
+      digits_[--write] = uint8_t(n - 10 * quotient);
+      n = quotient;
+    }
+    while (n > 0) {
+      uint64_t quotient = n / 10;
+      digits_[--write] = uint8_t(n - 10 * quotient);
+      n = quotient;
+    }
+    int added = maxShiftDigits - write;
+    int count = count_ + added;
+    if (count > capacity) {
+      for (int i = capacity; i < count; i++) {
+        if (digits_[write + i])
+          truncated_ = true;
+      }
+      count = capacity;
+    }
+    memmove(digits_, digits_ + write, size_t(count));
+    count_ = count;
+    point_ += added;
+    trim();
+  }
+
+  // Divides by 2^k
+  void shiftRight(int k) {
+    int read = 0, write = 0;
+    uint64_t n = 0;
+    // pick up enough leading digits to cover the first shift
+    for (; n >> k == 0; read++) {
+      if (read >= count_) {
+        while (n >> k == 0) {
+          n *= 10;
+          read++;
+        }
+        break;
+      }
+      n = n * 10 + digits_[read];
+    }
+    point_ -= read - 1;
+
+    uint64_t mask = (uint64_t(1) << k) - 1;
+    for (; read < count_; read++) {
+      uint8_t digit = uint8_t(n >> k);
+      n &= mask;
+      digits_[write++] = digit;
+      n = n * 10 + digits_[read];
+    }
+    while (n > 0) {
+      uint8_t digit = uint8_t(n >> k);
+      n &= mask;
+      if (write < capacity)
+        digits_[write++] = digit;
+      else if (digit > 0)
+        truncated_ = true;
+      n *= 10;
+    }
+    count_ = write;
+    trim();
+  }
+
+  void trim() {
+    while (count_ > 0 && digits_[count_ - 1] == 0)
+      count_--;
+    if (count_ == 0)
+      point_ = 0;
+  }
+
+  bool shouldRoundUp(int i) const {
+    if (i < 0 || i >= count_)
+      return false;
+    if (digits_[i] == 5 && i + 1 == count_) {  // exactly halfway
+      if (truncated_)  // actually a little higher
+        return true;
+      return i > 0 && digits_[i - 1] % 2 != 0;  // round to even
+    }
+    return digits_[i] >= 5;
+  }
+
+  // Integer part, rounded
+  uint64_t roundedInteger() const {
+    if (point_ > 20)
+      return uint64_t(-1);
+    uint64_t n = 0;
+    int i = 0;
+    for (; i < point_ && i < count_; i++)
+      n = n * 10 + digits_[i];
+    for (; i < point_; i++)
+      n *= 10;
+    if (shouldRoundUp(point_))
+      n++;
+    return n;
+  }
+
+  uint8_t digits_[capacity + maxShiftDigits];
+  int count_;
+  int point_;
+  bool truncated_;  // nonzero digits were dropped
+};
+
+template <typename T>
+inline T makeFloat(BinaryFloat value, bool negative) {
+  using bits_type = typename BinaryFormat<T>::bits_type;
+  const int mantissa_bits = FloatTraits<T>::mantissa_bits;
+  const int sign_bit = mantissa_bits + BinaryFormat<T>::exponent_bits;
+  bits_type bits = bits_type(value.mantissa) |
+                   bits_type(value.exponent) << mantissa_bits |
+                   bits_type(negative) << sign_bit;
+  return FloatTraits<T>::forge(bits);
+}
+
+// Returns the float nearest to mantissa * 10^exponent.
+// If nonzero digits didn't fit in the mantissa (truncated), [s, end) must
+// contain the whole number, so it can be parsed again with full precision.
+template <typename T>
+inline T decimalToFloat(uint64_t mantissa, int exponent, bool truncated,
+                        bool negative, const char* s, const char* end) {
+  using format = BinaryFormat<T>;
+
+  // Clinger's fast path: the mantissa and the power of ten are exact, so a
+  // single multiplication or division rounds correctly
+  if (!truncated &&
+      mantissa <= uint64_t(2) << FloatTraits<T>::mantissa_bits &&
+      exponent >= -format::max_exact_power_of_ten &&
+      exponent <= format::max_exact_power_of_ten) {
+    T value = T(mantissa);
+    if (exponent < 0)
+      value = value / make_float(T(1), -exponent);
+    else
+      value = value * make_float(T(1), exponent);
+    return negative ? -value : value;
+  }
+
+  BinaryFloat result = eiselLemire<T>(mantissa, exponent);
+  if (truncated && (mantissa == uint64_t(-1) ||
+                    result != eiselLemire<T>(mantissa + 1, exponent)))
+    result = Decimal(s, end).toBinary<T>();
+  return makeFloat<T>(result, negative);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -12,6 +12,12 @@
 #include <ArduinoJson/Polyfills/math.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 
+#if ARDUINOJSON_ENABLE_FAST_FLOAT
+#  include <ArduinoJson/Numbers/decimalToFloat.hpp>
+#endif
+
+#include <string.h>  // memcpy, strlen
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 template <typename A, typename B>
@@ -102,120 +108,197 @@ class Number {
 #endif
 };
 
-inline Number parseNumber(const char* s) {
+#if ARDUINOJSON_ENABLE_FAST_FLOAT && ARDUINOJSON_LITTLE_ENDIAN
+// SWAR (SIMD within a register) parsing of eight digits, s[0] in the low byte
+
+inline uint64_t loadEightChars(const char* s) {
+  uint64_t chunk;
+  memcpy(&chunk, s, sizeof(chunk));
+  return chunk;
+}
+
+inline bool isEightDigits(uint64_t chunk) {
+  // a byte above '9' overflows into its high bit, one below '0' borrows
+  return (((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) &
+          0x8080808080808080) == 0;
+}
+
+inline uint32_t parseEightDigits(uint64_t chunk) {
+  const uint64_t mask = 0x000000FF000000FF;
+  const uint64_t mul1 = 0x000F424000000064;  // 100 + (1000000 << 32)
+  const uint64_t mul2 = 0x0000271000000001;  // 1 + (10000 << 32)
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);  // pairs of digits
+  chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+  return uint32_t(chunk);
+}
+#endif
+
+// Appends the digits at s to mantissa, until one doesn't fit
+template <typename T>
+inline const char* parseDigits(const char* s, const char* end, T& mantissa) {
+#if ARDUINOJSON_ENABLE_FAST_FLOAT && ARDUINOJSON_LITTLE_ENDIAN
+  // mantissa * 10^8 + 99999999 can't overflow
+  while (end - s >= 8 && mantissa < 100000000000) {
+    uint64_t chunk = loadEightChars(s);
+    if (!isEightDigits(chunk))
+      break;
+    mantissa = mantissa * 100000000 + parseEightDigits(chunk);
+    s += 8;
+  }
+#endif
+  const T maxMantissa = T(-1);
+  while (s < end && isdigit(*s)) {
+    uint8_t digit = uint8_t(*s - '0');
+    if (mantissa > maxMantissa / 10)
+      break;
+    T next = mantissa * 10;
+    if (next > maxMantissa - digit)
+      break;
+    mantissa = next + digit;
+    s++;
+  }
+  return s;
+}
+
+// Parses the number in [s, end)
+inline Number parseNumber(const char* s, const char* end) {
+#if ARDUINOJSON_ENABLE_FAST_FLOAT
+  using mantissa_t = uint64_t;
+#else
   using traits = FloatTraits<JsonFloat>;
   using mantissa_t = largest_type<traits::mantissa_type, JsonUInt>;
-  using exponent_t = traits::exponent_type;
+#endif
 
   ARDUINOJSON_ASSERT(s != 0);
 
   bool is_negative = false;
-  switch (*s) {
-    case '-':
-      is_negative = true;
-      s++;
-      break;
-    case '+':
-      s++;
-      break;
+  if (s < end) {
+    switch (*s) {
+      case '-':
+        is_negative = true;
+        s++;
+        break;
+      case '+':
+        s++;
+        break;
+    }
   }
 
 #if ARDUINOJSON_ENABLE_NAN
-  if (*s == 'n' || *s == 'N') {
-    return Number(traits::nan());
+  if (s < end && (*s == 'n' || *s == 'N')) {
+    return Number(FloatTraits<JsonFloat>::nan());
   }
 #endif
 
 #if ARDUINOJSON_ENABLE_INFINITY
-  if (*s == 'i' || *s == 'I') {
-    return Number(is_negative ? -traits::inf() : traits::inf());
+  if (s < end && (*s == 'i' || *s == 'I')) {
+    auto inf = FloatTraits<JsonFloat>::inf();
+    return Number(is_negative ? -inf : inf);
   }
 #endif
 
-  if (!isdigit(*s) && *s != '.')
+  if (s == end || (!isdigit(*s) && *s != '.'))
     return Number();
 
+  const char* digits = s;
   mantissa_t mantissa = 0;
-  exponent_t exponent_offset = 0;
-  const mantissa_t maxUint = JsonUInt(-1);
+  int exponent = 0;
+  bool truncated = false;  // nonzero digits didn't fit in the mantissa
 
-  while (isdigit(*s)) {
-    uint8_t digit = uint8_t(*s - '0');
-    if (mantissa > maxUint / 10)
-      break;
-    mantissa *= 10;
-    if (mantissa > maxUint - digit)
-      break;
-    mantissa += digit;
-    s++;
-  }
+  s = parseDigits(s, end, mantissa);
 
-  if (*s == '\0') {
+  if (s == end) {
     if (is_negative) {
       const mantissa_t sintMantissaMax = mantissa_t(1)
                                          << (sizeof(JsonInteger) * 8 - 1);
       if (mantissa <= sintMantissaMax) {
         return Number(JsonInteger(~mantissa + 1));
       }
-    } else {
+    } else if (mantissa <= mantissa_t(JsonUInt(-1))) {
       return Number(JsonUInt(mantissa));
     }
   }
 
-  // avoid mantissa overflow
-  while (mantissa > traits::mantissa_max) {
-    mantissa /= 10;
-    exponent_offset++;
-  }
-
   // remaing digits can't fit in the mantissa
-  while (isdigit(*s)) {
-    exponent_offset++;
+  bool full = s < end && isdigit(*s);
+  while (s < end && isdigit(*s)) {
+    truncated |= *s != '0';
+    exponent++;
     s++;
   }
 
-  if (*s == '.') {
+  if (s < end && *s == '.') {
     s++;
-    while (isdigit(*s)) {
-      if (mantissa < traits::mantissa_max / 10) {
-        mantissa = mantissa * 10 + uint8_t(*s - '0');
-        exponent_offset--;
-      }
+    if (!full) {
+      const char* first = s;
+      s = parseDigits(s, end, mantissa);
+      exponent -= int(s - first);
+    }
+    while (s < end && isdigit(*s)) {
+      truncated |= *s != '0';
       s++;
     }
   }
 
-  int exponent = 0;
-  if (*s == 'e' || *s == 'E') {
+  if (s < end && (*s == 'e' || *s == 'E')) {
     s++;
     bool negative_exponent = false;
-    if (*s == '-') {
+    if (s < end && *s == '-') {
       negative_exponent = true;
       s++;
-    } else if (*s == '+') {
+    } else if (s < end && *s == '+') {
       s++;
     }
 
-    while (isdigit(*s)) {
-      exponent = exponent * 10 + (*s - '0');
-      if (exponent + exponent_offset > traits::exponent_max) {
-        if (negative_exponent)
-          return Number(is_negative ? -0.0f : 0.0f);
-        else
-          return Number(is_negative ? -traits::inf() : traits::inf());
-      }
+    int explicit_exponent = 0;
+    while (s < end && isdigit(*s)) {
+      if (explicit_exponent < 10000)  // way out of range already
+        explicit_exponent = explicit_exponent * 10 + (*s - '0');
       s++;
     }
-    if (negative_exponent)
-      exponent = -exponent;
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
   }
-  exponent += exponent_offset;
 
   // we should be at the end of the string, otherwise it's an error
-  if (*s != '\0')
+  if (s != end)
     return Number();
 
-#if ARDUINOJSON_USE_DOUBLE
+#if ARDUINOJSON_ENABLE_FAST_FLOAT
+#  if ARDUINOJSON_USE_DOUBLE
+  bool isDouble = truncated || exponent < -FloatTraits<float>::exponent_max ||
+                  exponent > FloatTraits<float>::exponent_max ||
+                  mantissa > FloatTraits<float>::mantissa_max;
+  if (isDouble)
+    return Number(decimalToFloat<double>(mantissa, exponent, truncated,
+                                         is_negative, digits, end));
+#  endif
+  return Number(decimalToFloat<float>(mantissa, exponent, truncated,
+                                      is_negative, digits, end));
+#else
+  (void)digits;
+  (void)truncated;
+
+  // avoid mantissa overflow
+  while (mantissa > traits::mantissa_max) {
+    mantissa /= 10;
+    exponent++;
+  }
+
+  if (mantissa == 0)
+    return Number(is_negative ? -0.0f : 0.0f);
+
+  // check the range on the exponent of the leading digit, since the exponent
+  // of the last digit kept can be up to mantissa_digits lower
+  int leading_exponent = exponent;
+  for (mantissa_t m = mantissa; m >= 10; m /= 10)
+    leading_exponent++;
+  if (leading_exponent < -traits::exponent_max)
+    return Number(is_negative ? -0.0f : 0.0f);
+  if (leading_exponent > traits::exponent_max)
+    return Number(is_negative ? -traits::inf() : traits::inf());
+
+#  if ARDUINOJSON_USE_DOUBLE
   bool isDouble = exponent < -FloatTraits<float>::exponent_max ||
                   exponent > FloatTraits<float>::exponent_max ||
                   mantissa > FloatTraits<float>::mantissa_max;
@@ -223,11 +306,17 @@ inline Number parseNumber(const char* s) {
     auto final_result = make_float(double(mantissa), exponent);
     return Number(is_negative ? -final_result : final_result);
   } else
-#endif
+#  endif
   {
     auto final_result = make_float(float(mantissa), exponent);
     return Number(is_negative ? -final_result : final_result);
   }
+#endif
+}
+
+inline Number parseNumber(const char* s) {
+  ARDUINOJSON_ASSERT(s != 0);
+  return parseNumber(s, s + strlen(s));
 }
 
 template <typename T>
@@ -0,0 +1,185 @@
+// Header File
+// Battleship game core: a pure state machine driven by events. Gamepad/touch
+// input, BLE messages and timers are all turned into GameEvents by multi.cpp;
+// the engine never touches the display or the radio, it only reports what
+// should be sent and redrawn. Every applied event can be recorded in a
+// compact GameLog, which replays to the exact same state on device or host.
+
+#ifndef GAME_CORE_H
+#define GAME_CORE_H
+
+// Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// Board settings
+const int GAME_GRID_SIZE = 8;
+const int GAME_NUM_SHIPS = 3;
+const int GAME_SHIP_SIZES[GAME_NUM_SHIPS] = {4, 3, 2};
+const int GAME_TOTAL_HITS = 9;          // Sum of GAME_SHIP_SIZES
+const uint32_t READY_RESEND_MS = 1000;  // READY is repeated while waiting
+const uint32_t SYNC_TIMEOUT_MS = 3000;  // Give up on a board sync after this
+const int GAME_MAX_MESSAGES = 2;        // Messages one event can produce
+
+enum GamePhase : uint8_t {
+  PHASE_CONNECTING,  // No opponent yet
+  PHASE_PLACING,     // Placing our ships
+  PHASE_WAITING,     // Our ships are placed, opponent is not ready
+  PHASE_PLAYING,
+  PHASE_OVER
+};
+
+enum GameEventType : uint8_t {
+  EVENT_CONNECTED,
+  EVENT_DISCONNECTED,
+  EVENT_PLACE_SHIP,    // x, y, arg = 1 for horizontal
+  EVENT_FIRE,          // Local shot at x, y
+  EVENT_RECV_READY,    // arg = 1 if the opponent asks for a READY reply
+  EVENT_RECV_GUESS,    // Opponent shot at x, y
+  EVENT_RECV_RESULT,   // Result of our shot at x, y, arg = 1 for a hit
+  EVENT_TIMER,
+  EVENT_RECV_SYNC,     // Opponent's board state, see GameBoardSync
+  EVENT_TYPE_COUNT
+};
+
+// Full board state of one player, exchanged once after every (re)connect so
+// that a shot or result lost with the old link can be recovered. Boards are
+// bitboards with bit y * GAME_GRID_SIZE + x.
+const uint8_t SYNC_FLAG_READY = 0x01;
+const size_t SYNC_MESSAGE_SIZE = 4 + 1 + 4 * 8;  // "SYNC", flags, bitboards
+
+struct GameBoardSync {
+  uint8_t flags;
+  uint64_t shots;         // Our shots with a known result
+  uint64_t hits;          // ... that hit
+  uint64_t received;      // Opponent shots we answered
+  uint64_t receivedHits;  // ... that hit one of our ships
+};
+
+struct GameEvent {
+  GameEventType type;
+  uint8_t x;
+  uint8_t y;
+  uint8_t arg;
+  uint32_t timeMs;
+  GameBoardSync sync;     // EVENT_RECV_SYNC only
+};
+
+enum GameMessageType : uint8_t { MSG_READY, MSG_GUESS, MSG_RESULT, MSG_SYNC };
+
+struct GameMessage {
+  GameMessageType type;
+  uint8_t x;
+  uint8_t y;
+  uint8_t arg;  // MSG_READY: reply requested, MSG_RESULT: hit
+  GameBoardSync sync;     // MSG_SYNC only
+};
+
+// What the caller has to do after an event was applied
+struct GameEffects {
+  GameMessage messages[GAME_MAX_MESSAGES];
+  uint8_t messageCount;
+  int8_t shotCellX;         // Shot grid cell to redraw, -1 if none
+  int8_t shotCellY;
+  bool turnChanged;
+  bool phaseChanged;
+  const char* violation;    // Set if the event was rejected, state is unchanged
+};
+
+// Wire format shared by both players: "READY", "READY?", "GUESS:x,y", "x,y,H"
+// and "SYNC" followed by the flags byte and four little-endian bitboards
+size_t encodeGameMessage(const GameMessage& message, char* buffer, size_t bufferSize);
+bool decodeGameMessage(const uint8_t* data, size_t length, uint32_t timeMs, GameEvent& event);
+
+// Read position in a GameLog; times are stored as deltas so the cursor
+// carries the running timestamp
+struct GameLogCursor {
+  size_t pos = 1;  // Skip the role byte
+  uint32_t timeMs = 0;
+};
+
+class GameLog
+{
+    public:
+        static const size_t CAPACITY = 2048;
+
+        // Recording
+        void begin(bool isPlayer1);
+        bool append(const GameEvent& event);
+
+        // Playback
+        bool load(const uint8_t* data, size_t length);
+        bool read(GameLogCursor& cursor, GameEvent& event) const;
+
+        bool isPlayer1() const { return buffer[0] != 0; }
+        const uint8_t* data() const { return buffer; }
+        size_t size() const { return length; }
+        bool overflowed() const { return overflow; }
+
+    private:
+        // Layout: role byte, then per event two packed bytes
+        // (type << 4 | arg, x << 4 | y) and the time delta as a varint;
+        // EVENT_RECV_SYNC records are followed by the sync payload
+        uint8_t buffer[CAPACITY];
+        size_t length = 0;
+        uint32_t lastTimeMs = 0;
+        bool overflow = false;
+};
+
+class GameEngine
+{
+    public:
+        explicit GameEngine(bool isPlayer1, GameLog* log = nullptr);
+
+        GameEffects apply(const GameEvent& event);
+        static bool replay(const GameLog& log, GameEngine& engine);
+
+        bool canPlaceShip(int x, int y, int len, bool horizontal) const;
+
+        // State
+        bool isPlayer1() const { return player1; }
+        GamePhase phase() const { return currentPhase; }
+        bool connected() const { return isConnected; }
+        bool localReady() const { return isLocalReady; }
+        bool opponentReady() const { return isOpponentReady; }
+        bool myTurn() const { return isMyTurn; }
+        bool syncing() const { return awaitingSync; }  // Firing waits for the opponent's sync
+        bool won() const { return hits == GAME_TOTAL_HITS; }
+        int shipsPlaced() const { return placedCount; }
+        int hitCount() const { return hits; }
+        int hitsTakenCount() const { return hitsTaken; }
+
+        // ' ' = unknown, 'X' = shot pending, 'H' = hit, 'O' = miss
+        char shotCell(int x, int y) const { return shotGrid[y][x]; }
+        // ' ' = water, 'S' = ship, 'X' = ship hit, 'O' = opponent miss
+        char ownCell(int x, int y) const { return ownGrid[y][x]; }
+
+        GameBoardSync boardSync() const;
+
+    private:
+        void applyEvent(const GameEvent& event, GameEffects& effects);
+        void setPhase(GamePhase phase, GameEffects& effects);
+        void setTurn(bool turn, GameEffects& effects);
+        void send(GameEffects& effects, GameMessageType type, uint8_t x, uint8_t y, uint8_t arg);
+        void startPlayingIfReady(GameEffects& effects);
+        void reconcile(const GameBoardSync& sync, GameEffects& effects);
+
+        GameLog* log;
+        bool player1;
+        GamePhase currentPhase = PHASE_CONNECTING;
+        bool isConnected = false;
+        bool isLocalReady = false;
+        bool isOpponentReady = false;
+        bool isMyTurn = false;
+        bool awaitingSync = false;
+        bool syncSent = false;
+        uint32_t connectedMs = 0;
+        int placedCount = 0;
+        int hits = 0;
+        int hitsTaken = 0;
+        uint32_t lastReadySentMs = 0;
+        char shotGrid[GAME_GRID_SIZE][GAME_GRID_SIZE];
+        char ownGrid[GAME_GRID_SIZE][GAME_GRID_SIZE];
+};
+
+#endif
@@ -0,0 +1,452 @@
+#include "../include/GameCore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////
+// Wire format
+////////////////////////////////////////////////////////////////////
+static const size_t SYNC_PAYLOAD_SIZE = SYNC_MESSAGE_SIZE - 4;
+
+static void putUint64(uint8_t* out, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static uint64_t getUint64(const uint8_t* in) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; i++) {
+    value |= (uint64_t)in[i] << (8 * i);
+  }
+  return value;
+}
+
+static void putSyncPayload(uint8_t* out, const GameBoardSync& sync) {
+  out[0] = sync.flags;
+  putUint64(out + 1, sync.shots);
+  putUint64(out + 9, sync.hits);
+  putUint64(out + 17, sync.received);
+  putUint64(out + 25, sync.receivedHits);
+}
+
+static void getSyncPayload(const uint8_t* in, GameBoardSync& sync) {
+  sync.flags = in[0];
+  sync.shots = getUint64(in + 1);
+  sync.hits = getUint64(in + 9);
+  sync.received = getUint64(in + 17);
+  sync.receivedHits = getUint64(in + 25);
+}
+
+static uint64_t cellBit(int x, int y) {
+  return (uint64_t)1 << (y * GAME_GRID_SIZE + x);
+}
+
+size_t encodeGameMessage(const GameMessage& message, char* buffer, size_t bufferSize) {
+  int n = 0;
+  switch (message.type) {
+    case MSG_READY:
+      n = snprintf(buffer, bufferSize, message.arg ? "READY?" : "READY");
+      break;
+    case MSG_GUESS:
+      n = snprintf(buffer, bufferSize, "GUESS:%d,%d", message.x, message.y);
+      break;
+    case MSG_RESULT:
+      n = snprintf(buffer, bufferSize, "%d,%d,%c", message.x, message.y, message.arg ? 'H' : 'O');
+      break;
+    case MSG_SYNC:
+      if (bufferSize < SYNC_MESSAGE_SIZE) return 0;
+      memcpy(buffer, "SYNC", 4);
+      putSyncPayload((uint8_t*)buffer + 4, message.sync);
+      return SYNC_MESSAGE_SIZE;
+  }
+  return n < 0 ? 0 : (size_t)n;
+}
+
+static bool isGridDigit(uint8_t c) {
+  return c >= '0' && c < '0' + GAME_GRID_SIZE;
+}
+
+bool decodeGameMessage(const uint8_t* data, size_t length, uint32_t timeMs, GameEvent& event) {
+  event.x = 0;
+  event.y = 0;
+  event.arg = 0;
+  event.timeMs = timeMs;
+  event.sync = GameBoardSync();
+
+  if (length >= 5 && memcmp(data, "READY", 5) == 0) {
+    event.type = EVENT_RECV_READY;
+    event.arg = length > 5 && data[5] == '?';
+    return true;
+  }
+  if (length == 9 && memcmp(data, "GUESS:", 6) == 0 && isGridDigit(data[6]) && isGridDigit(data[8])) {
+    event.type = EVENT_RECV_GUESS;
+    event.x = data[6] - '0';
+    event.y = data[8] - '0';
+    return true;
+  }
+  if (length == 5 && isGridDigit(data[0]) && isGridDigit(data[2]) && (data[4] == 'H' || data[4] == 'O')) {
+    event.type = EVENT_RECV_RESULT;
+    event.x = data[0] - '0';
+    event.y = data[2] - '0';
+    event.arg = data[4] == 'H';
+    return true;
+  }
+  if (length == SYNC_MESSAGE_SIZE && memcmp(data, "SYNC", 4) == 0) {
+    event.type = EVENT_RECV_SYNC;
+    getSyncPayload(data + 4, event.sync);
+    return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////
+// GameLog
+////////////////////////////////////////////////////////////////////
+void GameLog::begin(bool isPlayer1) {
+  buffer[0] = isPlayer1 ? 1 : 0;
+  length = 1;
+  lastTimeMs = 0;
+  overflow = false;
+}
+
+bool GameLog::append(const GameEvent& event) {
+  if (overflow) return false;
+
+  // Worst case: 2 packed bytes + 5 varint bytes + sync payload
+  uint8_t record[7 + SYNC_PAYLOAD_SIZE];
+  size_t n = 0;
+  record[n++] = (uint8_t)((event.type << 4) | (event.arg & 0x0F));
+  record[n++] = (uint8_t)((event.x << 4) | (event.y & 0x0F));
+  uint32_t delta = event.timeMs - lastTimeMs;
+  do {
+    uint8_t b = delta & 0x7F;
+    delta >>= 7;
+    record[n++] = delta ? (b | 0x80) : b;
+  } while (delta);
+  if (event.type == EVENT_RECV_SYNC) {
+    putSyncPayload(record + n, event.sync);
+    n += SYNC_PAYLOAD_SIZE;
+  }
+
+  if (length + n > CAPACITY) {
+    overflow = true;
+    return false;
+  }
+  memcpy(buffer + length, record, n);
+  length += n;
+  lastTimeMs = event.timeMs;
+  return true;
+}
+
+bool GameLog::load(const uint8_t* data, size_t dataLength) {
+  if (dataLength < 1 || dataLength > CAPACITY) return false;
+  memcpy(buffer, data, dataLength);
+  length = dataLength;
+  overflow = false;
+  lastTimeMs = 0;
+  return true;
+}
+
+bool GameLog::read(GameLogCursor& cursor, GameEvent& event) const {
+  size_t pos = cursor.pos;
+  if (pos + 3 > length) return false;
+
+  uint8_t head = buffer[pos++];
+  uint8_t cell = buffer[pos++];
+  uint32_t delta = 0;
+  int shift = 0;
+  uint8_t b;
+  do {
+    if (pos >= length || shift > 28) return false;
+    b = buffer[pos++];
+    delta |= (uint32_t)(b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+
+  event.type = (GameEventType)(head >> 4);
+  event.arg = head & 0x0F;
+  event.x = cell >> 4;
+  event.y = cell & 0x0F;
+  event.timeMs = cursor.timeMs + delta;
+  event.sync = GameBoardSync();
+  if (event.type >= EVENT_TYPE_COUNT) return false;
+  if (event.type == EVENT_RECV_SYNC) {
+    if (pos + SYNC_PAYLOAD_SIZE > length) return false;
+    getSyncPayload(buffer + pos, event.sync);
+    pos += SYNC_PAYLOAD_SIZE;
+  }
+
+  cursor.pos = pos;
+  cursor.timeMs = event.timeMs;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////
+// GameEngine
+////////////////////////////////////////////////////////////////////
+GameEngine::GameEngine(bool isPlayer1, GameLog* gameLog) : log(gameLog), player1(isPlayer1) {
+  memset(shotGrid, ' ', sizeof(shotGrid));
+  memset(ownGrid, ' ', sizeof(ownGrid));
+  if (log) log->begin(isPlayer1);
+}
+
+bool GameEngine::replay(const GameLog& gameLog, GameEngine& engine) {
+  engine = GameEngine(gameLog.isPlayer1());
+  GameLogCursor cursor;
+  GameEvent event;
+  while (gameLog.read(cursor, event)) {
+    engine.apply(event);
+  }
+  return cursor.pos == gameLog.size();
+}
+
+GameBoardSync GameEngine::boardSync() const {
+  GameBoardSync sync = {};
+  sync.flags = isLocalReady ? SYNC_FLAG_READY : 0;
+  for (int y = 0; y < GAME_GRID_SIZE; y++) {
+    for (int x = 0; x < GAME_GRID_SIZE; x++) {
+      uint64_t bit = cellBit(x, y);
+      if (shotGrid[y][x] == 'H' || shotGrid[y][x] == 'O') sync.shots |= bit;
+      if (shotGrid[y][x] == 'H') sync.hits |= bit;
+      if (ownGrid[y][x] == 'X' || ownGrid[y][x] == 'O') sync.received |= bit;
+      if (ownGrid[y][x] == 'X') sync.receivedHits |= bit;
+    }
+  }
+  return sync;
+}
+
+bool GameEngine::canPlaceShip(int x, int y, int len, bool horizontal) const {
+  if (x < 0 || y < 0 || x >= GAME_GRID_SIZE || y >= GAME_GRID_SIZE) return false;
+  if (horizontal ? x + len > GAME_GRID_SIZE : y + len > GAME_GRID_SIZE) return false;
+  for (int i = 0; i < len; i++) {
+    if (ownGrid[horizontal ? y : y + i][horizontal ? x + i : x] != ' ') return false;
+  }
+  return true;
+}
+
+void GameEngine::setPhase(GamePhase phase, GameEffects& effects) {
+  if (currentPhase == phase) return;
+  currentPhase = phase;
+  effects.phaseChanged = true;
+}
+
+void GameEngine::setTurn(bool turn, GameEffects& effects) {
+  if (isMyTurn == turn) return;
+  isMyTurn = turn;
+  effects.turnChanged = true;
+}
+
+void GameEngine::send(GameEffects& effects, GameMessageType type, uint8_t x, uint8_t y, uint8_t arg) {
+  if (effects.messageCount >= GAME_MAX_MESSAGES) return;
+  GameMessage& message = effects.messages[effects.messageCount++];
+  message.type = type;
+  message.x = x;
+  message.y = y;
+  message.arg = arg;
+  message.sync = type == MSG_SYNC ? boardSync() : GameBoardSync();
+}
+
+void GameEngine::startPlayingIfReady(GameEffects& effects) {
+  if (currentPhase != PHASE_WAITING || !isOpponentReady) return;
+  setPhase(PHASE_PLAYING, effects);
+  setTurn(player1, effects); // P1 starts
+}
+
+// Both players reconcile the same pair of snapshots: neither side can fire
+// between sending its sync and receiving the other one, and the opponent's
+// sync is the first message on the new link. A pending shot the opponent has
+// answered takes its result from their bitboards; one they never received is
+// taken back. The turn then follows from the shot counts, P1 firing first.
+void GameEngine::reconcile(const GameBoardSync& sync, GameEffects& effects) {
+  int myShots = 0;
+  int theirShots = 0;
+  for (int y = 0; y < GAME_GRID_SIZE; y++) {
+    for (int x = 0; x < GAME_GRID_SIZE; x++) {
+      char& shot = shotGrid[y][x];
+      if (shot == 'X') {
+        uint64_t bit = cellBit(x, y);
+        if (sync.received & bit) {
+          shot = (sync.receivedHits & bit) ? 'H' : 'O';
+          if (shot == 'H') hits++;
+        } else {
+          shot = ' ';
+        }
+        effects.shotCellX = x;
+        effects.shotCellY = y;
+      }
+      if (shot == 'H' || shot == 'O') myShots++;
+      if (ownGrid[y][x] == 'X' || ownGrid[y][x] == 'O') theirShots++;
+    }
+  }
+
+  if (hits == GAME_TOTAL_HITS || hitsTaken == GAME_TOTAL_HITS) {
+    setPhase(PHASE_OVER, effects);
+    setTurn(false, effects);
+  } else {
+    setTurn(player1 ? myShots == theirShots : theirShots > myShots, effects);
+  }
+}
+
+GameEffects GameEngine::apply(const GameEvent& event) {
+  GameEffects effects = {};
+  effects.shotCellX = -1;
+  effects.shotCellY = -1;
+  bool wasSyncing = awaitingSync;
+  applyEvent(event, effects);
+
+  // Timer ticks that did nothing leave the state untouched, so they are
+  // skipped to keep the log small without affecting replay
+  bool timerChangedState = effects.messageCount > 0 || wasSyncing != awaitingSync;
+  if (log && (event.type != EVENT_TIMER || timerChangedState)) {
+    log->append(event);
+  }
+  return effects;
+}
+
+void GameEngine::applyEvent(const GameEvent& event, GameEffects& effects) {
+  if (event.x >= GAME_GRID_SIZE || event.y >= GAME_GRID_SIZE) {
+    effects.violation = "cell out of range";
+    return;
+  }
+
+  switch (event.type) {
+    case EVENT_CONNECTED:
+      isConnected = true;
+      connectedMs = event.timeMs;
+      awaitingSync = true;
+      syncSent = false;
+      if (currentPhase == PHASE_CONNECTING) setPhase(PHASE_PLACING, effects);
+      // P2 opens the sync: its write can only arrive once it has subscribed
+      // to notifications, so P1's reply cannot get lost. The caller holds
+      // the message back until the link's MTU is large enough for it.
+      if (!player1) {
+        send(effects, MSG_SYNC, 0, 0, 0);
+        syncSent = true;
+      }
+      break;
+
+    case EVENT_DISCONNECTED:
+      // Boards, readiness and turn survive a reconnect
+      isConnected = false;
+      awaitingSync = false;
+      break;
+
+    case EVENT_RECV_SYNC:
+      // Reply with our state from before reconciling
+      if (!syncSent) {
+        send(effects, MSG_SYNC, 0, 0, 0);
+        syncSent = true;
+      }
+      awaitingSync = false;
+      if (event.sync.flags & SYNC_FLAG_READY) {
+        isOpponentReady = true;
+        startPlayingIfReady(effects);
+      }
+      if (currentPhase >= PHASE_PLAYING) reconcile(event.sync, effects);
+      break;
+
+    case EVENT_PLACE_SHIP: {
+      if (currentPhase != PHASE_PLACING || placedCount >= GAME_NUM_SHIPS) {
+        effects.violation = "ship placed outside placing phase";
+        break;
+      }
+      int len = GAME_SHIP_SIZES[placedCount];
+      bool horizontal = event.arg != 0;
+      if (!canPlaceShip(event.x, event.y, len, horizontal)) {
+        effects.violation = "ship does not fit";
+        break;
+      }
+      for (int i = 0; i < len; i++) {
+        ownGrid[horizontal ? event.y : event.y + i][horizontal ? event.x + i : event.x] = 'S';
+      }
+      if (++placedCount == GAME_NUM_SHIPS) {
+        isLocalReady = true;
+        setPhase(PHASE_WAITING, effects);
+        if (isConnected) {
+          send(effects, MSG_READY, 0, 0, 1);
+          lastReadySentMs = event.timeMs;
+        }
+        startPlayingIfReady(effects);
+      }
+      break;
+    }
+
+    case EVENT_FIRE:
+      if (currentPhase != PHASE_PLAYING || !isMyTurn) {
+        effects.violation = "fired out of turn";
+        break;
+      }
+      if (!isConnected || awaitingSync) {
+        effects.violation = "fired before the boards were synced";
+        break;
+      }
+      if (shotGrid[event.y][event.x] != ' ') {
+        effects.violation = "cell already shot";
+        break;
+      }
+      shotGrid[event.y][event.x] = 'X';
+      effects.shotCellX = event.x;
+      effects.shotCellY = event.y;
+      send(effects, MSG_GUESS, event.x, event.y, 0);
+      setTurn(false, effects);
+      break;
+
+    case EVENT_RECV_READY:
+      isOpponentReady = true;
+      if (event.arg && isLocalReady) send(effects, MSG_READY, 0, 0, 0);
+      startPlayingIfReady(effects);
+      break;
+
+    case EVENT_RECV_GUESS: {
+      if (currentPhase != PHASE_PLAYING || isMyTurn) {
+        effects.violation = "opponent fired out of turn";
+        break;
+      }
+      char& cell = ownGrid[event.y][event.x];
+      if (cell == 'X' || cell == 'O') {
+        effects.violation = "opponent repeated a shot";
+        break;
+      }
+      bool hit = cell == 'S';
+      cell = hit ? 'X' : 'O';
+      send(effects, MSG_RESULT, event.x, event.y, hit);
+      if (hit && ++hitsTaken == GAME_TOTAL_HITS) {
+        setPhase(PHASE_OVER, effects);
+        setTurn(false, effects);
+      } else {
+        setTurn(true, effects);
+      }
+      break;
+    }
+
+    case EVENT_RECV_RESULT:
+      if (currentPhase != PHASE_PLAYING || shotGrid[event.y][event.x] != 'X') {
+        effects.violation = "result for a shot we did not fire";
+        break;
+      }
+      shotGrid[event.y][event.x] = event.arg ? 'H' : 'O';
+      effects.shotCellX = event.x;
+      effects.shotCellY = event.y;
+      if (event.arg && ++hits == GAME_TOTAL_HITS) {
+        setPhase(PHASE_OVER, effects);
+        setTurn(false, effects);
+      }
+      break;
+
+    case EVENT_TIMER:
+      if (awaitingSync && event.timeMs - connectedMs >= SYNC_TIMEOUT_MS) {
+        awaitingSync = false;  // Opponent without sync support or MTU too small
+      }
+      if (currentPhase == PHASE_WAITING && isConnected &&
+          event.timeMs - lastReadySentMs >= READY_RESEND_MS) {
+        send(effects, MSG_READY, 0, 0, 1);
+        lastReadySentMs = event.timeMs;
+      }
+      break;
+
+    default:
+      effects.violation = "unknown event";
+      break;
+  }
+}
@@ -7,6 +7,7 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include "Adafruit_seesaw.h"
+#include "../include/GameCore.h"
 
 // BLE Setup
 #define SERVICE_UUID "60d3a4dc-1951-4791-8c42-198c2180cf2b"
@@ -21,9 +22,50 @@ BLEClient *pClient;                 // Client-side for P2
 BLERemoteCharacteristic *pRemoteCharacteristic; // Client-side for P2
 bool deviceConnected = false;
 bool isPlayer1 = false; // Set to false for Player 2
-bool opponentReady = false;
-bool localReady = false;
-bool myTurn = false;    // Turn tracking: true for current player’s turn
+
+// BLE link tuning
+const uint16_t GAME_BLE_MTU = 128;              // Board sync needs SYNC_MESSAGE_SIZE + 3
+const uint16_t CONN_INTERVAL_MIN = 0x06;        // 7.5 ms (1.25 ms units)
+const uint16_t CONN_INTERVAL_MAX = 0x0C;        // 15 ms
+const uint16_t CONN_LATENCY = 0;                // Answer every event, shots are latency bound
+const uint16_t CONN_SUPERVISION_TIMEOUT = 200;  // 2 s (10 ms units)
+
+// Game state lives in the engine; BLE callbacks only queue events for loop()
+GameLog gameLog;
+GameEngine game(isPlayer1, &gameLog);
+QueueHandle_t eventQueue;
+const int EVENT_QUEUE_LENGTH = 16;
+const unsigned long TIMER_EVENT_MS = 250;
+unsigned long lastTimerEvent = 0;
+unsigned long shotSentAt = 0;  // Turn latency: GUESS sent until its result is drawn
+
+// P2 sends its board sync as soon as it is connected, which can be before
+// the MTU exchange has finished. A sync that doesn't fit yet is kept here
+// and sent once the MTU is large enough, instead of leaving the opponent to
+// wait for SYNC_TIMEOUT_MS.
+GameMessage pendingSync;
+bool syncPending = false;
+
+// BLE reconnect cache (P2)
+const int INITIAL_SCAN_SECONDS = 10;   // Upper bound, the scan stops on the first match
+const int RECONNECT_SCAN_SECONDS = 2;  // Short fallback scan when the direct connect fails
+const uint32_t DIRECT_CONNECT_TIMEOUT_MS = 1500;  // Then the pending connect is cancelled
+esp_bd_addr_t cachedServerAddress;
+esp_ble_addr_type_t cachedServerAddressType = BLE_ADDR_TYPE_PUBLIC;
+bool serverAddressCached = false;
+uint16_t cachedCharacteristicHandle = 0;
+BLEAdvertisedDevice* scannedServer = nullptr; // Set by the scan callback, consumed in loop()
+volatile bool scanInProgress = false;
+bool directConnectTried = false;
+unsigned long disconnectedAt = 0;
+
+// The direct connect runs in its own task so that loop() can enforce the
+// timeout: BLEClient::connect() on the 2.x Arduino core has no timeout and
+// waits for the stack's connection timeout when the server is absent
+enum DirectConnectState { DIRECT_CONNECT_IDLE, DIRECT_CONNECT_PENDING, DIRECT_CONNECT_OK, DIRECT_CONNECT_FAILED };
+volatile DirectConnectState directConnectState = DIRECT_CONNECT_IDLE;
+unsigned long directConnectStartedAt = 0;
+bool directConnectCancelled = false;
 
 // Seesaw Gamepad setup
 Adafruit_seesaw ss;
@@ -35,45 +77,40 @@ Adafruit_seesaw ss;
 uint32_t button_mask = (1UL << BUTTON_A_PIN) | (1UL << BUTTON_B_PIN);
 
 // Grid settings
-const int GRID_SIZE = 8;
+const int GRID_SIZE = GAME_GRID_SIZE;
 const int CELL_SIZE = 25;
-char grid[GRID_SIZE][GRID_SIZE];
-char hiddenGrid[GRID_SIZE][GRID_SIZE];
-
-// Ship sizes
-int ships[] = {4, 3, 2};
-const int NUM_SHIPS = 3;
-
-struct Ship {
-  int x;
-  int y;
-  int length;
-  bool horizontal;
-};
-
-Ship placedShips[NUM_SHIPS];
 
 // Cursor position
 int cursorX = 0;
 int cursorY = 0;
 int lastCursorX = -1;
 int lastCursorY = -1;
-int hits = 0;
-int totalHitsNeeded = 9;
-bool gameOver = false;
 bool gridDrawn = false;
 
 // Function declarations
 void drawInitialGrid();
 void updateCell(int x, int y);
 void updateCursor();
-bool canPlaceShip(int x, int y, int len, int dir);
-void sendMove(int x, int y, char result);
+void postEvent(GameEventType type, uint8_t x, uint8_t y, uint8_t arg);
+void postMessage(const uint8_t* data, size_t length);
+void applyEvent(const GameEvent& event);
+void dispatch(GameEventType type, uint8_t x, uint8_t y, uint8_t arg);
+void processEvents();
+uint16_t currentMtu();
+void sendMessage(const GameMessage& message);
+void sendPendingSync();
+void printGameLog();
 void placeShipsScreen();
 void waitForOpponentScreen();
-char checkHit(int x, int y);
 void drawScreenTextWithBackground(String text, int backgroundColor);
 void updateTurnDisplay();
+bool connectToServer(BLEAdvertisedDevice* device);
+bool startDirectConnect();
+void directConnectTask(void* parameter);
+bool attachRemoteCharacteristic();
+void serverLinkReady();
+void startServerScan(int seconds);
+void handleReconnect();
 
 // BLE Server Callbacks (P1)
 class MyServerCallbacks : public BLEServerCallbacks {
@@ -81,13 +118,17 @@ class MyServerCallbacks : public BLEServerCallbacks {
     deviceConnected = true;
     Serial.println("BLE: Device connected successfully");
     drawScreenTextWithBackground("Connected!", TFT_GREEN);
-    myTurn = true; // P1 starts
+    postEvent(EVENT_CONNECTED, 0, 0, 0);
+  }
+
+  void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+    pServer->updateConnParams(param->connect.remote_bda, CONN_INTERVAL_MIN, CONN_INTERVAL_MAX,
+                              CONN_LATENCY, CONN_SUPERVISION_TIMEOUT);
   }
 
   void onDisconnect(BLEServer* pServer) {
     deviceConnected = false;
-    opponentReady = false;
-    localReady = false;
+    postEvent(EVENT_DISCONNECTED, 0, 0, 0);
     Serial.println("BLE: Device disconnected");
     pServer->startAdvertising();
     Serial.println("BLE: Restarted advertising");
@@ -99,75 +140,58 @@ class MyServerCallbacks : public BLEServerCallbacks {
 class MyCharacteristicCallbacks : public BLECharacteristicCallbacks {
   void onWrite(BLECharacteristic* pCharacteristic) {
     std::string value = pCharacteristic->getValue();
-    if (value == "READY") {
-      opponentReady = true;
-      Serial.println("BLE: Received READY from opponent");
-    } else if (value.substr(0, 6) == "GUESS:") {
-      int x = value[6] - '0';
-      int y = value[8] - '0';
-      char result = checkHit(x, y);
-      hiddenGrid[y][x] = result;
-      String response = String(x) + "," + String(y) + "," + (result == 'X' ? 'H' : 'O');
-      pCharacteristic->setValue(response.c_str());
-      pCharacteristic->notify();
-      Serial.println("BLE: Received guess: " + String(x) + "," + String(y) + " Result: " + (result == 'X' ? 'H' : 'O'));
-      myTurn = true; // P1’s turn after P2 shoots
-      updateTurnDisplay();
-    } else if (value.length() >= 5) {
-      int x = value[0] - '0';
-      int y = value[2] - '0';
-      char result = value[4];
-      grid[y][x] = result;
-      if (result == 'H') {
-        hits++;
-        if (hits == totalHitsNeeded) gameOver = true;
-      }
-      updateCell(x, y);
-      Serial.print("BLE: Shot confirmed at: ("); Serial.print(x); Serial.print(", "); Serial.print(y);
-      Serial.print(") - "); Serial.println(result == 'H' ? "Hit" : "Miss");
-    }
+    postMessage((const uint8_t*)value.data(), value.length());
   }
 };
 
 // BLE Client Callbacks (P2)
+// The link only counts as connected once the characteristic is attached,
+// see serverLinkReady(); onConnect() fires inside pClient->connect(), before
+// that.
 class MyClientCallbacks : public BLEClientCallbacks {
   void onConnect(BLEClient* pClient) {
-    deviceConnected = true;
-    Serial.println("BLE: Connected to server");
-    drawScreenTextWithBackground("Connected!", TFT_GREEN);
-    myTurn = false; // P2 waits for P1’s first move
+    Serial.println("BLE: Link to server up");
   }
 
   void onDisconnect(BLEClient* pClient) {
+    pRemoteCharacteristic = nullptr;  // Belongs to the link that went away
+    if (!deviceConnected) return;     // A connect attempt that didn't finish
     deviceConnected = false;
-    opponentReady = false;
-    localReady = false;
+    postEvent(EVENT_DISCONNECTED, 0, 0, 0);
+    directConnectTried = false;
+    disconnectedAt = millis();
     Serial.println("BLE: Disconnected from server");
     drawScreenTextWithBackground("Disconnected! Reconnecting...", TFT_RED);
   }
 };
 
-// Notification Callback for P2
-static void notifyCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, uint8_t* pData, size_t length, bool isNotify) {
-  String value = String((char*)pData, length);
-  if (value == "READY") {
-    opponentReady = true;
-    Serial.println("BLE: Received READY from server");
-  } else if (value.length() >= 5) {
-    int x = value[0] - '0';
-    int y = value[2] - '0';
-    char result = value[4];
-    grid[y][x] = result;
-    if (result == 'H') {
-      hits++;
-      if (hits == totalHitsNeeded) gameOver = true;
+// BLE Scan Callbacks (P2)
+// Matches the server by its advertised service UUID (or name, which may only be
+// in the scan response) and stops the scan on the first hit instead of waiting
+// out the full scan window.
+class MyAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
+  void onResult(BLEAdvertisedDevice advertisedDevice) {
+    if (scannedServer) return;
+    bool serviceMatch = advertisedDevice.haveServiceUUID() &&
+                        advertisedDevice.isAdvertisingService(BLEUUID(SERVICE_UUID));
+    bool nameMatch = advertisedDevice.haveName() &&
+                     advertisedDevice.getName() == BLE_BROADCAST_NAME.c_str();
+    if (serviceMatch || nameMatch) {
+      scannedServer = new BLEAdvertisedDevice(advertisedDevice);
+      BLEDevice::getScan()->stop();
+      scanInProgress = false;
+      Serial.println("BLE: Found server " + String(advertisedDevice.getAddress().toString().c_str()));
     }
-    updateCell(x, y);
-    Serial.print("BLE: Shot confirmed at: ("); Serial.print(x); Serial.print(", "); Serial.print(y);
-    Serial.print(") - "); Serial.println(result == 'H' ? "Hit" : "Miss");
-    myTurn = true; // P2’s turn after P1 shoots
-    updateTurnDisplay();
   }
+};
+
+static void scanCompleteCallback(BLEScanResults results) {
+  scanInProgress = false;
+}
+
+// Notification Callback for P2
+static void notifyCallback(BLERemoteCharacteristic* pBLERemoteCharacteristic, uint8_t* pData, size_t length, bool isNotify) {
+  postMessage(pData, length);
 }
 
 void setup() {
@@ -185,10 +209,13 @@ void setup() {
   ss.setGPIOInterrupts(button_mask, 1);
   Serial.println("Seesaw Gamepad initialized");
 
+  eventQueue = xQueueCreate(EVENT_QUEUE_LENGTH, sizeof(GameEvent));
+
   if (isPlayer1) {
     // Player 1: Server Setup
     Serial.println("BLE: Initializing as server...");
     BLEDevice::init(BLE_BROADCAST_NAME.c_str());
+    BLEDevice::setMTU(GAME_BLE_MTU);
     pServer = BLEDevice::createServer();
     pServer->setCallbacks(new MyServerCallbacks());
     pService = pServer->createService(SERVICE_UUID);
@@ -205,7 +232,8 @@ void setup() {
     BLEAdvertising *pAdvertising = BLEDevice::getAdvertising();
     pAdvertising->addServiceUUID(SERVICE_UUID);
     pAdvertising->setScanResponse(true);
-    pAdvertising->setMinPreferred(0x06);
+    pAdvertising->setMinPreferred(CONN_INTERVAL_MIN);
+    pAdvertising->setMaxPreferred(CONN_INTERVAL_MAX);
     BLEDevice::startAdvertising();
     Serial.println("BLE: Broadcasting as " + BLE_BROADCAST_NAME);
     drawScreenTextWithBackground("Broadcasting as:\n" + BLE_BROADCAST_NAME, TFT_BLUE);
@@ -213,36 +241,24 @@ void setup() {
     // Player 2: Client Setup
     Serial.println("BLE: Initializing as client...");
     BLEDevice::init(BLE_CLIENT_NAME.c_str());
+    BLEDevice::setMTU(GAME_BLE_MTU); // Requested from the server on connect
     pClient = BLEDevice::createClient();
     pClient->setClientCallbacks(new MyClientCallbacks());
 
     BLEScan* pScan = BLEDevice::getScan();
+    pScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
     pScan->setActiveScan(true);
-    pScan->start(10, false);
-    BLEScanResults results = pScan->getResults();
-    BLEAdvertisedDevice* targetDevice = nullptr;
-    for (int i = 0; i < results.getCount(); i++) {
-      BLEAdvertisedDevice device = results.getDevice(i);
-      if (device.getName() == BLE_BROADCAST_NAME.c_str()) {
-        targetDevice = new BLEAdvertisedDevice(device);
-        break;
-      }
+    startServerScan(INITIAL_SCAN_SECONDS);
+    while (scanInProgress && !scannedServer) {
+      delay(10);
     }
 
-    if (targetDevice) {
-      if (pClient->connect(targetDevice)) {
-        BLERemoteService* pRemoteService = pClient->getService(SERVICE_UUID);
-        if (pRemoteService) {
-          pRemoteCharacteristic = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID);
-          if (pRemoteCharacteristic && pRemoteCharacteristic->canNotify()) {
-            pRemoteCharacteristic->registerForNotify(notifyCallback);
-            Serial.println("BLE: Registered for notifications");
-          }
-        }
+    if (scannedServer) {
+      if (connectToServer(scannedServer)) {
+        serverLinkReady();
       } else {
         Serial.println("BLE: Failed to connect to server");
       }
-      delete targetDevice;
     } else {
       Serial.println("BLE: Server not found");
     }
@@ -255,14 +271,7 @@ void setup() {
   }
 
   delay(2000); // Show "Connected!" briefly
-
-  // Initialize grids
-  for (int i = 0; i < GRID_SIZE; i++) {
-    for (int j = 0; j < GRID_SIZE; j++) {
-      grid[i][j] = ' ';
-      hiddenGrid[i][j] = ' ';
-    }
-  }
+  processEvents();
 
   placeShipsScreen();
   waitForOpponentScreen();
@@ -273,37 +282,14 @@ void setup() {
 
 void loop() {
   M5.update();
+  processEvents();
 
   // Reconnect logic for P2
   if (!deviceConnected && !isPlayer1 && pClient) {
-    BLEScan* pScan = BLEDevice::getScan();
-    pScan->start(5, false);
-    BLEScanResults results = pScan->getResults();
-    BLEAdvertisedDevice* targetDevice = nullptr;
-    for (int i = 0; i < results.getCount(); i++) {
-      BLEAdvertisedDevice device = results.getDevice(i);
-      if (device.getName() == BLE_BROADCAST_NAME.c_str()) {
-        targetDevice = new BLEAdvertisedDevice(device);
-        break;
-      }
-    }
-    if (targetDevice && pClient->connect(targetDevice)) {
-      BLERemoteService* pRemoteService = pClient->getService(SERVICE_UUID);
-      if (pRemoteService) {
-        pRemoteCharacteristic = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID);
-        if (pRemoteCharacteristic && pRemoteCharacteristic->canNotify()) {
-          pRemoteCharacteristic->registerForNotify(notifyCallback);
-          Serial.println("BLE: Reconnected and registered for notifications");
-          deviceConnected = true;
-          myTurn = false; // P2 waits after reconnect
-          updateTurnDisplay();
-        }
-      }
-      delete targetDevice;
-    }
+    handleReconnect();
   }
 
-  if (!gameOver && deviceConnected && opponentReady && localReady && myTurn) {
+  if (game.phase() == PHASE_PLAYING && game.myTurn() && !game.syncing() && deviceConnected) {
     int16_t joyX = 1023 - ss.analogRead(JOYSTICK_X_PIN);
     int16_t joyY = 1023 - ss.analogRead(JOYSTICK_Y_PIN);
     uint32_t buttons = ss.digitalReadBulk(button_mask);
@@ -338,13 +324,9 @@ void loop() {
 
     static bool lastButtonA = false;
     if ((buttonA && !lastButtonA) || (!isTouching && wasTouching)) {
-      if (grid[cursorY][cursorX] == ' ') {
-        grid[cursorY][cursorX] = 'X'; // Mark shot temporarily
-        updateCell(cursorX, cursorY); // Show yellow X immediately
-        sendMove(cursorX, cursorY, 'X');
+      if (game.shotCell(cursorX, cursorY) == ' ') {
+        dispatch(EVENT_FIRE, cursorX, cursorY, 0); // Shows the yellow X and sends the guess
         Serial.print("BLE: Shot sent at: ("); Serial.print(cursorX); Serial.print(", "); Serial.print(cursorY); Serial.println(")");
-        myTurn = false; // Switch turn after shooting
-        updateTurnDisplay();
       }
     }
     lastButtonA = buttonA;
@@ -352,19 +334,308 @@ void loop() {
   }
 }
 
+// Connects to a server found by scanning and caches its address so that
+// later reconnects can skip the scan entirely.
+bool connectToServer(BLEAdvertisedDevice* device) {
+  BLEAddress address = device->getAddress();
+  memcpy(cachedServerAddress, *address.getNative(), sizeof(esp_bd_addr_t));
+  cachedServerAddressType = device->getAddressType();
+  serverAddressCached = true;
+  if (scannedServer == device) scannedServer = nullptr;
+  delete device;
+
+  if (!pClient->connect(address, cachedServerAddressType)) return false;
+  if (attachRemoteCharacteristic()) return true;
+  pClient->disconnect();  // No usable characteristic, don't keep the link
+  return false;
+}
+
+// Starts a direct connect to the cached server address, no scan needed.
+// handleReconnect() polls it and cancels it after DIRECT_CONNECT_TIMEOUT_MS.
+bool startDirectConnect() {
+  if (!serverAddressCached) return false;
+  directConnectState = DIRECT_CONNECT_PENDING;
+  directConnectStartedAt = millis();
+  directConnectCancelled = false;
+  if (xTaskCreate(directConnectTask, "bleDirect", 4096, nullptr, 1, nullptr) != pdPASS) {
+    directConnectState = DIRECT_CONNECT_IDLE;
+    return false;
+  }
+  return true;
+}
+
+// Reports the reconnect time itself: loop() only notices the result on its
+// next pass
+void directConnectTask(void* parameter) {
+  BLEAddress address(cachedServerAddress);
+  Serial.println("BLE: Direct connect to " + String(address.toString().c_str()));
+  bool connected = pClient->connect(address, cachedServerAddressType);
+  if (connected && !attachRemoteCharacteristic()) {
+    Serial.println("BLE: Direct connect found no usable characteristic");
+    pClient->disconnect();
+    connected = false;
+  }
+  if (connected) {
+    Serial.printf("BLE: Reconnected in %lu ms (direct)\n", millis() - disconnectedAt);
+  }
+  directConnectState = connected ? DIRECT_CONNECT_OK : DIRECT_CONNECT_FAILED;
+  vTaskDelete(nullptr);
+}
+
+// Looks up the game characteristic and registers for notifications. The
+// characteristic handle is cached on the first connection; on reconnect it
+// is looked up by handle and only falls back to a UUID lookup if the server's
+// attribute table changed.
+bool attachRemoteCharacteristic() {
+  BLERemoteService* pRemoteService = pClient->getService(SERVICE_UUID);
+  if (!pRemoteService) return false;
+
+  pRemoteCharacteristic = nullptr;
+  if (cachedCharacteristicHandle != 0) {
+    auto characteristics = pRemoteService->getCharacteristicsByHandle();
+    auto it = characteristics->find(cachedCharacteristicHandle);
+    if (it != characteristics->end() && it->second->getUUID().equals(BLEUUID(CHARACTERISTIC_UUID))) {
+      pRemoteCharacteristic = it->second;
+    } else {
+      Serial.println("BLE: Cached characteristic handle is stale");
+    }
+  }
+  if (!pRemoteCharacteristic) {
+    pRemoteCharacteristic = pRemoteService->getCharacteristic(CHARACTERISTIC_UUID);
+  }
+  if (!pRemoteCharacteristic || !pRemoteCharacteristic->canNotify()) return false;
+
+  cachedCharacteristicHandle = pRemoteCharacteristic->getHandle();
+  pRemoteCharacteristic->registerForNotify(notifyCallback);
+  Serial.printf("BLE: Registered for notifications (handle 0x%04X)\n", cachedCharacteristicHandle);
+  return true;
+}
+
+// P2 is connected once the characteristic is attached and subscribed; only
+// then may loop() send on it
+void serverLinkReady() {
+  deviceConnected = true;
+  Serial.println("BLE: Connected to server");
+  drawScreenTextWithBackground("Connected!", TFT_GREEN);
+  postEvent(EVENT_CONNECTED, 0, 0, 0);
+}
+
+// Starts a non-blocking scan; results arrive in MyAdvertisedDeviceCallbacks.
+void startServerScan(int seconds) {
+  if (scannedServer) {
+    delete scannedServer;
+    scannedServer = nullptr;
+  }
+  scanInProgress = true;
+  BLEDevice::getScan()->clearResults();
+  BLEDevice::getScan()->start(seconds, scanCompleteCallback, false);
+}
+
+// Reconnect order for P2: one direct connect to the cached address, then
+// short filtered scans until the server shows up again. Nothing here blocks
+// for longer than a connect to a server that was just seen advertising.
+void handleReconnect() {
+  bool connected = false;
+  if (!directConnectTried) {
+    directConnectTried = true;
+    if (!startDirectConnect()) startServerScan(RECONNECT_SCAN_SECONDS);
+    return;
+  }
+
+  if (directConnectState == DIRECT_CONNECT_OK) {
+    directConnectState = DIRECT_CONNECT_IDLE;
+    if (scanInProgress) BLEDevice::getScan()->stop();
+    connected = true;
+  } else if (directConnectState == DIRECT_CONNECT_FAILED) {
+    directConnectState = DIRECT_CONNECT_IDLE;
+    if (!directConnectCancelled) {
+      Serial.println("BLE: Direct connect failed, scanning");
+      startServerScan(RECONNECT_SCAN_SECONDS);
+    }
+  } else if (directConnectState == DIRECT_CONNECT_PENDING) {
+    if (!directConnectCancelled && millis() - directConnectStartedAt >= DIRECT_CONNECT_TIMEOUT_MS) {
+      // Bluedroid has no public call that cancels a pending GATT open:
+      // esp_ble_gattc_close() needs the connection id that the open hasn't
+      // produced yet. Disconnecting the address is meant to make the stack
+      // fail the open, which returns connect() in the task, but that is not
+      // verified on hardware. If it doesn't, connect() returns at the
+      // stack's own connection timeout. Scan meanwhile; a server found by
+      // the scan waits until the task is done with pClient.
+      directConnectCancelled = true;
+      Serial.println("BLE: Direct connect timed out, scanning");
+      esp_ble_gap_disconnect(cachedServerAddress);
+      startServerScan(RECONNECT_SCAN_SECONDS);
+    }
+    return;
+  }
+
+  if (connected) {
+    // Made by the direct connect, which reported the time
+  } else if (scannedServer) {
+    connected = connectToServer(scannedServer);
+    if (connected) {
+      Serial.printf("BLE: Reconnected in %lu ms (scan)\n", millis() - disconnectedAt);
+    } else {
+      startServerScan(RECONNECT_SCAN_SECONDS);
+    }
+  } else if (!scanInProgress) {
+    startServerScan(RECONNECT_SCAN_SECONDS);
+  }
+
+  if (connected) serverLinkReady();
+}
+
+// Queues an event from a BLE callback; the engine is only touched by loop()
+void postEvent(GameEventType type, uint8_t x, uint8_t y, uint8_t arg) {
+  GameEvent event = {type, x, y, arg, (uint32_t)millis()};
+  if (xQueueSend(eventQueue, &event, 0) != pdTRUE) {
+    Serial.println("GAME: Event queue full, event dropped");
+  }
+}
+
+void postMessage(const uint8_t* data, size_t length) {
+  GameEvent event;
+  if (decodeGameMessage(data, length, millis(), event)) {
+    if (xQueueSend(eventQueue, &event, 0) != pdTRUE) {
+      Serial.println("GAME: Event queue full, message dropped");
+    }
+  } else {
+    Serial.println("BLE: Ignoring unknown message " + String((const char*)data, length));
+  }
+}
+
+// Applies one event to the engine and carries out its effects
+void applyEvent(const GameEvent& event) {
+  bool wasSyncing = game.syncing();
+  GameEffects effects = game.apply(event);
+  if (effects.violation) {
+    Serial.printf("GAME: Rejected event %d (%d, %d): %s\n", event.type, event.x, event.y, effects.violation);
+    printGameLog();
+    return;
+  }
+
+  for (int i = 0; i < effects.messageCount; i++) {
+    sendMessage(effects.messages[i]);
+  }
+
+  // A held sync is stale once its link is gone or the engine gave up on the
+  // exchange
+  if (event.type == EVENT_DISCONNECTED || (event.type == EVENT_TIMER && wasSyncing && !game.syncing())) {
+    syncPending = false;
+  }
+
+  if (event.type == EVENT_RECV_RESULT) {
+    Serial.print("BLE: Shot confirmed at: ("); Serial.print(event.x); Serial.print(", "); Serial.print(event.y);
+    Serial.print(") - "); Serial.println(event.arg ? "Hit" : "Miss");
+  }
+
+  if (!gridDrawn || game.phase() < PHASE_PLAYING) return;
+  if (event.type == EVENT_CONNECTED || event.type == EVENT_RECV_SYNC) {
+    // The connection screens drew over the board, and a sync may resolve or
+    // take back the pending shot
+    drawInitialGrid();
+    updateCursor();
+    updateTurnDisplay();
+  } else {
+    if (effects.shotCellX >= 0) updateCell(effects.shotCellX, effects.shotCellY);
+    if (effects.turnChanged || effects.phaseChanged) updateTurnDisplay();
+  }
+  if (effects.phaseChanged && game.phase() == PHASE_OVER) printGameLog();
+
+  // Turn latency, measured once the result is on screen
+  if (event.type == EVENT_FIRE) {
+    shotSentAt = event.timeMs;
+  } else if (event.type == EVENT_RECV_RESULT && shotSentAt) {
+    Serial.printf("GAME: Shot round trip %lu ms\n", millis() - shotSentAt);
+    shotSentAt = 0;
+  } else if (event.type == EVENT_RECV_GUESS) {
+    Serial.printf("GAME: Opponent shot answered and drawn in %lu ms\n", millis() - event.timeMs);
+  }
+}
+
+void dispatch(GameEventType type, uint8_t x, uint8_t y, uint8_t arg) {
+  GameEvent event = {type, x, y, arg, (uint32_t)millis()};
+  applyEvent(event);
+}
+
+// Drains queued BLE events and fires the periodic timer event
+void processEvents() {
+  GameEvent event;
+  while (xQueueReceive(eventQueue, &event, 0) == pdTRUE) {
+    applyEvent(event);
+  }
+  if (millis() - lastTimerEvent >= TIMER_EVENT_MS) {
+    lastTimerEvent = millis();
+    dispatch(EVENT_TIMER, 0, 0, 0);
+  }
+  sendPendingSync();
+}
+
+// Negotiated ATT MTU of the current link, 23 until the exchange completes
+uint16_t currentMtu() {
+  if (isPlayer1) return pServer ? pServer->getPeerMTU(pServer->getConnId()) : 23;
+  return pClient ? pClient->getMTU() : 23;
+}
+
+void sendMessage(const GameMessage& message) {
+  char data[SYNC_MESSAGE_SIZE + 1];
+  size_t length = encodeGameMessage(message, data, sizeof(data));
+  if (message.type == MSG_SYNC && currentMtu() < SYNC_MESSAGE_SIZE + 3) {
+    // Sent by sendPendingSync() once the MTU exchange completes; if it
+    // never does, the opponent stops waiting after SYNC_TIMEOUT_MS
+    Serial.printf("BLE: MTU %u too small for board sync, waiting for the exchange\n", currentMtu());
+    pendingSync = message;
+    syncPending = true;
+    return;
+  }
+
+  if (isPlayer1 && pCharacteristic) {
+    pCharacteristic->setValue((uint8_t*)data, length);
+    pCharacteristic->notify();
+  } else if (!isPlayer1 && pRemoteCharacteristic && deviceConnected) {
+    pRemoteCharacteristic->writeValue((uint8_t*)data, length);
+  } else {
+    return;
+  }
+
+  if (message.type == MSG_SYNC) {
+    Serial.printf("BLE: Sent board sync (%u bytes, MTU %u)\n", (unsigned)length, currentMtu());
+  } else {
+    Serial.println("BLE: Sent " + String(data));
+  }
+}
+
+// Sends the board sync held back by sendMessage() once the MTU allows it
+void sendPendingSync() {
+  if (!syncPending || !deviceConnected || currentMtu() < SYNC_MESSAGE_SIZE + 3) return;
+  syncPending = false;
+  sendMessage(pendingSync);
+}
+
+// Hex dump of the event log; load it into a GameLog to replay the game
+void printGameLog() {
+  Serial.printf("GAME: Log (%u bytes%s):\n", (unsigned)gameLog.size(), gameLog.overflowed() ? ", truncated" : "");
+  for (size_t i = 0; i < gameLog.size(); i++) {
+    Serial.printf("%02X", gameLog.data()[i]);
+    if (i % 32 == 31) Serial.println();
+  }
+  Serial.println();
+}
+
 void drawInitialGrid() {
   M5.Lcd.fillScreen(BLACK);
   for (int i = 0; i < GRID_SIZE; i++) {
     for (int j = 0; j < GRID_SIZE; j++) {
       int x = j * CELL_SIZE;
       int y = i * CELL_SIZE;
+      char cell = game.shotCell(j, i);
       M5.Lcd.drawRect(x, y, CELL_SIZE, CELL_SIZE, WHITE);
-      if (grid[i][j] == 'X') {
+      if (cell == 'X') {
         M5.Lcd.drawLine(x + 5, y + 5, x + CELL_SIZE - 5, y + CELL_SIZE - 5, YELLOW);
         M5.Lcd.drawLine(x + CELL_SIZE - 5, y + 5, x + 5, y + CELL_SIZE - 5, YELLOW);
-      } else if (grid[i][j] == 'H') {
+      } else if (cell == 'H') {
         M5.Lcd.fillRect(x + 5, y + 5, CELL_SIZE - 10, CELL_SIZE - 10, RED);
-      } else if (grid[i][j] == 'O') {
+      } else if (cell == 'O') {
         M5.Lcd.fillCircle(x + CELL_SIZE / 2, y + CELL_SIZE / 2, CELL_SIZE / 4, WHITE);
       }
     }
@@ -375,21 +646,18 @@ void drawInitialGrid() {
 void updateCell(int x, int y) {
   int pixelX = x * CELL_SIZE;
   int pixelY = y * CELL_SIZE;
+  char cell = game.shotCell(x, y);
   M5.Lcd.fillRect(pixelX + 1, pixelY + 1, CELL_SIZE - 2, CELL_SIZE - 2, BLACK);
   M5.Lcd.drawRect(pixelX, pixelY, CELL_SIZE, CELL_SIZE, WHITE);
 
-  if (grid[y][x] == 'X') {
+  if (cell == 'X') {
     M5.Lcd.drawLine(pixelX + 5, pixelY + 5, pixelX + CELL_SIZE - 5, pixelY + CELL_SIZE - 5, YELLOW);
     M5.Lcd.drawLine(pixelX + CELL_SIZE - 5, pixelY + 5, pixelX + 5, pixelY + CELL_SIZE - 5, YELLOW);
-  } else if (grid[y][x] == 'H') {
+  } else if (cell == 'H') {
     M5.Lcd.fillRect(pixelX + 5, pixelY + 5, CELL_SIZE - 10, CELL_SIZE - 10, RED);
-  } else if (grid[y][x] == 'O') {
+  } else if (cell == 'O') {
     M5.Lcd.fillCircle(pixelX + CELL_SIZE / 2, pixelY + CELL_SIZE / 2, CELL_SIZE / 4, WHITE);
   }
-
-  if (gameOver) {
-    updateTurnDisplay(); // Ensure only "You Win!" or "You Lose!" is shown
-  }
 }
 
 void updateCursor() {
@@ -406,59 +674,23 @@ void updateCursor() {
   lastCursorY = cursorY;
 }
 
-bool canPlaceShip(int x, int y, int len, int dir) {
-  if (dir == 0) {
-    if (x + len > GRID_SIZE) return false;
-    for (int i = 0; i < len; i++) {
-      if (hiddenGrid[y][x + i] != ' ') return false;
-    }
-  } else {
-    if (y + len > GRID_SIZE) return false;
-    for (int i = 0; i < len; i++) {
-      if (hiddenGrid[y + i][x] != ' ') return false;
-    }
-  }
-  return true;
-}
-
-char checkHit(int x, int y) {
-  for (int i = 0; i < NUM_SHIPS; i++) {
-    Ship ship = placedShips[i];
-    if (ship.horizontal) {
-      if (y == ship.y && x >= ship.x && x < ship.x + ship.length) return 'X';
-    } else {
-      if (x == ship.x && y >= ship.y && y < ship.y + ship.length) return 'X';
-    }
-  }
-  return 'O';
-}
-
-void sendMove(int x, int y, char result) {
-  String guessData = "GUESS:" + String(x) + "," + String(y);
-  if (isPlayer1 && pCharacteristic) {
-    pCharacteristic->setValue(guessData.c_str());
-    pCharacteristic->notify();
-    Serial.println("BLE: Sent guess: " + guessData);
-  } else if (pRemoteCharacteristic) {
-    pRemoteCharacteristic->writeValue(guessData.c_str());
-    Serial.println("BLE: Sent guess: " + guessData);
-  }
-}
-
 void placeShipsScreen() {
   M5.Lcd.fillScreen(BLACK);
   drawInitialGrid();
 
-  int currentShip = 0;
   int shipX = 0, shipY = 0;
   bool horizontal = true;
 
-  while (currentShip < NUM_SHIPS) {
+  while (game.shipsPlaced() < GAME_NUM_SHIPS) {
     M5.update();
+    processEvents();
+
+    int currentShip = game.shipsPlaced();
+    int shipSize = GAME_SHIP_SIZES[currentShip];
 
     for (int y = 0; y < GRID_SIZE; y++) {
       for (int x = 0; x < GRID_SIZE; x++) {
-        if (hiddenGrid[y][x] == 'S') {
+        if (game.ownCell(x, y) == 'S') {
           M5.Lcd.fillRect(x * CELL_SIZE + 5, y * CELL_SIZE + 5,
                           CELL_SIZE - 10, CELL_SIZE - 10, RED);
         }
@@ -469,10 +701,10 @@ void placeShipsScreen() {
     M5.Lcd.setTextColor(WHITE);
     M5.Lcd.setCursor(10, GRID_SIZE * CELL_SIZE + 10);
     M5.Lcd.printf("Place ship %d (size %d) - A to confirm, B to rotate",
-                  currentShip + 1, ships[currentShip]);
+                  currentShip + 1, shipSize);
 
-    bool canPlace = canPlaceShip(shipX, shipY, ships[currentShip], horizontal ? 0 : 1);
-    for (int i = 0; i < ships[currentShip]; i++) {
+    bool canPlace = game.canPlaceShip(shipX, shipY, shipSize, horizontal);
+    for (int i = 0; i < shipSize; i++) {
       int previewX = horizontal ? shipX + i : shipX;
       int previewY = horizontal ? shipY : shipY + i;
       if (previewX < GRID_SIZE && previewY < GRID_SIZE && canPlace) {
@@ -489,9 +721,9 @@ void placeShipsScreen() {
 
     int newShipX = shipX;
     int newShipY = shipY;
-    if (joyX > 512 + 100) newShipX = min(shipX + 1, GRID_SIZE - (horizontal ? ships[currentShip] : 1));
+    if (joyX > 512 + 100) newShipX = min(shipX + 1, GRID_SIZE - (horizontal ? shipSize : 1));
     else if (joyX < 512 - 100) newShipX = max(shipX - 1, 0);
-    if (joyY < 512 - 100) newShipY = min(shipY + 1, GRID_SIZE - (horizontal ? 1 : ships[currentShip]));
+    if (joyY < 512 - 100) newShipY = min(shipY + 1, GRID_SIZE - (horizontal ? 1 : shipSize));
     else if (joyY > 512 + 100) newShipY = max(shipY - 1, 0);
 
     if (newShipX != shipX || newShipY != shipY) {
@@ -502,32 +734,24 @@ void placeShipsScreen() {
 
     if (M5.Touch.getCount() > 0) {
       auto touch = M5.Touch.getDetail(0);
-      shipX = constrain(touch.x / CELL_SIZE, 0, GRID_SIZE - (horizontal ? ships[currentShip] : 1));
-      shipY = constrain(touch.y / CELL_SIZE, 0, GRID_SIZE - (horizontal ? 1 : ships[currentShip]));
+      shipX = constrain(touch.x / CELL_SIZE, 0, GRID_SIZE - (horizontal ? shipSize : 1));
+      shipY = constrain(touch.y / CELL_SIZE, 0, GRID_SIZE - (horizontal ? 1 : shipSize));
       drawInitialGrid();
     }
 
     static bool lastButtonB = false;
     if (buttonB && !lastButtonB) {
       horizontal = !horizontal;
-      if (horizontal && shipX + ships[currentShip] > GRID_SIZE) shipX = GRID_SIZE - ships[currentShip];
-      if (!horizontal && shipY + ships[currentShip] > GRID_SIZE) shipY = GRID_SIZE - ships[currentShip];
+      if (horizontal && shipX + shipSize > GRID_SIZE) shipX = GRID_SIZE - shipSize;
+      if (!horizontal && shipY + shipSize > GRID_SIZE) shipY = GRID_SIZE - shipSize;
       drawInitialGrid();
       delay(200);
     }
     lastButtonB = buttonB;
 
-    if (buttonA && canPlaceShip(shipX, shipY, ships[currentShip], horizontal ? 0 : 1)) {
-      for (int i = 0; i < ships[currentShip]; i++) {
-        if (horizontal) hiddenGrid[shipY][shipX + i] = 'S';
-        else hiddenGrid[shipY + i][shipX] = 'S';
-      }
-      placedShips[currentShip].x = shipX;
-      placedShips[currentShip].y = shipY;
-      placedShips[currentShip].length = ships[currentShip];
-      placedShips[currentShip].horizontal = horizontal;
-
-      currentShip++;
+    if (buttonA && canPlace) {
+      // Sends READY once the last ship is placed
+      dispatch(EVENT_PLACE_SHIP, shipX, shipY, horizontal);
       shipX = 0;
       shipY = 0;
       horizontal = true;
@@ -539,23 +763,12 @@ void placeShipsScreen() {
   }
 
   M5.Lcd.fillRect(0, GRID_SIZE * CELL_SIZE, M5.Lcd.width(), M5.Lcd.height() - GRID_SIZE * CELL_SIZE, BLACK);
-
-  if (deviceConnected) {
-    if (isPlayer1 && pCharacteristic) {
-      pCharacteristic->setValue("READY");
-      pCharacteristic->notify();
-      Serial.println("BLE: Sent READY to opponent");
-    } else if (pRemoteCharacteristic) {
-      pRemoteCharacteristic->writeValue("READY");
-      Serial.println("BLE: Sent READY to opponent");
-    }
-    localReady = true;
-  }
 }
 
 void waitForOpponentScreen() {
   drawScreenTextWithBackground("Waiting for opponent...", TFT_CYAN);
-  while (!(localReady && opponentReady)) {
+  while (game.phase() < PHASE_PLAYING) {
+    processEvents();
     delay(100);
   }
   M5.Lcd.fillScreen(BLACK);
@@ -572,11 +785,11 @@ void updateTurnDisplay() {
   M5.Lcd.setTextSize(2);
   M5.Lcd.setCursor(10, GRID_SIZE * CELL_SIZE + 10);
 
-  if (gameOver) {
-    M5.Lcd.setTextColor(GREEN);
-    M5.Lcd.print(isPlayer1 ? "You Lose!" : "You Win!"); // Fixed: P2 (isPlayer1 = false) wins, P1 loses
+  if (game.phase() == PHASE_OVER) {
+    M5.Lcd.setTextColor(game.won() ? GREEN : RED);
+    M5.Lcd.print(game.won() ? "You Win!" : "You Lose!");
   } else {
-    if (myTurn) {
+    if (game.myTurn()) {
       M5.Lcd.setTextColor(GREEN);
       M5.Lcd.print("Your Turn!");
     } else {
@@ -0,0 +1,258 @@
+// Host simulation of two GameEngines playing each other.
+//
+// Each player has an engine and an inbox. Messages an engine produces are
+// encoded to the BLE wire format, decoded again and queued for the other
+// player, which picks them up at random times between its own inputs, timer
+// ticks and link drops (both sides disconnect, messages in flight are lost,
+// both reconnect). Every game is checked for:
+//   - events the engine rejects (GameEffects::violation)
+//   - both players holding the turn with no message in flight
+//   - games that don't finish (deadlock, livelock)
+//   - a winner count other than one
+//   - a replay of the recorded log that doesn't rebuild the final state
+// Before the random games, a fixed case drops the link with a shot in flight,
+// once losing the GUESS and once the RESULT, and the board syncs must bring
+// the two diverged logs back to one game.
+//
+// Usage: game_sim [games] [seed]
+
+#include "GameCore.h"
+
+#include <chrono>
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+
+const int MAX_STEPS = 100000;  // A game that takes longer is stuck
+
+struct Player {
+  GameLog log;
+  GameEngine engine;
+  std::deque<GameEvent> inbox;
+
+  explicit Player(bool isPlayer1) : engine(isPlayer1, &log) {}
+};
+
+struct Simulation {
+  Player* players[2];
+  uint32_t nowMs = 0;
+  uint32_t rng;
+  const char* failure = nullptr;
+
+  uint32_t random(uint32_t n) {
+    rng = rng * 1103515245 + 12345;
+    return (rng >> 8) % n;
+  }
+
+  void apply(int side, GameEventType type, uint8_t x = 0, uint8_t y = 0, uint8_t arg = 0) {
+    GameEvent event = {};
+    event.type = type;
+    event.x = x;
+    event.y = y;
+    event.arg = arg;
+    apply(side, event);
+  }
+
+  void apply(int side, GameEvent event) {
+    event.timeMs = nowMs;
+    GameEffects effects = players[side]->engine.apply(event);
+    if (effects.violation) {
+      printf("player %d rejected event %d: %s\n", side + 1, event.type, effects.violation);
+      failure = "rule violation";
+    }
+    for (int i = 0; i < effects.messageCount; i++) {
+      char buffer[64];
+      size_t length = encodeGameMessage(effects.messages[i], buffer, sizeof(buffer));
+      GameEvent received;
+      if (!decodeGameMessage((const uint8_t*)buffer, length, nowMs, received)) {
+        failure = "message does not decode";
+        return;
+      }
+      players[1 - side]->inbox.push_back(received);
+    }
+  }
+
+  // Applies the next message queued for a player, if any
+  bool deliver(int side) {
+    if (players[side]->inbox.empty()) return false;
+    GameEvent event = players[side]->inbox.front();
+    players[side]->inbox.pop_front();
+    apply(side, event);
+    return true;
+  }
+
+  void deliverAll() {
+    while (deliver(0) || deliver(1)) {
+    }
+  }
+
+  void dropLink() {
+    apply(0, EVENT_DISCONNECTED);
+    apply(1, EVENT_DISCONNECTED);
+    players[0]->inbox.clear();
+    players[1]->inbox.clear();
+    apply(0, EVENT_CONNECTED);
+    apply(1, EVENT_CONNECTED);
+  }
+
+  // One random step of one player
+  void step() {
+    nowMs += random(50);
+    int side = random(2);
+    Player& me = *players[side];
+    GameEngine& engine = me.engine;
+    uint32_t action = random(10);
+
+    if (action < 3 && !me.inbox.empty()) {
+      GameEvent event = me.inbox.front();
+      me.inbox.pop_front();
+      apply(side, event);
+    } else if (action < 5 && engine.phase() == PHASE_PLACING) {
+      int x = random(GAME_GRID_SIZE), y = random(GAME_GRID_SIZE), horizontal = random(2);
+      if (engine.canPlaceShip(x, y, GAME_SHIP_SIZES[engine.shipsPlaced()], horizontal)) {
+        apply(side, EVENT_PLACE_SHIP, x, y, horizontal);
+      }
+    } else if (action < 7 && engine.phase() == PHASE_PLAYING && engine.myTurn() && !engine.syncing()) {
+      int x, y;
+      do {
+        x = random(GAME_GRID_SIZE);
+        y = random(GAME_GRID_SIZE);
+      } while (engine.shotCell(x, y) != ' ');
+      apply(side, EVENT_FIRE, x, y);
+    } else if (action == 7) {
+      apply(side, EVENT_TIMER);
+    } else if (action == 8 && random(20) == 0) {
+      dropLink();
+    }
+  }
+
+  bool bothOver() const {
+    return players[0]->engine.phase() == PHASE_OVER && players[1]->engine.phase() == PHASE_OVER;
+  }
+
+  // With nothing in flight only one player may hold the turn
+  void checkTurnOrder() {
+    const GameEngine& a = players[0]->engine;
+    const GameEngine& b = players[1]->engine;
+    if (players[0]->inbox.empty() && players[1]->inbox.empty() &&
+        a.phase() == PHASE_PLAYING && b.phase() == PHASE_PLAYING &&
+        a.myTurn() && b.myTurn()) {
+      failure = "both players hold the turn";
+    }
+  }
+};
+
+static bool sameState(const GameEngine& a, const GameEngine& b) {
+  if (a.phase() != b.phase() || a.myTurn() != b.myTurn() || a.hitCount() != b.hitCount() ||
+      a.hitsTakenCount() != b.hitsTakenCount() || a.shipsPlaced() != b.shipsPlaced()) {
+    return false;
+  }
+  for (int y = 0; y < GAME_GRID_SIZE; y++) {
+    for (int x = 0; x < GAME_GRID_SIZE; x++) {
+      if (a.shotCell(x, y) != b.shotCell(x, y) || a.ownCell(x, y) != b.ownCell(x, y)) return false;
+    }
+  }
+  return true;
+}
+
+static const char* checkReplay(const Player& player) {
+  if (player.log.overflowed()) return nullptr;
+  GameEngine replayed(player.log.isPlayer1());
+  if (!GameEngine::replay(player.log, replayed)) return "log does not replay";
+  if (!sameState(replayed, player.engine)) return "replay differs";
+  return nullptr;
+}
+
+// P1 fires at P2's first ship and the link drops before the GUESS arrives
+// (the shot is taken back, P1 keeps the turn) or after P2 answered it but
+// before the RESULT arrives (P1 takes the hit from P2's sync, P2 gets the
+// turn). Returns nullptr or what went wrong.
+static const char* checkReconcile(bool resultLost) {
+  Player player1(true), player2(false);
+  Simulation sim;
+  sim.players[0] = &player1;
+  sim.players[1] = &player2;
+  sim.rng = 1;
+
+  sim.apply(0, EVENT_CONNECTED);
+  sim.apply(1, EVENT_CONNECTED);
+  sim.deliverAll();
+  for (int side = 0; side < 2; side++) {
+    for (int i = 0; i < GAME_NUM_SHIPS; i++) sim.apply(side, EVENT_PLACE_SHIP, 0, i, 1);
+  }
+  sim.deliverAll();
+  if (player1.engine.phase() != PHASE_PLAYING || !player1.engine.myTurn()) return "game did not start";
+
+  sim.apply(0, EVENT_FIRE, 0, 0);
+  if (resultLost && !sim.deliver(1)) return "no GUESS in flight";
+  sim.dropLink();
+  sim.deliverAll();
+  if (sim.failure) return sim.failure;
+
+  const GameEngine& a = player1.engine;
+  const GameEngine& b = player2.engine;
+  if (a.syncing() || b.syncing()) return "still syncing";
+  if (resultLost) {
+    if (a.shotCell(0, 0) != 'H' || a.hitCount() != 1) return "answered shot not recovered";
+    if (b.ownCell(0, 0) != 'X' || a.myTurn() || !b.myTurn()) return "turn not passed to P2";
+  } else {
+    if (a.shotCell(0, 0) != ' ' || b.ownCell(0, 0) != 'S') return "lost shot not taken back";
+    if (!a.myTurn() || b.myTurn()) return "turn not kept by P1";
+  }
+
+  const char* failure = checkReplay(player1);
+  return failure ? failure : checkReplay(player2);
+}
+
+// Plays one game, returns nullptr or what went wrong
+static const char* playGame(uint32_t seed, int& steps) {
+  Player player1(true), player2(false);
+  Simulation sim;
+  sim.players[0] = &player1;
+  sim.players[1] = &player2;
+  sim.rng = seed;
+
+  sim.apply(0, EVENT_CONNECTED);
+  sim.apply(1, EVENT_CONNECTED);
+  for (steps = 0; !sim.bothOver() && !sim.failure; steps++) {
+    if (steps == MAX_STEPS) return "game never ends";
+    sim.step();
+    sim.checkTurnOrder();
+  }
+  if (sim.failure) return sim.failure;
+
+  if (player1.engine.won() == player2.engine.won()) return "not exactly one winner";
+
+  const char* failure = checkReplay(player1);
+  return failure ? failure : checkReplay(player2);
+}
+
+int main(int argc, char** argv) {
+  int games = argc > 1 ? atoi(argv[1]) : 10000;
+  uint32_t seed = argc > 2 ? strtoul(argv[2], nullptr, 0) : 1;
+
+  for (int resultLost = 0; resultLost < 2; resultLost++) {
+    const char* failure = checkReconcile(resultLost);
+    if (failure) {
+      printf("reconcile with the %s lost failed: %s\n", resultLost ? "RESULT" : "GUESS", failure);
+      return 1;
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  long totalSteps = 0;
+  for (int game = 0; game < games; game++) {
+    int steps = 0;
+    uint32_t gameSeed = seed * 2654435761u + game;
+    const char* failure = playGame(gameSeed, steps);
+    totalSteps += steps;
+    if (failure) {
+      printf("game %d (seed %u) failed after %d steps: %s\n", game, gameSeed, steps, failure);
+      return 1;
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%d games, %.0f steps per game, %.2f s (%.0f games/s), no violations\n",
+         games, (double)totalSteps / games, seconds, games / seconds);
+  return 0;
+}
@@ -0,0 +1,53 @@
+// Header File
+
+#ifndef NUMERIC_DISPLAY_H
+#define NUMERIC_DISPLAY_H
+
+// Includes
+#include <M5Unified.h>
+
+// A number drawn from pre-rendered characters. The characters of the
+// charset are rendered once into an atlas sprite for a text size and
+// colors, and print() copies one atlas cell per character that changed
+// since the last call, instead of drawing the scaled font again.
+class NumericDisplay
+{
+    public:
+        static const int MAX_CHARS = 16;
+
+        // Members
+        static uint32_t cellsDrawn;    // Cells sent to the display
+        static uint32_t cellsSkipped;  // Cells left alone because they did not change
+
+        NumericDisplay(const char *charset);
+        ~NumericDisplay();
+
+        // Setup methods
+        bool begin(M5GFX *display, uint8_t textSize, uint16_t textColor, uint16_t bgColor);
+        void setPosition(int x, int y);
+        void invalidate();
+        int width(int chars);
+
+        // Drawing methods
+        void print(const char *text);
+        void printf(const char *format, ...);
+
+    private:
+        const char *charset;
+        M5GFX *display = nullptr;
+        M5Canvas atlas;
+        bool atlasReady = false;
+        uint8_t textSize = 0;
+        uint16_t textColor = 0;
+        uint16_t bgColor = 0;
+        int cellWidth = 0;
+        int cellHeight = 0;
+        int x = 0;
+        int y = 0;
+        bool dirty = true;
+        char shown[MAX_CHARS + 1] = "";
+
+        void drawCell(char c, int cellX);
+};
+
+#endif
@@ -0,0 +1,132 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Parses and destroys a current-weather reply with the default allocator and
+// with an ArenaAllocator, then rebuilds it many times while the program keeps
+// a few small blocks of its own, and reports how much the heap grew and how
+// much of it was left free between live blocks. The heap figures come from
+// mallinfo2(), so that part needs glibc.
+
+#include <ArduinoJson.h>
+
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#  include <malloc.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#  define HAS_MALLINFO2 1
+#else
+#  define HAS_MALLINFO2 0
+#endif
+
+#include "Bench.hpp"
+
+// About 600 bytes, like the OpenWeatherMap reply the weather sketch fetches
+static const char reply[] =
+    "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},\"weather\":[{\"id\":804,"
+    "\"main\":\"Clouds\",\"description\":\"overcast clouds\",\"icon\":\"04d\"}"
+    "],\"base\":\"stations\",\"main\":{\"temp\":281.52,\"feels_like\":278.99,"
+    "\"temp_min\":280.15,\"temp_max\":282.71,\"pressure\":1012,\"humidity\":"
+    "81,\"sea_level\":1012,\"grnd_level\":1008},\"visibility\":10000,\"wind\":"
+    "{\"speed\":4.12,\"deg\":230,\"gust\":7.2},\"clouds\":{\"all\":100},\"dt\":"
+    "1710000000,\"sys\":{\"type\":2,\"id\":2075535,\"country\":\"GB\","
+    "\"sunrise\":1709965871,\"sunset\":1710007467},\"timezone\":0,\"id\":"
+    "2643743,\"name\":\"London\",\"cod\":200}";
+
+static char arenaBuffer[8192];
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    fprintf(stderr, "%s: wrong result\n", what);
+    exit(1);
+  }
+}
+
+static double parseAndDestroy(Allocator* allocator, int iterations) {
+  Stopwatch time;
+  for (int i = 0; i < iterations; i++) {
+    JsonDocument doc(allocator);
+    deserializeJson(doc, reply);
+    doNotOptimize(doc["main"]["temp"].as<float>());
+  }
+  return time.seconds() * 1e6 / iterations;
+}
+
+#if HAS_MALLINFO2
+struct HeapUsage {
+  size_t size;      // obtained from the system
+  size_t stranded;  // free, but below the top of the heap
+};
+
+static HeapUsage heapUsage() {
+  struct mallinfo2 info = mallinfo2();
+  return {info.arena + info.hblkhd, info.fordblks - info.keepcost};
+}
+
+// Every rebuild is followed by a small allocation that outlives it, like a
+// String the sketch keeps, so the next document has to go around it. Runs in
+// a child process, so that each allocator starts from the same heap.
+static void rebuild(Allocator* allocator, ArenaAllocator* arena, int rounds,
+                    const char* name) {
+  fflush(stdout);
+  pid_t child = fork();
+  if (child > 0) {
+    int status;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, name);
+    return;
+  }
+  std::vector<void*> kept;
+  kept.reserve(size_t(rounds));
+  HeapUsage before = heapUsage();
+  size_t keptBytes = 0;
+
+  for (int i = 0; i < rounds; i++) {
+    if (arena)
+      arena->reset();
+    JsonDocument doc(allocator);
+    check(deserializeJson(doc, reply) == DeserializationError::Ok, name);
+    check(doc["name"] == "London", name);
+    size_t n = 16 + size_t(i % 4) * 8;
+    kept.push_back(malloc(n));
+    keptBytes += n;
+  }
+
+  HeapUsage after = heapUsage();
+  printf("  %-8s heap %+5ld KB for %4zu KB kept, %+4ld KB stranded\n", name,
+         (long(after.size) - long(before.size)) / 1024, keptBytes / 1024,
+         (long(after.stranded) - long(before.stranded)) / 1024);
+  fflush(stdout);
+  _exit(0);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 100000);
+  ArenaAllocator arena(arenaBuffer, sizeof(arenaBuffer));
+
+  {
+    JsonDocument doc(&arena);
+    check(deserializeJson(doc, reply) == DeserializationError::Ok, "arena");
+    check(doc["weather"][0]["icon"] == "04d", "arena");
+  }
+  check(arena.used() == 0, "arena");
+
+  printf("parse + destroy, %zu-byte reply\n", sizeof(reply) - 1);
+  printf("  %-8s %6.2f us\n", "malloc",
+         parseAndDestroy(detail::DefaultAllocator::instance(), iterations));
+  printf("  %-8s %6.2f us (peak %zu bytes)\n", "arena",
+         parseAndDestroy(&arena, iterations), arena.highWaterMark());
+
+#if HAS_MALLINFO2
+  int rounds = iterations < 5000 ? iterations : 5000;
+  printf("%d rebuilds with long-lived blocks in between\n", rounds);
+  rebuild(detail::DefaultAllocator::instance(), nullptr, rounds, "malloc");
+  rebuild(&arena, &arena, rounds, "arena");
+#endif
+  return 0;
+}
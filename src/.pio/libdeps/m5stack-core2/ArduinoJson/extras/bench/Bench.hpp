@@ -0,0 +1,34 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <chrono>
+#include <stdlib.h>
+
+// Iteration count from the command line, so that CTest can run a benchmark
+// once as a smoke test.
+inline int benchIterations(int argc, char* argv[], int defaultValue) {
+  return argc > 1 ? atoi(argv[1]) : defaultValue;
+}
+
+class Stopwatch {
+ public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+  double seconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start_)
+        .count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Keeps the optimizer from discarding a result.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
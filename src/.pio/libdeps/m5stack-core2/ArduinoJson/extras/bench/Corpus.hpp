@@ -0,0 +1,68 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+
+// Synthetic corpora shaped like the payloads the examples fetch. They are
+// generated rather than stored so that the benchmarks have no data files.
+
+// A pretty-printed forecast, like the 5-day/3-hour OpenWeatherMap reply:
+// an array of records that mix short keys, free text, and numbers.
+inline std::string makeForecastCorpus(int records) {
+  std::string json = "{\n  \"cod\": \"200\",\n  \"list\": [\n";
+  char buffer[512];
+  for (int i = 0; i < records; i++) {
+    snprintf(buffer, sizeof(buffer),
+             "    {\n"
+             "      \"dt\": %d,\n"
+             "      \"main\": {\"temp\": %.2f, \"feels_like\": %.2f, "
+             "\"pressure\": %d, \"humidity\": %d},\n"
+             "      \"weather\": [{\"id\": 80%d, \"main\": \"Clouds\", "
+             "\"description\": \"overcast clouds, light rain in the "
+             "afternoon\", \"icon\": \"04d\"}],\n"
+             "      \"wind\": {\"speed\": %.2f, \"deg\": %d},\n"
+             "      \"dt_txt\": \"2024-03-%02d %02d:00:00\"\n"
+             "    }%s\n",
+             1710000000 + i * 10800, 280.0 + (i % 97) * 0.37,
+             279.0 + (i % 89) * 0.41, 990 + i % 40, 40 + i % 60, i % 5,
+             (i % 150) * 0.13, (i * 37) % 360, 1 + (i / 8) % 5, (i % 8) * 3,
+             i + 1 < records ? "," : "");
+    json += buffer;
+  }
+  json += "  ],\n  \"city\": {\"name\": \"London\", \"country\": \"GB\"}\n}";
+  return json;
+}
+
+// A compact array of numbers as a telemetry device would send them.
+inline std::string makeNumbersCorpus(int count, unsigned seed = 1) {
+  std::string json = "[";
+  char buffer[32];
+  for (int i = 0; i < count; i++) {
+    seed = seed * 1103515245 + 12345;
+    unsigned r = seed >> 8;
+    switch (i % 4) {
+      case 0:
+        snprintf(buffer, sizeof(buffer), "%.6f",
+                 (int(r % 2000000) - 1000000) / 3e3);
+        break;
+      case 1:
+        snprintf(buffer, sizeof(buffer), "%.17g", r / 3.3e5);
+        break;
+      case 2:
+        snprintf(buffer, sizeof(buffer), "%u", r % 2000000000);
+        break;
+      default:
+        snprintf(buffer, sizeof(buffer), "%.2f", (r % 20000) / 7.0);
+        break;
+    }
+    if (i)
+      json += ',';
+    json += buffer;
+  }
+  json += ']';
+  return json;
+}
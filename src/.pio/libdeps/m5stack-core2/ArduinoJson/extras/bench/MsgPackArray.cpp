@@ -0,0 +1,99 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Encodes and decodes 1000 telemetry samples, as float and as int16_t
+// hundredths: through a JsonDocument, with serializeMsgPackArray(), and with
+// its packed format. Reports the time, the heap, and the size of each.
+
+#include <ArduinoJson.h>
+
+#include <math.h>
+#include <vector>
+
+#include "Allocators.hpp"
+#include "Bench.hpp"
+
+static const size_t sampleCount = 1000;
+
+template <typename T>
+static void bench(const char* name, const std::vector<T>& samples,
+                  int iterations) {
+  std::vector<uint8_t> buffer(16384);
+  std::vector<T> decoded(sampleCount);
+  size_t count;
+
+  size_t documentSize = 0, serializePeak = 0, deserializePeak = 0;
+  Stopwatch serializeTime;
+  for (int i = 0; i < iterations; i++) {
+    CountingAllocator allocator;
+    JsonDocument doc(&allocator);
+    JsonArray array = doc.to<JsonArray>();
+    for (T x : samples)
+      array.add(x);
+    documentSize = serializeMsgPack(doc, buffer.data(), buffer.size());
+    serializePeak = allocator.peakBytes();
+  }
+  double serialize = serializeTime.seconds();
+
+  Stopwatch deserializeTime;
+  for (int i = 0; i < iterations; i++) {
+    CountingAllocator allocator;
+    JsonDocument doc(&allocator);
+    deserializeMsgPack(doc, buffer.data(), documentSize);
+    size_t j = 0;
+    for (JsonVariant x : doc.as<JsonArray>())
+      decoded[j++] = x.as<T>();
+    deserializePeak = allocator.peakBytes();
+  }
+  double deserialize = deserializeTime.seconds();
+
+  printf("%s x%zu\n", name, sampleCount);
+  printf("  %-8s ser %6.1f us (heap %6zu) deser %6.1f us (heap %6zu) %5zu B\n",
+         "document", serialize * 1e6 / iterations, serializePeak,
+         deserialize * 1e6 / iterations, deserializePeak, documentSize);
+
+  const MsgPackArrayFormat formats[] = {MsgPackArrayFormat::Array,
+                                        MsgPackArrayFormat::Packed};
+  const char* formatNames[] = {"array", "packed"};
+  for (int f = 0; f < 2; f++) {
+    size_t size = 0;
+    Stopwatch bulkSerializeTime;
+    for (int i = 0; i < iterations; i++)
+      size = serializeMsgPackArray(samples.data(), sampleCount, buffer.data(),
+                                   buffer.size(), formats[f]);
+    double bulkSerialize = bulkSerializeTime.seconds();
+
+    Stopwatch bulkDeserializeTime;
+    for (int i = 0; i < iterations; i++)
+      deserializeMsgPackArray(buffer.data(), size, decoded.data(),
+                              sampleCount, count);
+    double bulkDeserialize = bulkDeserializeTime.seconds();
+
+    if (count != sampleCount || decoded != samples) {
+      fprintf(stderr, "%s, %s: wrong result\n", name, formatNames[f]);
+      exit(1);
+    }
+    printf("  %-8s ser %6.1f us               deser %6.1f us               "
+           "%5zu B\n",
+           formatNames[f], bulkSerialize * 1e6 / iterations,
+           bulkDeserialize * 1e6 / iterations, size);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 2000);
+
+  std::vector<float> samples(sampleCount);
+  std::vector<int16_t> hundredths(sampleCount);
+  unsigned seed = 1;
+  for (size_t i = 0; i < sampleCount; i++) {
+    seed = seed * 1103515245 + 12345;
+    samples[i] = 21.5f + 3 * sinf(i * 0.05f) + ((seed >> 8) % 100) / 1000.0f;
+    hundredths[i] = int16_t(samples[i] * 100);
+  }
+
+  bench("float", samples, iterations);
+  bench("int16_t", hundredths, iterations);
+  return 0;
+}
@@ -0,0 +1,136 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Finds the minimum and maximum temperatures of a 4 MB forecast, with a
+// document and with deserializeJsonEvents(), from a string and from a
+// stream. Reports the best time and the peak heap of each.
+
+#include <ArduinoJson.h>
+
+#include <sstream>
+
+#include "Allocators.hpp"
+#include "Bench.hpp"
+#include "Corpus.hpp"
+
+struct MinMax {
+  double min = 1e9;
+  double max = -1e9;
+
+  void add(double t) {
+    if (t < min)
+      min = t;
+    if (t > max)
+      max = t;
+  }
+};
+
+// Tracks list[].main.temp
+struct MinMaxHandler : JsonEventHandler {
+  MinMax result;
+  int depth = 0;
+  int mainDepth = -1;
+  bool isTemp = false;
+
+  bool onStartObject() {
+    depth++;
+    return true;
+  }
+
+  bool onEndObject() {
+    if (depth == mainDepth)
+      mainDepth = -1;
+    depth--;
+    return true;
+  }
+
+  bool onKey(JsonString key) {
+    if (key == "main")
+      mainDepth = depth + 1;
+    isTemp = mainDepth == depth && key == "temp";
+    return true;
+  }
+
+  bool onFloat(JsonFloat value) {
+    if (isTemp)
+      result.add(value);
+    isTemp = false;
+    return true;
+  }
+
+  bool onInteger(JsonInteger value) {
+    return onFloat(JsonFloat(value));
+  }
+
+  bool onUnsignedInteger(JsonUInt value) {
+    return onFloat(JsonFloat(value));
+  }
+};
+
+enum Mode { DomString, DomStream, EventsString, EventsStream };
+
+static const char* modeNames[] = {"document, string", "document, stream",
+                                  "events, string", "events, stream"};
+
+static DeserializationError run(Mode mode, const std::string& json,
+                                CountingAllocator& allocator, MinMax& result) {
+  std::istringstream stream(json);
+  if (mode == DomString || mode == DomStream) {
+    JsonDocument doc(&allocator);
+    DeserializationError err = mode == DomString
+                                   ? deserializeJson(doc, json)
+                                   : deserializeJson(doc, stream);
+    for (JsonObject entry : doc["list"].as<JsonArray>())
+      result.add(entry["main"]["temp"]);
+    return err;
+  } else {
+    MinMaxHandler handler;
+    DeserializationError err = mode == EventsString
+                                   ? deserializeJsonEvents(handler, json)
+                                   : deserializeJsonEvents(handler, stream);
+    result = handler.result;
+    return err;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 3);
+  std::string json = makeForecastCorpus(12000);
+  printf("input: %.2f MB\n", json.size() / 1048576.0);
+
+  MinMax expected;
+  for (int mode = DomString; mode <= EventsStream; mode++) {
+    double best = 1e9;
+    size_t peak = 0;
+    MinMax result;
+    for (int i = 0; i < iterations; i++) {
+      CountingAllocator allocator;
+      result = MinMax();
+      Stopwatch stopwatch;
+      DeserializationError err =
+          run(static_cast<Mode>(mode), json, allocator, result);
+      double seconds = stopwatch.seconds();
+      if (err) {
+        fprintf(stderr, "%s: %s\n", modeNames[mode], err.c_str());
+        return 1;
+      }
+      if (seconds < best)
+        best = seconds;
+      peak = allocator.peakBytes();
+    }
+    if (mode == DomString)
+      expected = result;
+    else if (result.min != expected.min || result.max != expected.max) {
+      fprintf(stderr, "%s: wrong result\n", modeNames[mode]);
+      return 1;
+    }
+    printf("%-18s %7.1f ms  peak heap %9zu bytes  min %.2f max %.2f\n",
+           modeNames[mode], best * 1e3, peak, result.min, result.max);
+  }
+
+  using Parser = ArduinoJson::detail::JsonEventDeserializer<
+      ArduinoJson::detail::Reader<std::istream>, MinMaxHandler>;
+  printf("event parser: %zu bytes on the stack\n", sizeof(Parser));
+  return 0;
+}
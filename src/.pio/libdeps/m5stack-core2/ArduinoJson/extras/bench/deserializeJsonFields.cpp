@@ -0,0 +1,87 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Extracts six fields of a current weather reply, through a JsonDocument and
+// with deserializeJsonFields(). Reports the time and the peak heap of each.
+
+#include <ArduinoJson.h>
+
+#include <string.h>
+
+#include "Allocators.hpp"
+#include "Bench.hpp"
+
+struct Report {
+  char main[16];
+  char icon[8];
+  char name[32];
+  double temp, tempMin, tempMax;
+};
+
+static const JsonField<Report> fields[] = {
+    ARDUINOJSON_FIELD(Report, main, "weather.0.main"),
+    ARDUINOJSON_FIELD(Report, icon, "weather.0.icon"),
+    ARDUINOJSON_FIELD(Report, name, "name"),
+    ARDUINOJSON_FIELD(Report, temp, "main.temp"),
+    ARDUINOJSON_FIELD(Report, tempMin, "main.temp_min"),
+    ARDUINOJSON_FIELD(Report, tempMax, "main.temp_max"),
+};
+
+static const char response[] =
+    "{\"coord\":{\"lon\":-122.08,\"lat\":37.39},\"weather\":[{\"id\":800,"
+    "\"main\":\"Clear\",\"description\":\"clear sky\",\"icon\":\"01d\"}],"
+    "\"base\":\"stations\",\"main\":{\"temp\":282.55,\"feels_like\":281.86,"
+    "\"temp_min\":280.37,\"temp_max\":284.26,\"pressure\":1023,"
+    "\"humidity\":100},\"visibility\":10000,\"wind\":{\"speed\":1.5,"
+    "\"deg\":350},\"clouds\":{\"all\":1},\"dt\":1560350645,\"sys\":{"
+    "\"type\":1,\"id\":5122,\"message\":0.0139,\"country\":\"US\","
+    "\"sunrise\":1560343627,\"sunset\":1560396563},\"timezone\":-25200,"
+    "\"id\":420006353,\"name\":\"Mountain View\",\"cod\":200}";
+
+static void copy(char* dst, size_t size, const char* src) {
+  strncpy(dst, src, size - 1);
+  dst[size - 1] = 0;
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 200000);
+
+  Report fromDocument = {};
+  size_t peak = 0;
+  Stopwatch documentTime;
+  for (int i = 0; i < iterations; i++) {
+    CountingAllocator allocator;
+    JsonDocument doc(&allocator);
+    deserializeJson(doc, response);
+    copy(fromDocument.main, sizeof(fromDocument.main),
+         doc["weather"][0]["main"] | "");
+    copy(fromDocument.icon, sizeof(fromDocument.icon),
+         doc["weather"][0]["icon"] | "");
+    copy(fromDocument.name, sizeof(fromDocument.name), doc["name"] | "");
+    fromDocument.temp = doc["main"]["temp"];
+    fromDocument.tempMin = doc["main"]["temp_min"];
+    fromDocument.tempMax = doc["main"]["temp_max"];
+    peak = allocator.peakBytes();
+  }
+  double document = documentTime.seconds();
+
+  Report bound = {};
+  Stopwatch bindingTime;
+  for (int i = 0; i < iterations; i++)
+    deserializeJsonFields(bound, response, fields);
+  double binding = bindingTime.seconds();
+
+  if (memcmp(&bound, &fromDocument, sizeof(bound)) != 0) {
+    fprintf(stderr, "the binding differs from the document\n");
+    return 1;
+  }
+
+  printf("%-22s %6.2f us  peak heap %5zu bytes\n", "document, then copy",
+         document * 1e6 / iterations, peak);
+  printf("%-22s %6.2f us  peak heap %5d bytes\n", "deserializeJsonFields",
+         binding * 1e6 / iterations, 0);
+  printf("binder: %zu bytes on the stack\n",
+         sizeof(ArduinoJson::detail::JsonFieldBinder<Report, 6>));
+  return 0;
+}
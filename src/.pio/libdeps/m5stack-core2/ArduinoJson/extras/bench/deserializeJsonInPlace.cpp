@@ -0,0 +1,66 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Compares deserializeJson() with deserializeJsonInPlace() on a large
+// forecast: bytes allocated per parse and throughput.
+
+#include <ArduinoJson.h>
+
+#include "Allocators.hpp"
+#include "Bench.hpp"
+#include "Corpus.hpp"
+
+struct Result {
+  double seconds;
+  size_t allocations;
+  size_t bytes;
+  std::string output;
+};
+
+static Result run(const std::string& corpus, bool inPlace, int iterations) {
+  CountingAllocator allocator;
+  Result result = {0, 0, 0, ""};
+  for (int i = 0; i < iterations; i++) {
+    std::string input = corpus;  // the in-place parser consumes its input
+    JsonDocument doc(&allocator);
+    allocator.reset();
+    Stopwatch stopwatch;
+    DeserializationError err =
+        inPlace ? deserializeJsonInPlace(doc, &input[0], input.size())
+                : deserializeJson(doc, input.data(), input.size());
+    result.seconds += stopwatch.seconds();
+    result.allocations += allocator.allocations();
+    result.bytes += allocator.allocatedBytes();
+    if (err) {
+      fprintf(stderr, "%s\n", err.c_str());
+      exit(1);
+    }
+    if (i == 0)
+      serializeJson(doc, result.output);
+  }
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 20);
+  std::string corpus = makeForecastCorpus(8000);
+
+  Result copy = run(corpus, false, iterations);
+  Result inPlace = run(corpus, true, iterations);
+
+  if (copy.output != inPlace.output) {
+    fprintf(stderr, "in-place and copying parsers disagree\n");
+    return 1;
+  }
+
+  double megabytes = corpus.size() * 1e-6 * iterations;
+  printf("corpus: %zu bytes\n", corpus.size());
+  printf("%-24s %8.1f MB/s %9zu bytes %6zu allocations\n", "deserializeJson",
+         megabytes / copy.seconds, copy.bytes / iterations,
+         copy.allocations / iterations);
+  printf("%-24s %8.1f MB/s %9zu bytes %6zu allocations\n",
+         "deserializeJsonInPlace", megabytes / inPlace.seconds,
+         inPlace.bytes / iterations, inPlace.allocations / iterations);
+  return 0;
+}
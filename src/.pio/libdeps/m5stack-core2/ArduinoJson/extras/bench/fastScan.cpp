@@ -0,0 +1,88 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Throughput of deserializeJson() over a pretty-printed forecast, from a
+// stream (one byte at a time) and from memory (block scanning of spaces and
+// string runs, see ARDUINOJSON_ENABLE_FAST_SCAN). Reports the best run.
+
+#include <ArduinoJson.h>
+
+#include "Bench.hpp"
+#include "Corpus.hpp"
+
+// A reader that only offers read() and readBytes(), like a Stream.
+struct ByteReader {
+  const char* ptr;
+  const char* end;
+
+  int read() {
+    return ptr < end ? static_cast<unsigned char>(*ptr++) : -1;
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length && ptr < end)
+      buffer[n++] = *ptr++;
+    return n;
+  }
+};
+
+enum Source { Stream, Pointer, Sized, InPlace };
+
+static const char* sourceNames[] = {"stream", "const char*",
+                                    "const char*, size", "in place"};
+
+static DeserializationError parse(JsonDocument& doc, const std::string& corpus,
+                                  std::string& copy, Source source) {
+  switch (source) {
+    case Stream: {
+      ByteReader reader = {corpus.data(), corpus.data() + corpus.size()};
+      return deserializeJson(doc, reader);
+    }
+    case Pointer:
+      return deserializeJson(doc, corpus.c_str());
+    case Sized:
+      return deserializeJson(doc, corpus.data(), corpus.size());
+    default:
+      return deserializeJsonInPlace(doc, &copy[0], copy.size());
+  }
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 20);
+  std::string corpus = makeForecastCorpus(4000);
+  std::string reference;
+
+  printf("corpus: %zu bytes\n", corpus.size());
+  for (int source = Stream; source <= InPlace; source++) {
+    double best = 1e9;
+    for (int i = 0; i < iterations; i++) {
+      std::string copy = corpus;
+      JsonDocument doc;
+      Stopwatch stopwatch;
+      DeserializationError err =
+          parse(doc, corpus, copy, static_cast<Source>(source));
+      double seconds = stopwatch.seconds();
+      if (seconds < best)
+        best = seconds;
+      if (err) {
+        fprintf(stderr, "%s: %s\n", sourceNames[source], err.c_str());
+        return 1;
+      }
+      if (i == 0) {
+        std::string output;
+        serializeJson(doc, output);
+        if (source == Stream)
+          reference = output;
+        else if (output != reference) {
+          fprintf(stderr, "%s: differs from stream\n", sourceNames[source]);
+          return 1;
+        }
+      }
+    }
+    printf("%-20s %8.1f MB/s\n", sourceNames[source],
+           corpus.size() * 1e-6 / best);
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Parses objects of 8 to 2048 members, then looks up every key in a shuffled
+// order. Built twice, with and without ARDUINOJSON_KEY_INDEX_THRESHOLD.
+
+#include <ArduinoJson.h>
+
+#include "Allocators.hpp"
+#include "Bench.hpp"
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 20);
+
+  printf("ARDUINOJSON_KEY_INDEX_THRESHOLD=%d\n",
+         ARDUINOJSON_KEY_INDEX_THRESHOLD);
+  for (int n = 8; n <= 2048; n *= 4) {
+    std::string json = "{";
+    for (int i = 0; i < n; i++) {
+      if (i)
+        json += ',';
+      json += "\"key" + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    json += '}';
+
+    CountingAllocator allocator;
+    JsonDocument doc(&allocator);
+    Stopwatch parseTime;
+    for (int i = 0; i < iterations; i++)
+      deserializeJson(doc, json.data(), json.size());
+    double parse = parseTime.seconds() / iterations;
+
+    JsonObject obj = doc.as<JsonObject>();
+    long sum = 0;
+    Stopwatch lookupTime;
+    for (int i = 0; i < iterations; i++) {
+      for (int j = 0; j < n; j++) {
+        char key[16];
+        int k = (j * 7919) % n;
+        snprintf(key, sizeof(key), "key%d", k);
+        int value = obj[key].as<int>();
+        if (value != k) {
+          fprintf(stderr, "%s: got %d\n", key, value);
+          return 1;
+        }
+        sum += value;
+      }
+    }
+    double lookup = lookupTime.seconds() / (double(iterations) * n);
+    doNotOptimize(sum);
+
+    printf("%5d members: parse %9.1f us, lookup %7.1f ns, %7zu bytes\n", n,
+           parse * 1e6, lookup * 1e9, allocator.liveBytes());
+  }
+  return 0;
+}
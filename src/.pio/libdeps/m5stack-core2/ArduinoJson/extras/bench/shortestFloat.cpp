@@ -0,0 +1,79 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Serializes columns of sensor readings: values quantized to the resolution
+// of the sensor, and raw ones. Built twice, with and without
+// ARDUINOJSON_ENABLE_SHORTEST_FLOAT, to compare the output size and the time
+// per value. Reports the best run.
+
+#include <ArduinoJson.h>
+
+#include "Bench.hpp"
+
+static unsigned seed = 7;
+
+static double uniform() {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) / 16777216.0;
+}
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 30);
+  const int count = 1000;
+
+  static const char* names[] = {
+      "temperature (float, 0.1)", "humidity (float, 0.1)",
+      "pressure (double, 0.01)",  "accel (raw float)",
+      "latitude (raw double)",
+  };
+  const int columns = sizeof(names) / sizeof(names[0]);
+
+  JsonDocument doc;
+  JsonArray values[columns];
+  for (int c = 0; c < columns; c++)
+    values[c] = doc[names[c]].to<JsonArray>();
+  for (int i = 0; i < count; i++) {
+    values[0].add(float(int(150 + uniform() * 200) / 10.0));
+    values[1].add(float(int(uniform() * 1000) / 10.0));
+    values[2].add(int(98000 + uniform() * 5000) / 100.0);
+    values[3].add(float(uniform() * 4 - 2));
+    values[4].add(48.85 + uniform() * 0.01);
+  }
+
+  printf("ARDUINOJSON_ENABLE_SHORTEST_FLOAT=%d\n",
+         ARDUINOJSON_ENABLE_SHORTEST_FLOAT);
+  for (int c = 0; c < columns; c++) {
+    std::string output;
+    double best = 1e9;
+    for (int i = 0; i < iterations; i++) {
+      output.clear();
+      Stopwatch stopwatch;
+      serializeJson(values[c], output);
+      double seconds = stopwatch.seconds();
+      if (seconds < best)
+        best = seconds;
+    }
+
+#if ARDUINOJSON_ENABLE_SHORTEST_FLOAT
+    // the round-trip output must read back to the same values
+    static const bool isFloat[] = {true, true, false, true, false};
+    const char* p = output.c_str() + 1;
+    for (int i = 0; i < count; i++) {
+      char* next;
+      bool same = isFloat[c]
+                      ? strtof(p, &next) == values[c][i].as<float>()
+                      : strtod(p, &next) == values[c][i].as<double>();
+      if (!same) {
+        fprintf(stderr, "%s[%d] doesn't round trip\n", names[c], i);
+        return 1;
+      }
+      p = next + 1;
+    }
+#endif
+
+    printf("%-26s %6zu bytes %6.1f ns/value  e.g. %.36s\n", names[c],
+           output.size(), best * 1e9 / count, output.c_str() + 1);
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Parses arrays of 10 to 10,000 unique strings. Built twice, with and without
+// ARDUINOJSON_ENABLE_STRING_INDEX, so the two outputs can be compared.
+
+#include <ArduinoJson.h>
+
+#include "Allocators.hpp"
+#include "Bench.hpp"
+
+int main(int argc, char* argv[]) {
+  int iterations = benchIterations(argc, argv, 20000);
+
+  printf("ARDUINOJSON_ENABLE_STRING_INDEX=%d\n",
+         ARDUINOJSON_ENABLE_STRING_INDEX);
+  for (int n = 10; n <= 10000; n *= 10) {
+    std::string json = "[";
+    for (int i = 0; i < n; i++) {
+      if (i)
+        json += ',';
+      json += "\"value" + std::to_string(i) + "\"";
+    }
+    json += ']';
+
+    CountingAllocator allocator;
+    int repeat = iterations / n + 1;
+    double seconds = 0;
+    size_t peak = 0;
+    for (int i = 0; i < repeat; i++) {
+      JsonDocument doc(&allocator);
+      allocator.reset();
+      Stopwatch stopwatch;
+      DeserializationError err = deserializeJson(doc, json.c_str());
+      seconds += stopwatch.seconds();
+      peak = allocator.peakBytes();
+      if (err || doc.size() != size_t(n) ||
+          doc[n - 1].as<std::string>() != "value" + std::to_string(n - 1)) {
+        fprintf(stderr, "%d strings: wrong result\n", n);
+        return 1;
+      }
+    }
+    printf("%6d unique strings: %10.1f us/parse %9zu bytes peak\n", n,
+           seconds / repeat * 1e6, peak);
+  }
+  return 0;
+}
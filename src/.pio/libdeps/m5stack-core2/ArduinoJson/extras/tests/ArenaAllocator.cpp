@@ -0,0 +1,267 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Drives an ArenaAllocator with random allocate(), reallocate() and
+// deallocate() calls, and checks each result against a model of the arena:
+// the pointer returned (or the failure), used(), and the contents of every
+// live block. Then documents are parsed, cleared and refilled in an arena.
+
+#include <ArduinoJson.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+
+using ArduinoJson::detail::arenaAlignUp;
+using ArduinoJson::detail::ArenaBlock;
+using ArduinoJson::detail::ArenaMaxAlign;
+
+static unsigned seed = 7;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+// The blocks of the arena in address order, as the allocator should lay
+// them out
+class ArenaModel {
+ public:
+  static constexpr size_t headerSize = arenaAlignUp(sizeof(ArenaBlock));
+
+  struct Block {
+    size_t offset;
+    size_t size;  // padded
+    bool freed;
+    size_t length;  // bytes the caller asked for, filled with fill
+    char fill;
+  };
+
+  explicit ArenaModel(size_t capacity) : capacity_(capacity) {}
+
+  size_t used() const {
+    return blocks_.empty() ? 0 : end(blocks_.back());
+  }
+
+  // Offset of the payload of a new block, or SIZE_MAX if it doesn't fit
+  size_t allocate(size_t n) {
+    size_t offset = used();
+    if (capacity_ - offset < headerSize ||
+        arenaAlignUp(n) > capacity_ - offset - headerSize)
+      return SIZE_MAX;
+    blocks_.push_back({offset, arenaAlignUp(n), false, 0, 0});
+    return offset + headerSize;
+  }
+
+  void deallocate(size_t payload) {
+    find(payload)->freed = true;
+    while (!blocks_.empty() && blocks_.back().freed)
+      blocks_.pop_back();
+  }
+
+  // Same as allocate()
+  size_t reallocate(size_t payload, size_t n) {
+    Block* block = find(payload);
+    if (block == &blocks_.back()) {
+      if (arenaAlignUp(n) > capacity_ - block->offset - headerSize)
+        return SIZE_MAX;
+      block->size = arenaAlignUp(n);
+      return payload;
+    }
+    if (n <= block->size)
+      return payload;
+    size_t moved = allocate(n);
+    if (moved != SIZE_MAX)
+      deallocate(payload);
+    return moved;
+  }
+
+  Block* find(size_t payload) {
+    for (Block& block : blocks_)
+      if (block.offset + headerSize == payload)
+        return &block;
+    return nullptr;
+  }
+
+  void reset() {
+    blocks_.clear();
+  }
+
+  std::vector<Block>& blocks() {
+    return blocks_;
+  }
+
+ private:
+  static size_t end(const Block& block) {
+    return block.offset + headerSize + block.size;
+  }
+
+  size_t capacity_;
+  std::vector<Block> blocks_;
+};
+
+// Offset of a block of n bytes, which must lie inside the buffer
+static size_t offsetIn(const ArenaAllocator& arena, const char* base,
+                       void* ptr, size_t n) {
+  if (!ptr)
+    return SIZE_MAX;
+  size_t offset = size_t(static_cast<char*>(ptr) - base);
+  CHECK(static_cast<char*>(ptr) >= base && offset + n <= arena.capacity());
+  return offset;
+}
+
+static bool contentsIntact(const char* base, ArenaModel& model) {
+  for (const ArenaModel::Block& block : model.blocks()) {
+    if (block.freed)
+      continue;
+    const char* p = base + block.offset + ArenaModel::headerSize;
+    for (size_t i = 0; i < block.length; i++)
+      if (p[i] != block.fill)
+        return false;
+  }
+  return true;
+}
+
+static void fill(char* base, ArenaModel::Block* block, size_t length) {
+  block->fill = char('A' + random(26));
+  block->length = length;
+  memset(base + block->offset + ArenaModel::headerSize, block->fill, length);
+}
+
+static void fuzz(int rounds, int operations) {
+  // Misaligned on purpose, the allocator aligns the start
+  static char storage[6000 + alignof(ArenaMaxAlign)];
+  size_t failures = 0;
+
+  for (int round = 0; round < rounds; round++) {
+    size_t skew = random(alignof(ArenaMaxAlign));
+    size_t capacity = 64 + random(6000 - 64);
+    ArenaAllocator arena(storage + skew, capacity);
+    char* base = storage + arenaAlignUp(skew);
+    ArenaModel model(arena.capacity());
+    CHECK(arena.capacity() == capacity - (arenaAlignUp(skew) - skew));
+    size_t highWaterMark = 0;
+    std::vector<size_t> live;  // payload offsets
+
+    for (int op = 0; op < operations; op++) {
+      unsigned action = random(10);
+      size_t n = random(8) ? random(100) : random(2000);
+
+      if (action < 4 || live.empty()) {
+        size_t offset = offsetIn(arena, base, arena.allocate(n), n);
+        CHECK(offset == model.allocate(n));
+        if (offset != SIZE_MAX) {
+          fill(base, model.find(offset), n);
+          live.push_back(offset);
+        } else {
+          failures++;
+        }
+      } else if (action < 7) {
+        size_t i = random(live.size());
+        size_t kept = model.find(live[i])->length;
+        char fillByte = model.find(live[i])->fill;
+        size_t offset =
+            offsetIn(arena, base, arena.reallocate(base + live[i], n), n);
+        CHECK(offset == model.reallocate(live[i], n));
+        if (offset != SIZE_MAX) {
+          // the bytes that fit are carried over
+          const char* p = base + offset;
+          size_t carried = kept < n ? kept : n;
+          bool same = true;
+          for (size_t j = 0; j < carried; j++)
+            same &= p[j] == fillByte;
+          CHECK(same);
+          live[i] = offset;
+          fill(base, model.find(offset), n);
+        } else {
+          failures++;
+        }
+      } else if (action < 9) {
+        size_t i = random(live.size());
+        arena.deallocate(base + live[i]);
+        model.deallocate(live[i]);
+        live.erase(live.begin() + long(i));
+      } else if (random(20) == 0) {
+        arena.reset();
+        model.reset();
+        live.clear();
+      }
+
+      CHECK(arena.used() == model.used());
+      CHECK(arena.used() <= arena.capacity());
+      if (arena.used() > highWaterMark)
+        highWaterMark = arena.used();
+      CHECK(arena.highWaterMark() == highWaterMark);
+      CHECK(contentsIntact(base, model));
+      if (checkFailures())
+        return;
+    }
+
+    // freeing every block in any order gives the whole buffer back
+    while (!live.empty()) {
+      size_t i = random(live.size());
+      arena.deallocate(base + live[i]);
+      live.erase(live.begin() + long(i));
+    }
+    CHECK(arena.used() == 0);
+  }
+  CHECK(failures > 0);  // the arenas did fill up
+}
+
+static void checkAlignment() {
+  static char storage[512];
+  for (size_t skew = 0; skew < alignof(ArenaMaxAlign); skew++) {
+    ArenaAllocator arena(storage + skew, 500);
+    for (size_t n = 1; n < 12; n++) {
+      void* p = arena.allocate(n);
+      CHECK(p != nullptr);
+      CHECK(reinterpret_cast<uintptr_t>(p) % alignof(ArenaMaxAlign) == 0);
+    }
+  }
+
+  // no buffer, or one too small to align
+  ArenaAllocator none(nullptr, 100);
+  CHECK(none.capacity() == 0);
+  CHECK(none.allocate(1) == nullptr);
+  ArenaAllocator tiny(storage + 1, 1);
+  CHECK(tiny.allocate(0) == nullptr);
+}
+
+static void checkDocuments() {
+  static char storage[8192];
+  ArenaAllocator arena(storage, sizeof(storage));
+  std::string input =
+      "{\"name\":\"London\",\"main\":{\"temp\":281.5,\"humidity\":81},"
+      "\"weather\":[{\"description\":\"overcast clouds\",\"icon\":\"04d\"}]}";
+
+  size_t peak = 0;
+  for (int i = 0; i < 50; i++) {
+    JsonDocument doc(&arena);
+    CHECK(deserializeJson(doc, input) == DeserializationError::Ok);
+    CHECK(doc["main"]["humidity"] == 81);
+    doc.clear();
+    CHECK(arena.used() == 0);  // clear() hands everything back
+    CHECK(deserializeJson(doc, input) == DeserializationError::Ok);
+    CHECK(doc["weather"][0]["icon"] == "04d");
+    if (i == 0)
+      peak = arena.highWaterMark();
+  }
+  CHECK(arena.used() == 0);
+  CHECK(arena.highWaterMark() == peak);  // rebuilding doesn't grow
+
+  // out of room: the parse fails cleanly
+  ArenaAllocator small(storage, 64);
+  JsonDocument doc(&small);
+  CHECK(deserializeJson(doc, input) == DeserializationError::NoMemory);
+}
+
+int main() {
+  checkAlignment();
+  fuzz(300, 2000);
+  checkDocuments();
+  return checkResult();
+}
@@ -0,0 +1,123 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Counts the write() calls a HardwareSerial or a WiFiClient would receive,
+// and checks that BufferedPrint sends the same bytes in fewer calls.
+
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 1
+#include <ArduinoJson.h>
+
+#include <string>
+
+#include "Check.hpp"
+
+class CountingPrint : public Print {
+ public:
+  std::string output;
+  size_t calls = 0;
+  size_t limit = size_t(-1);  // bytes accepted before refusing
+
+  size_t write(uint8_t c) override {
+    calls++;
+    if (output.size() >= limit)
+      return 0;
+    output += char(c);
+    return 1;
+  }
+
+  size_t write(const uint8_t* s, size_t n) override {
+    calls++;
+    size_t room = limit > output.size() ? limit - output.size() : 0;
+    if (n > room)
+      n = room;
+    output.append(reinterpret_cast<const char*>(s), n);
+    return n;
+  }
+};
+
+template <size_t N>
+static void checkBuffered(JsonDocument& doc) {
+  std::string json, pretty, msgpack;
+  serializeJson(doc, json);
+  serializeJsonPretty(doc, pretty);
+  serializeMsgPack(doc, msgpack);
+
+  CountingPrint direct;
+  serializeJson(doc, direct);
+
+  CountingPrint p1, p2, p3;
+  CHECK(serializeJson(doc, BufferedPrint<N>(p1)) == json.size());
+  CHECK(serializeJsonPretty(doc, BufferedPrint<N>(p2)) == pretty.size());
+  CHECK(serializeMsgPack(doc, BufferedPrint<N>(p3)) == msgpack.size());
+  CHECK(p1.output == json);
+  CHECK(p2.output == pretty);
+  CHECK(p3.output == msgpack);
+
+  // at most one call per buffer, plus one for the remainder
+  CHECK(p1.calls <= json.size() / N + 1);
+  CHECK(p1.calls < direct.calls);
+  printf("BufferedPrint<%zu>: %zu bytes in %zu calls (%zu unbuffered)\n", N,
+         json.size(), p1.calls, direct.calls);
+}
+
+int main() {
+  JsonDocument doc;
+  deserializeJson(doc,
+                  "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},"
+                  "\"weather\":[{\"id\":803,\"main\":\"Clouds\","
+                  "\"description\":\"broken clouds\",\"icon\":\"04d\"}],"
+                  "\"main\":{\"temp\":14.36,\"feels_like\":13.85,"
+                  "\"pressure\":1012,\"humidity\":77},\"name\":\"London\"}");
+  for (int i = 0; i < 20; i++)
+    doc["history"].add(i * 1.5);
+
+  std::string json;
+  serializeJson(doc, json);
+
+  checkBuffered<16>(doc);
+  checkBuffered<64>(doc);
+  checkBuffered<256>(doc);
+
+  // an lvalue can be reused, then flushed explicitly
+  {
+    CountingPrint p;
+    BufferedPrint<32> buffered(p);
+    serializeJson(doc, buffered);
+    serializeJson(doc, buffered);
+    buffered.flush();
+    CHECK(p.output == json + json);
+  }
+
+  // the destructor flushes
+  {
+    CountingPrint p;
+    {
+      BufferedPrint<32> buffered(p);
+      serializeJson(doc, buffered);
+    }
+    CHECK(p.output == json);
+  }
+
+  // refused bytes are not counted
+  {
+    CountingPrint p;
+    p.limit = 100;
+    CHECK(serializeJson(doc, BufferedPrint<64>(p)) == 100);
+    CHECK(p.output == json.substr(0, 100));
+  }
+
+  // strings longer than the buffer bypass it
+  {
+    JsonDocument d;
+    d["s"] = std::string(300, 'x');
+    std::string expected;
+    serializeMsgPack(d, expected);
+    CountingPrint p;
+    CHECK(serializeMsgPack(d, BufferedPrint<16>(p)) == expected.size());
+    CHECK(p.output == expected);
+    CHECK(p.calls == 2);  // the buffered header, then the string itself
+  }
+
+  return checkResult();
+}
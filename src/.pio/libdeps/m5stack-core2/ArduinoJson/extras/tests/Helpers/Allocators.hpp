@@ -0,0 +1,75 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson.hpp>
+
+#include <stdlib.h>
+
+// Counts the calls and the bytes that go through the allocator, and tracks
+// the peak of the live bytes.
+class CountingAllocator : public ArduinoJson::Allocator {
+ public:
+  void* allocate(size_t n) override {
+    return track(malloc(n + sizeof(size_t)), n);
+  }
+
+  void deallocate(void* p) override {
+    if (!p)
+      return;
+    size_t* header = static_cast<size_t*>(p) - 1;
+    live_ -= *header;
+    free(header);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    if (!p)
+      return allocate(n);
+    size_t* header = static_cast<size_t*>(p) - 1;
+    live_ -= *header;
+    return track(realloc(header, n + sizeof(size_t)), n);
+  }
+
+  void reset() {
+    allocations_ = 0;
+    allocatedBytes_ = 0;
+    peak_ = live_;
+  }
+
+  size_t allocations() const {
+    return allocations_;
+  }
+
+  size_t allocatedBytes() const {
+    return allocatedBytes_;
+  }
+
+  size_t liveBytes() const {
+    return live_;
+  }
+
+  size_t peakBytes() const {
+    return peak_;
+  }
+
+ private:
+  void* track(void* block, size_t n) {
+    if (!block)
+      return nullptr;
+    size_t* header = static_cast<size_t*>(block);
+    *header = n;
+    allocations_++;
+    allocatedBytes_ += n;
+    live_ += n;
+    if (live_ > peak_)
+      peak_ = live_;
+    return header + 1;
+  }
+
+  size_t allocations_ = 0;
+  size_t allocatedBytes_ = 0;
+  size_t live_ = 0;
+  size_t peak_ = 0;
+};
@@ -0,0 +1,32 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <stdio.h>
+
+// Minimal assertion helpers for the host tests: a failed CHECK() reports the
+// location and the test keeps going; checkResult() is the exit code.
+
+inline int& checkFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                               \
+  do {                                                                 \
+    if (!(condition)) {                                                \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+              #condition);                                             \
+      checkFailures()++;                                               \
+    }                                                                  \
+  } while (0)
+
+inline int checkResult() {
+  if (checkFailures())
+    fprintf(stderr, "%d check(s) failed\n", checkFailures());
+  else
+    printf("ok\n");
+  return checkFailures() ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// serializeMsgPackArray() must produce the same bytes as serializeMsgPack()
+// on the equivalent JsonArray, and deserializeMsgPackArray() must read back
+// both formats, for every element type.
+
+#include <ArduinoJson.h>
+
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Check.hpp"
+
+static uint64_t state = 1;
+
+static uint64_t random64() {  // xorshift64*
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 0x2545F4914F6CDD1DULL;
+}
+
+template <typename T>
+static T randomValue(std::true_type) {  // floating point
+  switch (random64() % 4) {
+    case 0:
+      return T(int(random64() % 2000) - 1000);
+    case 1:
+      return T(double(int64_t(random64())) / 1e9);
+    case 2:
+      return T(random64() % 100) / 8;
+    default: {
+      double d;
+      uint64_t bits = random64();
+      memcpy(&d, &bits, sizeof(d));
+      return isfinite(d) ? T(d) : T(0.5);
+    }
+  }
+}
+
+template <typename T>
+static T randomValue(std::false_type) {  // integer
+  return T(random64() >> (random64() % 64));
+}
+
+template <typename T>
+static bool same(T a, T b) {
+  return a == b || (a != a && b != b);  // NaN
+}
+
+template <typename T>
+static void checkType() {
+  using is_float = std::is_floating_point<T>;
+  for (int iteration = 0; iteration < 1500; iteration++) {
+    size_t n = iteration % 100 ? random64() % 40 : random64() % 70000;
+    std::vector<T> values(n);
+    for (T& x : values)
+      x = randomValue<T>(is_float());
+
+    std::string array;
+    serializeMsgPackArray(values.data(), n, array);
+    CHECK(array.size() == measureMsgPackArray(values.data(), n));
+    if (n < 5000) {
+      JsonDocument doc;
+      JsonArray a = doc.to<JsonArray>();
+      for (T x : values)
+        a.add(x);
+      std::string expected;
+      serializeMsgPack(doc, expected);
+      CHECK(array == expected);
+    }
+
+    std::string packed;
+    serializeMsgPackArray(values.data(), n, packed, MsgPackArrayFormat::Packed);
+    CHECK(packed.size() ==
+          measureMsgPackArray(values.data(), n, MsgPackArrayFormat::Packed));
+    if (n && n < 5000) {  // readable as a MsgPackExtension
+      JsonDocument doc;
+      CHECK(deserializeMsgPack(doc, packed) == DeserializationError::Ok);
+      CHECK(doc.as<MsgPackExtension>().size() == n * sizeof(T));
+    }
+
+    for (const std::string* input : {&array, &packed}) {
+      std::vector<T> output(n + 1);
+      size_t count = 99;
+      CHECK(deserializeMsgPackArray(*input, output.data(), n, count) ==
+            DeserializationError::Ok);
+      CHECK(count == n);
+      bool ok = true;
+      for (size_t i = 0; i < n; i++)
+        ok &= same(output[i], values[i]);
+      CHECK(ok);
+
+      CHECK(deserializeMsgPackArray(input->data(), input->size(),
+                                    output.data(), n + 1,
+                                    count) == DeserializationError::Ok);
+      CHECK(count == n);
+      if (n)
+        CHECK(deserializeMsgPackArray(*input, output.data(), n - 1, count) ==
+              DeserializationError::NoMemory);
+      if (input->size() > 1)
+        CHECK(deserializeMsgPackArray(input->data(), input->size() - 1,
+                                      output.data(), n, count) ==
+              DeserializationError::IncompleteInput);
+
+      // into another type, like as<double>()
+      std::vector<double> doubles(n);
+      CHECK(deserializeMsgPackArray(*input, doubles.data(), n, count) ==
+            DeserializationError::Ok);
+      if (sizeof(T) < 8 || is_float::value) {
+        ok = true;
+        for (size_t i = 0; i < n; i++)
+          ok &= same(doubles[i], double(values[i]));
+        CHECK(ok);
+      }
+    }
+  }
+}
+
+int main() {
+  checkType<int8_t>();
+  checkType<uint8_t>();
+  checkType<int16_t>();
+  checkType<uint16_t>();
+  checkType<int32_t>();
+  checkType<uint32_t>();
+  checkType<int64_t>();
+  checkType<uint64_t>();
+  checkType<float>();
+  checkType<double>();
+
+  size_t count;
+  int16_t values[4];
+  CHECK(deserializeMsgPackArray("", 0, values, 4, count) ==
+        DeserializationError::EmptyInput);
+  CHECK(deserializeMsgPackArray("\x92\x01\xa1x", values, 4, count) ==
+        DeserializationError::InvalidInput);
+  CHECK(deserializeMsgPackArray("\x81\xa1x\x01", values, 4, count) ==
+        DeserializationError::InvalidInput);
+  // unknown extension type
+  CHECK(deserializeMsgPackArray("\xd5\x42\x00\x01", values, 4, count) ==
+        DeserializationError::InvalidInput);
+  // size not a multiple of the element
+  CHECK(deserializeMsgPackArray("\xc7\x03\x12\x00\x01\x02", 6, values, 4,
+                                count) == DeserializationError::InvalidInput);
+  // out of range gives 0, like as<T>()
+  const uint8_t big[] = {0x91, 0xcd, 0xff, 0xff};
+  CHECK(deserializeMsgPackArray(big, 4, values, 4, count) ==
+        DeserializationError::Ok);
+  CHECK(count == 1);
+  CHECK(values[0] == 0);
+
+  return checkResult();
+}
@@ -0,0 +1,203 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Applies random mutations to documents, compacts them, and checks that they
+// still hold the same values, and still behave like a document that was
+// never compacted.
+
+#include <ArduinoJson.h>
+
+#include <stdint.h>
+#include <string>
+
+#include "Allocators.hpp"
+#include "Check.hpp"
+
+// Fails every allocation after a given number.
+class FailingAllocator : public CountingAllocator {
+ public:
+  void* allocate(size_t n) override {
+    if (allocations() >= limit_)
+      return nullptr;
+    return CountingAllocator::allocate(n);
+  }
+
+  void failAfter(size_t allocations) {
+    limit_ = allocations;
+  }
+
+ private:
+  size_t limit_ = SIZE_MAX;
+};
+
+static unsigned seed = 42;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+static std::string randomKey() {
+  static const char* keys[] = {"a",     "bb", "ccc", "name",
+                               "value", "a long key that is not tiny",
+                               "x",     "y"};
+  return keys[random(8)] + std::to_string(random(4));
+}
+
+static std::string randomString() {
+  return std::string(random(30), char('a' + random(26)));
+}
+
+static void mutate(JsonVariant variant, int depth) {
+  if (variant.is<JsonObject>() && (random(3) || depth > 5)) {
+    JsonObject object = variant;
+    switch (random(5)) {
+      case 0:
+        object[randomKey()] = randomString();
+        break;
+      case 1:
+        object[randomKey()] = int(random(1000000)) - 500000;
+        break;
+      case 2:
+        object.remove(randomKey());
+        break;
+      case 3:
+        object[randomKey()].to<JsonArray>();
+        break;
+      default:
+        object[randomKey()].to<JsonObject>();
+        break;
+    }
+    return;
+  }
+
+  if (variant.is<JsonArray>() && (random(3) || depth > 5)) {
+    JsonArray array = variant;
+    switch (random(5)) {
+      case 0:
+        array.add(randomString());
+        break;
+      case 1:
+        array.add(random(1000000) / 7.0);
+        break;
+      case 2:
+        if (array.size())
+          array.remove(random(array.size()));
+        break;
+      case 3:
+        array.add<JsonObject>();
+        break;
+      default:
+        array.add<JsonArray>();
+        break;
+    }
+    return;
+  }
+
+  // descend into a random child, or replace it if it's not a container
+  if (variant.is<JsonObject>()) {
+    JsonObject object = variant;
+    if (!object.size()) {
+      object[randomKey()].to<JsonObject>();
+      return;
+    }
+    size_t i = random(object.size());
+    for (JsonPair pair : object) {
+      if (i--)
+        continue;
+      if (pair.value().is<JsonObject>() || pair.value().is<JsonArray>())
+        mutate(pair.value(), depth + 1);
+      else
+        object.remove(pair.key());
+      return;
+    }
+  }
+
+  if (variant.is<JsonArray>()) {
+    JsonArray array = variant;
+    if (!array.size()) {
+      array.add<JsonArray>();
+      return;
+    }
+    JsonVariant child = array[random(array.size())];
+    if (child.is<JsonObject>() || child.is<JsonArray>())
+      mutate(child, depth + 1);
+    else
+      child.set(randomKey());
+  }
+}
+
+static std::string toJson(const JsonDocument& doc) {
+  std::string json;
+  serializeJson(doc, json);
+  return json;
+}
+
+int main() {
+  size_t reclaimed = 0;
+  for (int round = 0; round < 400; round++) {
+    CountingAllocator allocator;
+    {
+      JsonDocument doc(&allocator);
+      doc.to<JsonObject>();
+      for (unsigned i = random(3000); i > 0; i--)
+        mutate(doc.as<JsonVariant>(), 0);
+
+      std::string before = toJson(doc);
+      JsonDocument reference(doc);  // never compacted
+
+      size_t heapBefore = allocator.liveBytes();
+      size_t released = doc.compact();
+      CHECK(toJson(doc) == before);
+      CHECK(heapBefore - allocator.liveBytes() == released);
+      CHECK(!doc.overflowed());
+      CHECK(doc.compact() == 0);
+      reclaimed += released;
+
+      // the same mutations give the same result
+      unsigned savedSeed = seed;
+      for (int i = 0; i < 300; i++)
+        mutate(doc.as<JsonVariant>(), 0);
+      seed = savedSeed;
+      for (int i = 0; i < 300; i++)
+        mutate(reference.as<JsonVariant>(), 0);
+      CHECK(toJson(doc) == toJson(reference));
+      CHECK(doc == reference);
+    }
+    CHECK(allocator.liveBytes() == 0);
+  }
+  CHECK(reclaimed > 0);
+
+  // out of memory during the copy: the document is unchanged
+  for (size_t limit = 0; limit < 40; limit++) {
+    FailingAllocator allocator;
+    JsonDocument doc(&allocator);
+    for (int i = 0; i < 300; i++)
+      doc[randomKey()] = std::string(20, char('a' + i % 26));
+    for (int i = 0; i < 20; i++)
+      doc.remove(randomKey());
+
+    std::string before = toJson(doc);
+    size_t heap = allocator.liveBytes();
+    allocator.failAfter(allocator.allocations() + limit);
+    size_t released = doc.compact();
+    allocator.failAfter(SIZE_MAX);
+    CHECK(toJson(doc) == before);
+    if (!released)
+      CHECK(allocator.liveBytes() == heap);
+  }
+
+  // in-place strings stay linked
+  {
+    char json[] = "{\"k\":\"linked\",\"t\":[1,2,3]}";
+    JsonDocument doc;
+    deserializeJsonInPlace(doc, json);
+    doc["t"].remove(1);
+    doc.compact();
+    const char* s = doc["k"];
+    CHECK(s >= json && s < json + sizeof(json));
+  }
+
+  return checkResult();
+}
@@ -0,0 +1,270 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Rebuilds the minified JSON from the events and compares it with what the
+// DOM parser produces, on random documents, their truncations, and corrupted
+// copies. Then checks the stops, the nesting limit, and the long strings.
+
+#include <ArduinoJson.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+
+template <typename T>
+static std::string toJson(T value) {
+  JsonDocument doc;
+  doc.set(value);
+  std::string s;
+  serializeJson(doc, s);
+  return s;
+}
+
+struct Echo : JsonEventHandler {
+  std::string output;
+  std::vector<bool> first;
+  bool afterKey = false;
+  int stopAfter = -1;
+  int events = 0;
+
+  bool separate() {
+    if (!afterKey && !first.empty()) {
+      if (!first.back())
+        output += ',';
+      first.back() = false;
+    }
+    afterKey = false;
+    return stopAfter < 0 || ++events < stopAfter;
+  }
+
+  bool onStartObject() {
+    bool result = separate();
+    output += '{';
+    first.push_back(true);
+    return result;
+  }
+
+  bool onEndObject() {
+    output += '}';
+    first.pop_back();
+    return true;
+  }
+
+  bool onStartArray() {
+    bool result = separate();
+    output += '[';
+    first.push_back(true);
+    return result;
+  }
+
+  bool onEndArray() {
+    output += ']';
+    first.pop_back();
+    return true;
+  }
+
+  bool onKey(JsonString key) {
+    bool result = separate();
+    output += toJson(std::string(key.c_str(), key.size())) + ':';
+    afterKey = true;
+    return result;
+  }
+
+  bool onString(JsonString value) {
+    bool result = separate();
+    output += toJson(std::string(value.c_str(), value.size()));
+    return result;
+  }
+
+  bool onInteger(JsonInteger value) {
+    bool result = separate();
+    output += toJson(value);
+    return result;
+  }
+
+  bool onUnsignedInteger(JsonUInt value) {
+    bool result = separate();
+    output += toJson(value);
+    return result;
+  }
+
+  bool onFloat(JsonFloat value) {
+    bool result = separate();
+    output += toJson(value);
+    return result;
+  }
+
+  bool onBoolean(bool value) {
+    bool result = separate();
+    output += value ? "true" : "false";
+    return result;
+  }
+
+  bool onNull() {
+    bool result = separate();
+    output += "null";
+    return result;
+  }
+};
+
+static unsigned seed = 1;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+static std::string randomJson(int depth) {
+  switch (random(depth > 0 ? 9 : 7)) {
+    case 0:
+      return "null";
+    case 1:
+      return "true";
+    case 2:
+      return "false";
+    case 3:
+      return std::to_string(int(random(2000000)) - 1000000);
+    case 4: {
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%.6g", random(100000000) / 1e5);
+      return buffer;
+    }
+    case 5:
+      return std::to_string(uint64_t(random(4000000)) * 4000000000000ULL);
+    case 6: {
+      std::string s = "\"";
+      for (unsigned i = random(12); i > 0; i--) {
+        unsigned c = random(40);
+        s += c == 0 ? "\\n" : c == 1 ? "\\u00e9" : c == 2 ? "\\\"" : "";
+        if (c > 2)
+          s += char('a' + c % 26);
+      }
+      return s + "\"";
+    }
+    case 7: {
+      std::string s = "[ ";
+      for (unsigned i = 0, n = random(5); i < n; i++)
+        s += (i ? " , " : "") + randomJson(depth - 1);
+      return s + "]";
+    }
+    default: {
+      std::string s = "{";
+      for (unsigned i = 0, n = random(5); i < n; i++)
+        s += (i ? ",\"k" : "\"k") + std::to_string(i) +
+             "\" : " + randomJson(depth - 1);
+      return s + " }";
+    }
+  }
+}
+
+static void checkRandomDocuments() {
+  for (int t = 0; t < 3000; t++) {
+    std::string input = randomJson(5);
+
+    JsonDocument doc;
+    DeserializationError expectedError = deserializeJson(doc, input);
+    std::string expected;
+    serializeJson(doc, expected);
+
+    Echo echo;
+    CHECK(deserializeJsonEvents(echo, input) == expectedError);
+    CHECK(echo.output == expected);
+
+    std::istringstream stream(input);
+    Echo streamEcho;
+    CHECK(deserializeJsonEvents(streamEcho, stream) == expectedError);
+    CHECK(streamEcho.output == expected);
+
+    // every truncation gives the same error as the DOM parser
+    if (t % 10 == 0) {
+      for (size_t cut = 0; cut < input.size(); cut++) {
+        Echo truncated;
+        CHECK(deserializeJsonEvents(truncated, input.data(), cut) ==
+              deserializeJson(doc, input.data(), cut));
+      }
+    }
+
+    std::string corrupted = input;
+    corrupted[random(unsigned(input.size()))] = "x}]:,\"1"[random(7)];
+    Echo corruptedEcho;
+    CHECK(deserializeJsonEvents(corruptedEcho, corrupted) ==
+          deserializeJson(doc, corrupted));
+  }
+}
+
+int main() {
+  checkRandomDocuments();
+
+  // the handler stops the parsing
+  {
+    Echo echo;
+    echo.stopAfter = 3;
+    CHECK(deserializeJsonEvents(echo, "[1,2,3,4,5]") ==
+          DeserializationError::Ok);
+    CHECK(echo.output == "[1,2");
+  }
+
+  // nesting limit
+  {
+    Echo echo;
+    CHECK(deserializeJsonEvents(echo, "[[[[[]]]]]",
+                                DeserializationOption::NestingLimit(4)) ==
+          DeserializationError::TooDeep);
+  }
+
+  // strings and keys longer than the buffer are truncated
+  {
+    const size_t max = ARDUINOJSON_EVENT_STRING_SIZE - 1;
+    std::string s(300, 'x');
+    Echo echo;
+    CHECK(deserializeJsonEvents(echo, "[\"" + s + "\",{\"" + s + "\":1}]") ==
+          DeserializationError::Ok);
+    std::string t = toJson(s.substr(0, max));
+    CHECK(echo.output == "[" + t + ",{" + t + ":1}]");
+  }
+
+  // but not in the middle of a UTF-8 sequence
+  {
+    const size_t max = ARDUINOJSON_EVENT_STRING_SIZE - 1;
+    std::string s(max - 1, 'x');
+    Echo echo;
+    CHECK(deserializeJsonEvents(echo, "[\"" + s + "\\u00e9\"]") ==
+          DeserializationError::Ok);
+    CHECK(echo.output == "[" + toJson(s) + "]");
+    Echo echo2;
+    CHECK(deserializeJsonEvents(echo2, "[\"" + s + "\\ud83d\\ude00\"]") ==
+          DeserializationError::Ok);
+    CHECK(echo2.output == "[" + toJson(s) + "]");
+    Echo echo3;
+    CHECK(deserializeJsonEvents(echo3, "[\"" + s.substr(2) + "\\u00e9\"]") ==
+          DeserializationError::Ok);
+    CHECK(echo3.output == "[" + toJson(s.substr(2) + "\xC3\xA9") + "]");
+  }
+
+  // unquoted keys
+  {
+    Echo echo;
+    CHECK(deserializeJsonEvents(echo, "{a:1,b_c:[2]}") ==
+          DeserializationError::Ok);
+    CHECK(echo.output == "{\"a\":1,\"b_c\":[2]}");
+  }
+
+  // trailing characters
+  {
+    Echo echo;
+    CHECK(deserializeJsonEvents(echo, "1.5x") ==
+          DeserializationError::InvalidInput);
+  }
+
+  // the default handler accepts everything
+  {
+    JsonEventHandler handler;
+    CHECK(deserializeJsonEvents(handler, "{\"a\":[1,2,{}]}") ==
+          DeserializationError::Ok);
+  }
+
+  return checkResult();
+}
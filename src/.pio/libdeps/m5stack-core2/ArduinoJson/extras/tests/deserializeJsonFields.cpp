@@ -0,0 +1,205 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Binds random documents and compares the struct with the values read from
+// the same documents through a JsonDocument.
+
+#include <ArduinoJson.h>
+
+#include <string.h>
+#include <string>
+
+#include "Check.hpp"
+
+struct Weather {
+  char main[16];
+  char icon[8];
+  char name[32];
+  double temp, tempMin, tempMax;
+  int humidity;
+  uint8_t clouds;
+  bool flag;
+  float wind;
+  long long dt;
+  int secondId;
+  int farId;
+};
+
+static const JsonField<Weather> fields[] = {
+    ARDUINOJSON_FIELD(Weather, main, "weather.0.main"),
+    ARDUINOJSON_FIELD(Weather, icon, "weather.0.icon"),
+    ARDUINOJSON_FIELD(Weather, name, "name"),
+    ARDUINOJSON_FIELD(Weather, temp, "main.temp"),
+    ARDUINOJSON_FIELD(Weather, tempMin, "main.temp_min"),
+    ARDUINOJSON_FIELD(Weather, tempMax, "main.temp_max"),
+    ARDUINOJSON_FIELD(Weather, humidity, "main.humidity"),
+    ARDUINOJSON_FIELD(Weather, clouds, "clouds.all"),
+    ARDUINOJSON_FIELD(Weather, flag, "flag"),
+    ARDUINOJSON_FIELD(Weather, wind, "wind.speed"),
+    ARDUINOJSON_FIELD(Weather, dt, "dt"),
+    ARDUINOJSON_FIELD(Weather, secondId, "weather.1.id"),
+    ARDUINOJSON_FIELD(Weather, farId, "weather.300.id"),
+};
+
+template <typename T>
+static void read(JsonVariantConst value, T& out) {
+  if (value.is<double>())
+    out = value.as<T>();
+}
+
+static void read(JsonVariantConst value, char* out, size_t size) {
+  if (!value.is<const char*>())
+    return;
+  JsonString s = value.as<JsonString>();
+  size_t n = s.size() < size - 1 ? s.size() : size - 1;
+  memcpy(out, s.c_str(), n);
+  out[n] = 0;
+}
+
+// What deserializeJsonFields() must store. The last duplicate key wins in
+// both cases.
+static void readFromDocument(JsonVariantConst doc, Weather& w) {
+  read(doc["weather"][0]["main"], w.main, sizeof(w.main));
+  read(doc["weather"][0]["icon"], w.icon, sizeof(w.icon));
+  read(doc["name"], w.name, sizeof(w.name));
+  read(doc["main"]["temp"], w.temp);
+  read(doc["main"]["temp_min"], w.tempMin);
+  read(doc["main"]["temp_max"], w.tempMax);
+  read(doc["main"]["humidity"], w.humidity);
+  read(doc["clouds"]["all"], w.clouds);
+  if (doc["flag"].is<bool>() || doc["flag"].is<double>())
+    w.flag = doc["flag"].as<bool>();
+  read(doc["wind"]["speed"], w.wind);
+  read(doc["dt"], w.dt);
+  read(doc["weather"][1]["id"], w.secondId);
+  read(doc["weather"][300]["id"], w.farId);
+}
+
+static unsigned seed = 7;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+static std::string randomScalar() {
+  switch (random(7)) {
+    case 0:
+      return std::to_string(int(random(2000)) - 1000);
+    case 1: {
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%.3f", random(100000) / 100.0 - 300);
+      return buffer;
+    }
+    case 2:
+      return random(2) ? "true" : "false";
+    case 3:
+      return "null";
+    case 4: {
+      // up to 300 characters, longer than ARDUINOJSON_EVENT_STRING_SIZE
+      std::string s = "\"";
+      for (unsigned n = random(2) ? random(40) : random(300); n > 0; n--)
+        s += char('a' + random(26));
+      return s + "\"";
+    }
+    case 5:
+      return std::to_string(uint64_t(random(1000000)) * 4000000000ULL);
+    default:
+      return "300";
+  }
+}
+
+static const char* keys[] = {"weather", "main",  "icon", "name",
+                             "temp",    "temp_min", "temp_max", "humidity",
+                             "clouds",  "all",   "flag", "wind",
+                             "speed",   "dt",    "id",   "x"};
+
+static std::string randomJson(int depth) {
+  unsigned kind = depth > 4 ? 9 : random(10);
+  if (kind < 3) {
+    std::string s = "{";
+    unsigned used = 0;
+    for (unsigned i = 0, n = random(6); i < n; i++) {
+      unsigned k;
+      do
+        k = random(16);
+      while ((used >> k) & 1);
+      used |= 1u << k;
+      s += i ? ",\"" : "\"";
+      s += keys[k];
+      s += "\":" + randomJson(depth + 1);
+    }
+    return s + "}";
+  }
+  if (kind < 5) {
+    std::string s = "[";
+    for (unsigned i = 0, n = random(4); i < n; i++)
+      s += (i ? "," : "") + randomJson(depth + 1);
+    return s + "]";
+  }
+  return randomScalar();
+}
+
+static std::string randomWeather() {
+  if (random(3))
+    return randomJson(0);
+  std::string weather = "[" + randomJson(2) + "," + randomJson(2);
+  if (random(4) == 0) {
+    for (int i = 2; i < 300; i++)
+      weather += ",0";
+    weather += "," + randomJson(2);
+  }
+  return "{\"weather\":" + weather + "],\"main\":" + randomJson(1) +
+         ",\"name\":" + randomScalar() + ",\"dt\":" + randomScalar() + "}";
+}
+
+int main() {
+  int documents = 0;
+  for (int i = 0; i < 100000; i++) {
+    std::string json = randomWeather();
+    JsonDocument doc;
+    if (deserializeJson(doc, json))
+      continue;
+    documents++;
+
+    Weather expected, actual;
+    memset(&expected, 0x5a, sizeof(expected));
+    memset(&actual, 0x5a, sizeof(actual));
+    readFromDocument(doc, expected);
+    CHECK(deserializeJsonFields(actual, json, fields) ==
+          DeserializationError::Ok);
+    CHECK(memcmp(&expected, &actual, sizeof(actual)) == 0);
+  }
+  CHECK(documents > 50000);
+
+  // a long value outside the bound paths doesn't fail the bind
+  {
+    std::string json = "{\"description\":\"" + std::string(300, 'x') +
+                       "\",\"" + std::string(300, 'k') +
+                       "\":1,\"name\":\"Paris\"}";
+    Weather w = {};
+    CHECK(deserializeJsonFields(w, json, fields) == DeserializationError::Ok);
+    CHECK(strcmp(w.name, "Paris") == 0);
+  }
+
+  // a long bound value is truncated to the member
+  {
+    std::string name(300, 'n');
+    Weather w = {};
+    CHECK(deserializeJsonFields(w, "{\"name\":\"" + name + "\"}", fields) ==
+          DeserializationError::Ok);
+    CHECK(name.compare(0, sizeof(w.name) - 1, w.name) == 0);
+  }
+
+  // sized input
+  {
+    const char json[] = "{\"main\":{\"temp\":12.5}}garbage";
+    Weather w = {};
+    CHECK(deserializeJsonFields(w, json, 22, fields) ==
+          DeserializationError::Ok);
+    CHECK(w.temp == 12.5);
+  }
+
+  return checkResult();
+}
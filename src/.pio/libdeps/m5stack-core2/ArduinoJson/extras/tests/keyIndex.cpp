@@ -0,0 +1,74 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Random insertions, removals, lookups and clears on objects large enough to
+// be indexed, checked against a std::map.
+
+#define ARDUINOJSON_KEY_INDEX_THRESHOLD 8
+#include <ArduinoJson.h>
+
+#include <map>
+#include <string>
+
+#include "Check.hpp"
+
+static unsigned seed = 3;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+int main() {
+  for (int iteration = 0; iteration < 400; iteration++) {
+    JsonDocument doc;
+    std::map<std::string, int> expected;
+    JsonObject obj = doc.to<JsonObject>();
+    unsigned keys = 1 + random(120);
+
+    for (int i = 0; i < 3000; i++) {
+      std::string key = "k" + std::to_string(random(keys));
+      int value = int(random(1000));
+      switch (random(6)) {
+        case 0:
+        case 1:
+          obj[key] = value;
+          expected[key] = value;
+          break;
+        case 2:
+          obj.remove(key);
+          expected.erase(key);
+          break;
+        case 3:
+          CHECK(obj[key].is<int>() == (expected.count(key) == 1));
+          if (expected.count(key))
+            CHECK(obj[key].as<int>() == expected[key]);
+          break;
+        case 4:
+          if (random(50) == 0) {
+            obj.clear();
+            expected.clear();
+          }
+          break;
+        default:
+          if (random(100) == 0)
+            doc.shrinkToFit();
+          break;
+      }
+    }
+
+    CHECK(obj.size() == expected.size());
+    for (auto& member : expected)
+      CHECK(obj[member.first].as<int>() == member.second);
+  }
+
+  JsonDocument doc;
+  for (int i = 0; i < 50; i++)
+    doc["o"]["k" + std::to_string(i)] = i;
+  doc["o"].as<JsonObject>().remove("k3");
+  CHECK(doc["o"]["k40"] == 40);
+  CHECK(doc["o"]["k3"].isNull());
+
+  return checkResult();
+}
@@ -0,0 +1,263 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Round trips of the Eisel-Lemire parser against strtod() and strtof(), which
+// are correctly rounded on glibc:
+//  - hard cases (subnormals, halfway points, long runs of digits),
+//  - random doubles printed with 1 to 17 digits, and random decimals,
+//  - exact halfway points between consecutive doubles,
+//  - every float below 0x00400000, or every finite float with "exhaustive".
+// Then the contiguous and stream readers must agree on the numbers.
+
+#include <ArduinoJson.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sstream>
+#include <string>
+
+#include "Check.hpp"
+
+using namespace ArduinoJson::detail;
+
+static uint64_t bitsOf(double d) {
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+static uint32_t bitsOf(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+static long failures = 0;
+
+static void checkNumber(const char* s) {
+  Number n = parseNumber(s);
+  bool ok;
+  switch (n.type()) {
+    case NumberType::Double:
+      ok = bitsOf(n.asDouble()) == bitsOf(strtod(s, nullptr));
+      break;
+    case NumberType::Float:
+      ok = bitsOf(n.asFloat()) == bitsOf(strtof(s, nullptr));
+      break;
+    case NumberType::Invalid:
+      ok = false;
+      break;
+    default:
+      ok = true;
+      break;
+  }
+  if (!ok && failures++ < 20)
+    fprintf(stderr, "wrong result for %.80s\n", s);
+}
+
+static void checkNumber(const std::string& s) {
+  checkNumber(s.c_str());
+}
+
+static uint64_t state = 42;
+
+static uint64_t random64() {  // xorshift64*
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 0x2545F4914F6CDD1DULL;
+}
+
+static double randomDouble() {
+  double d;
+  do {
+    uint64_t bits = random64();
+    memcpy(&d, &bits, sizeof(d));
+  } while (isnan(d) || isinf(d));
+  return d;
+}
+
+static void checkHardCases() {
+  static const char* cases[] = {
+      "2.2250738585072011e-308",
+      "2.2250738585072012e-308",
+      "2.2250738585072014e-308",
+      "4.9406564584124654e-324",
+      "2.4703282292062327e-324",
+      "2.4703282292062328e-324",
+      "1.7976931348623157e308",
+      "1.7976931348623158e308",
+      "1.7976931348623159e308",
+      "1e308",
+      "1e309",
+      "1e-400",
+      "0e999999",
+      "7.038531e-26",
+      "3.4028235e38",
+      "3.4028236e38",
+      "1.17549435e-38",
+      "1.4e-45",
+      "0.1",
+      "0.3",
+      "123456789012345678901234567890",
+      "9007199254740993.0",
+      "9007199254740992.5",
+      "8388609.5",
+      "16777217.0",
+      "1.00000005960464477539062499",
+      "1.000000059604644775390625",
+      "1.00000005960464477539062501",
+      "18446744073709551616",
+      "184467440737095516150",
+      "0.000000000000000000000000000000000000000000000001",
+      "-0.0",
+      ".5",
+      "5.",
+      "-.5",
+      "12345678.12345678",
+      "1234567890123456789012.5e-3",
+  };
+  for (const char* s : cases)
+    checkNumber(s);
+  checkNumber("0." + std::string(780, '9') + "e-300");
+  checkNumber("1" + std::string(900, '0') + "e-900");
+  checkNumber("3." + std::string(400, '3') + "1");
+
+  // just below the halfway point between 0 and the smallest subnormal, with
+  // the difference 700 digits away
+  std::string halfway = "2.47032822920623272088284396434110686182529901307162";
+  halfway += "38" + std::string(700, '0') + "1e-324";
+  checkNumber(halfway);
+}
+
+static void checkRandomNumbers(int count) {
+  char buffer[1200];
+  for (int i = 0; i < count; i++) {
+    double d = randomDouble();
+    snprintf(buffer, sizeof(buffer), "%.17g", d);
+    checkNumber(buffer);
+    snprintf(buffer, sizeof(buffer), "%.*g", int(random64() % 17) + 1, d);
+    checkNumber(buffer);
+
+    std::string decimal;
+    if (random64() & 1)
+      decimal += '-';
+    int digits = int(random64() % 30) + 1;
+    int point = int(random64() % unsigned(digits + 1));
+    for (int k = 0; k < digits; k++) {
+      if (k == point && k)
+        decimal += '.';
+      decimal += char('0' + random64() % 10);
+    }
+    if (random64() % 3)
+      decimal += "e" + std::to_string(int(random64() % 700) - 350);
+    checkNumber(decimal);
+
+    snprintf(buffer, sizeof(buffer), "%u.%ue%d", unsigned(random64() % 100000),
+             unsigned(random64() % 100), int(random64() % 80) - 40);
+    checkNumber(buffer);
+  }
+}
+
+static void checkHalfwayPoints(int count) {
+  char buffer[1200];
+  for (int i = 0; i < count; i++) {
+    // long double has a 64-bit mantissa, so 2m+1 is exact
+    uint64_t m = (random64() >> 11) | (uint64_t(1) << 52);
+    int e = int(random64() % 400) - 200;
+    snprintf(buffer, sizeof(buffer), "%.1100Lg",
+             ldexpl(static_cast<long double>(2 * m + 1), e - 1));
+    checkNumber(buffer);
+
+    uint32_t mf = uint32_t(random64() >> 41) | (1u << 23);
+    int ef = int(random64() % 120) - 60;
+    snprintf(buffer, sizeof(buffer), "%.200g",
+             ldexp(double(2 * mf + 1), ef - 1));
+    checkNumber(buffer);
+  }
+}
+
+// Every float printed with 9 significant digits must parse back to itself
+static void checkFloats(uint32_t last) {
+  long floatFailures = 0;
+  for (uint64_t b = 0; b <= last; b++) {
+    uint32_t bits = uint32_t(b);
+    if ((bits & 0x7F800000) == 0x7F800000)
+      continue;  // NaN and infinities
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.8e", double(f));
+    const char* p = buffer;
+    bool negative = *p == '-';
+    if (negative)
+      p++;
+    uint64_t mantissa = uint64_t(p[0] - '0');  // d.dddddddde[+-]XX
+    for (int i = 2; i < 10; i++)
+      mantissa = mantissa * 10 + uint64_t(p[i] - '0');
+    int exponent = atoi(p + 11) - 8;
+    float g = decimalToFloat<float>(mantissa, exponent, false, negative,
+                                    buffer, buffer + length);
+    if (bitsOf(g) != bits && floatFailures++ < 20)
+      fprintf(stderr, "wrong result for %s\n", buffer);
+  }
+  failures += floatFailures;
+}
+
+static void checkReaders() {
+  std::string json = "[";
+  char buffer[32];
+  for (int i = 0; i < 20000; i++) {
+    if (i % 3 == 1)
+      snprintf(buffer, sizeof(buffer), "%lld", (long long)random64());
+    else
+      snprintf(buffer, sizeof(buffer), i % 3 ? "%.17g" : "%.5g",
+               randomDouble());
+    if (i)
+      json += ',';
+    json += buffer;
+  }
+  json += ']';
+
+  JsonDocument a, b;
+  std::istringstream stream(json);
+  CHECK(deserializeJson(a, json.data(), json.size()) ==
+        DeserializationError::Ok);
+  CHECK(deserializeJson(b, stream) == DeserializationError::Ok);
+  CHECK(a == b);
+
+  // both readers stop after 63 characters
+  static const char* inputs[] = {"1.5", "1.5x",         "12",  "-",
+                                 "1e5 ", "[1,}",         "[-]", "1.5,",
+                                 "{\"a\":1.25e2}"};
+  std::string tooLong = "[1" + std::string(70, '0') + "]";
+  std::string longest = "[1." + std::string(61, '0') + "]";
+  for (int i = 0; i < 11; i++) {
+    const char* input = i < 9 ? inputs[i] : i == 9 ? tooLong.c_str()
+                                                   : longest.c_str();
+    JsonDocument d1, d2;
+    std::istringstream s2(input);
+    DeserializationError e1 = deserializeJson(d1, input);
+    DeserializationError e2 = deserializeJson(d2, s2);
+    CHECK(e1 == e2);
+    CHECK(d1 == d2);
+  }
+  JsonDocument doc;
+  CHECK(deserializeJson(doc, tooLong) == DeserializationError::InvalidInput);
+  CHECK(deserializeJson(doc, longest) == DeserializationError::Ok);
+}
+
+int main(int argc, char* argv[]) {
+  bool exhaustive = argc > 1 && !strcmp(argv[1], "exhaustive");
+
+  checkHardCases();
+  checkRandomNumbers(exhaustive ? 2000000 : 100000);
+  checkHalfwayPoints(exhaustive ? 200000 : 20000);
+  checkFloats(exhaustive ? 0xFFFFFFFF : 0x003FFFFF);
+  CHECK(failures == 0);
+  checkReaders();
+
+  return checkResult();
+}
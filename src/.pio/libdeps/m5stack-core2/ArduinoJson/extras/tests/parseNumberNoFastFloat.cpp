@@ -0,0 +1,40 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Without ARDUINOJSON_ENABLE_FAST_FLOAT, the parser keeps the approximation
+// of previous versions: same digits, same results, same range.
+
+#define ARDUINOJSON_ENABLE_FAST_FLOAT 0
+#include <ArduinoJson.h>
+
+#include <math.h>
+
+#include "Check.hpp"
+
+static double parse(const char* json) {
+  JsonDocument doc;
+  CHECK(deserializeJson(doc, json) == DeserializationError::Ok);
+  return doc.as<double>();
+}
+
+int main() {
+  // the range check takes the digits kept into account
+  CHECK(parse("2.2250738585072014e-308") == 2.2250738585072009e-308);
+  CHECK(parse("1e-308") == 1.0000000000000004e-308);
+  CHECK(parse("1e-309") == 0);
+  CHECK(parse("-1e-309") == 0);
+  CHECK(signbit(parse("-1e-309")));
+  CHECK(parse("15e307") == 1.5e308);
+  CHECK(parse("1.7976931348623157e308") == 1.7976931348623151e308);
+  CHECK(isinf(parse("1e309")));
+  CHECK(parse("0e999999") == 0);
+  CHECK(parse("12345678901234567890123") == 1.2345678901234559e22);
+  CHECK(parse("0.1") == double(0.1f));  // fits in a float
+
+  JsonDocument doc;
+  std::string tooLong = "[1" + std::string(70, '0') + "]";
+  CHECK(deserializeJson(doc, tooLong) == DeserializationError::InvalidInput);
+
+  return checkResult();
+}
@@ -0,0 +1,119 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// The contiguous readers scan spaces and strings in blocks, while a stream
+// goes one byte at a time. Both must produce the same document and the same
+// error on any input, including truncated and malformed ones.
+//
+// Linked strings have no size, so the in-place parser copies the strings
+// with an escaped NUL, which must keep their full length.
+
+#include <ArduinoJson.h>
+
+#include <string>
+
+#include "Check.hpp"
+
+struct ByteReader {
+  const char* ptr;
+  const char* end;
+
+  int read() {
+    return ptr < end ? static_cast<unsigned char>(*ptr++) : -1;
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length && ptr < end)
+      buffer[n++] = *ptr++;
+    return n;
+  }
+};
+
+static std::string result(JsonDocument& doc, DeserializationError err) {
+  std::string s = err.c_str();
+  s += ':';
+  serializeJson(doc, s);
+  return s;
+}
+
+static unsigned seed = 1;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+static std::string randomInput(int i) {
+  static const char alphabet[] =
+      " \t\r\n\"\\'abcxyz{}[],:0123456789u-.etrufalsn";
+  std::string input;
+  unsigned length = random(80);
+  if (i % 2) {
+    input = "{\"k" + std::to_string(i) + "\" :  \"";
+    for (unsigned j = 0; j < length; j++) {
+      char c = alphabet[random(sizeof(alphabet) - 1)];
+      input += c == '"' || c == '\\' ? 'a' : c;
+    }
+    input += std::string(random(20), ' ');
+    input += "\", \"b\\n\\u00e9\":[ 1 ,\t\"x\\\"y\" ]  }";
+    if (random(5) == 0)
+      input.resize(random(unsigned(input.size()) + 1));
+  } else {
+    for (unsigned j = 0; j < length; j++)
+      input += alphabet[random(sizeof(alphabet) - 1)];
+  }
+  return input;
+}
+
+static void checkEscapedNul() {
+  static const char* inputs[] = {
+      "{\"a\":\"x\\u0000y\"}",
+      "{\"k\\u0000ey\":1,\"key\":2}",
+      "[\"\\u0000\",\"\\u0000\\u0000\",\"\\n\\u0000z\"]",
+      "{\"\\u0000\":{\"\\u0000\":\"\\u0000\"}}",
+  };
+  for (const char* input : inputs) {
+    JsonDocument doc, inPlace;
+    std::string expected = result(doc, deserializeJson(doc, input));
+    std::string copy = input;
+    CHECK(result(inPlace, deserializeJsonInPlace(inPlace, &copy[0])) ==
+          expected);
+  }
+
+  JsonDocument doc;
+  char input[] = "{\"a\":\"x\\u0000y\",\"b\":\"xy\"}";
+  CHECK(deserializeJsonInPlace(doc, input) == DeserializationError::Ok);
+  CHECK(doc["a"].as<JsonString>().size() == 3);
+  CHECK(doc["a"].as<JsonString>() == JsonString("x\0y", 3));
+  // The other strings are still linked into the input
+  CHECK(doc["b"].as<const char*>() >= input &&
+        doc["b"].as<const char*>() < input + sizeof(input));
+
+  // And a key with a NUL differs from the one it would be cut to
+  char keys[] = "{\"k\\u0000\":1,\"k\":2}";
+  CHECK(deserializeJsonInPlace(doc, keys) == DeserializationError::Ok);
+  CHECK(doc.size() == 2);
+  CHECK(doc["k"] == 2);
+}
+
+int main() {
+  checkEscapedNul();
+
+  for (int i = 0; i < 50000; i++) {
+    std::string input = randomInput(i);
+
+    JsonDocument doc;
+    ByteReader reader = {input.data(), input.data() + input.size()};
+    std::string expected = result(doc, deserializeJson(doc, reader));
+
+    CHECK(result(doc, deserializeJson(doc, input.c_str())) == expected);
+    CHECK(result(doc, deserializeJson(doc, input.data(), input.size())) ==
+          expected);
+    std::string copy = input;
+    CHECK(result(doc, deserializeJsonInPlace(doc, &copy[0], copy.size())) ==
+          expected);
+  }
+  return checkResult();
+}
@@ -0,0 +1,56 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+// Random insertions, replacements and removals with the string pool index
+// enabled: the document must stay equal to its own round trip.
+
+#define ARDUINOJSON_ENABLE_STRING_INDEX 1
+#include <ArduinoJson.h>
+
+#include <string>
+
+#include "Check.hpp"
+
+static unsigned seed = 7;
+
+static unsigned random(unsigned n) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+int main() {
+  for (int iteration = 0; iteration < 300; iteration++) {
+    JsonDocument doc;
+    for (int i = 0; i < 400; i++) {
+      std::string key = "k" + std::to_string(random(60));
+      std::string value = "v" + std::to_string(random(80));
+      switch (random(4)) {
+        case 0:
+          doc[key] = value.c_str();
+          break;
+        case 1:
+          doc[key] = value;
+          break;
+        case 2:
+          doc.remove(key);
+          break;
+        default:
+          doc[key] = 1;
+          break;
+      }
+    }
+
+    std::string output;
+    serializeJson(doc, output);
+    JsonDocument copy;
+    CHECK(deserializeJson(copy, output) == DeserializationError::Ok);
+    std::string roundTrip;
+    serializeJson(copy, roundTrip);
+    CHECK(roundTrip == output);
+
+    copy.shrinkToFit();
+    CHECK(copy == doc);
+  }
+  return checkResult();
+}
@@ -31,6 +31,7 @@
 #include "ArduinoJson/Variant/JsonVariantConst.hpp"
 
 #include "ArduinoJson/Document/JsonDocument.hpp"
+#include "ArduinoJson/Memory/ArenaAllocator.hpp"
 
 #include "ArduinoJson/Array/ArrayImpl.hpp"
 #include "ArduinoJson/Array/ElementProxy.hpp"
@@ -46,11 +47,18 @@
 #include "ArduinoJson/Variant/VariantRefBaseImpl.hpp"
 
 #include "ArduinoJson/Json/JsonDeserializer.hpp"
+#include "ArduinoJson/Json/JsonEventDeserializer.hpp"
+#include "ArduinoJson/Json/JsonFieldBinding.hpp"
 #include "ArduinoJson/Json/JsonSerializer.hpp"
 #include "ArduinoJson/Json/PrettyJsonSerializer.hpp"
 #include "ArduinoJson/MsgPack/MsgPackBinary.hpp"
 #include "ArduinoJson/MsgPack/MsgPackDeserializer.hpp"
 #include "ArduinoJson/MsgPack/MsgPackExtension.hpp"
+#include "ArduinoJson/MsgPack/MsgPackNumbers.hpp"
 #include "ArduinoJson/MsgPack/MsgPackSerializer.hpp"
 
+#if ARDUINOJSON_ENABLE_ARDUINO_PRINT
+#  include "ArduinoJson/Serialization/BufferedPrint.hpp"
+#endif
+
 #include "ArduinoJson/compatibility.hpp"
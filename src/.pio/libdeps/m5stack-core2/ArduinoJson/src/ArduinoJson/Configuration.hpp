@@ -238,6 +238,62 @@
 #  define ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD 1e-5
 #endif
 
+// Index the string pool with a hash table, so deduplicating and releasing a
+// string doesn't walk every string of the document
+// Costs a pointer and a hash per string, plus a table of 2 to 4 pointers per
+// string
+#ifndef ARDUINOJSON_ENABLE_STRING_INDEX
+#  define ARDUINOJSON_ENABLE_STRING_INDEX 0
+#endif
+
+// Index the keys of objects with at least this many members, the first time a
+// lookup has to walk past them (0 disables the index)
+// Costs a table of 2 to 4 slot ids per member, for each indexed object
+#ifndef ARDUINOJSON_KEY_INDEX_THRESHOLD
+#  define ARDUINOJSON_KEY_INDEX_THRESHOLD 0
+#endif
+
+// Scan in-memory input several bytes at a time (SSE2 or NEON on hosts, one
+// machine word elsewhere)
+// Disabled by default on 8-bit platforms because of the increase in code size
+#ifndef ARDUINOJSON_ENABLE_FAST_SCAN
+#  if ARDUINOJSON_SIZEOF_POINTER <= 2
+#    define ARDUINOJSON_ENABLE_FAST_SCAN 0
+#  else
+#    define ARDUINOJSON_ENABLE_FAST_SCAN 1
+#  endif
+#endif
+
+// Parse floats with correct rounding (Eisel-Lemire), and integers eight
+// digits at a time
+// Disabled by default on 8-bit platforms because of the table of powers of
+// five (10 KB of flash)
+#ifndef ARDUINOJSON_ENABLE_FAST_FLOAT
+#  if ARDUINOJSON_SIZEOF_POINTER <= 2
+#    define ARDUINOJSON_ENABLE_FAST_FLOAT 0
+#  else
+#    define ARDUINOJSON_ENABLE_FAST_FLOAT 1
+#  endif
+#endif
+
+// Serialize floats with digits that read back as the same value, usually the
+// fewest (Grisu2 sometimes writes one more: 1e23 becomes 9.999999999999999e22),
+// instead of a fixed number of decimal places (9 for double, 6 for float)
+// Disabled by default because the output differs from previous versions
+#ifndef ARDUINOJSON_ENABLE_SHORTEST_FLOAT
+#  define ARDUINOJSON_ENABLE_SHORTEST_FLOAT 0
+#endif
+
+// Size of the buffer that holds keys and strings for deserializeJsonEvents()
+// Longer strings are truncated
+#ifndef ARDUINOJSON_EVENT_STRING_SIZE
+#  if ARDUINOJSON_SIZEOF_POINTER <= 2
+#    define ARDUINOJSON_EVENT_STRING_SIZE 64
+#  else
+#    define ARDUINOJSON_EVENT_STRING_SIZE 256
+#  endif
+#endif
+
 #ifndef ARDUINOJSON_LITTLE_ENDIAN
 #  if defined(_MSC_VER) ||                           \
       (defined(__BYTE_ORDER__) &&                    \
@@ -29,6 +29,18 @@ class IteratorReader {
       buffer[i++] = *ptr_++;
     return i;
   }
+
+  TIterator position() const {
+    return ptr_;
+  }
+
+  TIterator end() const {
+    return end_;
+  }
+
+  void skip(size_t n) {
+    ptr_ += n;
+  }
 };
 
 template <typename TSource>
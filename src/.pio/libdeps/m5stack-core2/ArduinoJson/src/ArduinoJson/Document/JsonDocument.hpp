@@ -70,6 +70,22 @@ class JsonDocument : public detail::VariantOperators<const JsonDocument&> {
     resources_.shrinkToFit();
   }
 
+  // Rebuilds the document in new pools, with the slots in traversal order
+  // and without the holes left by remove() or the strings nothing refers to.
+  // It needs room for a second copy of the document while it runs.
+  // Returns the number of bytes given back to the allocator, or 0 if the copy
+  // didn't fit, in which case the document is left untouched.
+  size_t compact() {
+    JsonDocument copy(allocator());
+    if (!copy.set(*this) || copy.overflowed())
+      return 0;
+    copy.shrinkToFit();
+    size_t before = resources_.allocatedSize();
+    swap(*this, copy);
+    size_t after = resources_.allocatedSize();
+    return before > after ? before - after : 0;
+  }
+
   // Casts the root to the specified type.
   // https://arduinojson.org/v7/api/jsondocument/as/
   template <typename T>
@@ -0,0 +1,174 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stdint.h>
+#include <string.h>  // memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define ARDUINOJSON_FAST_SCAN_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define ARDUINOJSON_FAST_SCAN_NEON 1
+#endif
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Scans in-memory input a block at a time: 16 bytes with SSE2 or NEON,
+// otherwise one machine word with SWAR (SIMD within a register).
+// The block functions only skip whole blocks; the caller finishes byte by byte,
+// so the result doesn't depend on the endianness or on the block size.
+namespace FastScan {
+
+#if ARDUINOJSON_FAST_SCAN_SSE2
+
+const size_t blockSize = 16;
+const size_t blockAlignment = 1;  // unaligned loads are fine
+
+inline bool isPlainStringBlock(const char* p, char stopChar) {
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i special =
+      _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(stopChar)),
+                   _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\\')),
+                                _mm_cmpeq_epi8(block, _mm_setzero_si128())));
+  return _mm_movemask_epi8(special) == 0;
+}
+
+inline bool isSpaceBlock(const char* p) {
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i spaces =
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                                _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))),
+                   _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')),
+                                _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))));
+  return _mm_movemask_epi8(spaces) == 0xFFFF;
+}
+
+#elif ARDUINOJSON_FAST_SCAN_NEON
+
+const size_t blockSize = 16;
+const size_t blockAlignment = 1;  // unaligned loads are fine
+
+inline bool isPlainStringBlock(const char* p, char stopChar) {
+  uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  uint8x16_t special =
+      vorrq_u8(vceqq_u8(block, vdupq_n_u8(uint8_t(stopChar))),
+               vorrq_u8(vceqq_u8(block, vdupq_n_u8('\\')),
+                        vceqq_u8(block, vdupq_n_u8(0))));
+  return vmaxvq_u8(special) == 0;
+}
+
+inline bool isSpaceBlock(const char* p) {
+  uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  uint8x16_t spaces = vorrq_u8(vorrq_u8(vceqq_u8(block, vdupq_n_u8(' ')),
+                                        vceqq_u8(block, vdupq_n_u8('\n'))),
+                               vorrq_u8(vceqq_u8(block, vdupq_n_u8('\r')),
+                                        vceqq_u8(block, vdupq_n_u8('\t'))));
+  return vminvq_u8(spaces) == 0xFF;
+}
+
+#else
+
+#  if ARDUINOJSON_SIZEOF_POINTER >= 8
+using Word = uint64_t;
+#  else
+using Word = uint32_t;
+#  endif
+
+const size_t blockSize = sizeof(Word);
+const size_t blockAlignment = sizeof(Word);  // Xtensa can't load unaligned
+const Word lowBits = Word(-1) / 0xFF;  // 0x01 in every byte
+const Word highBits = lowBits * 0x80;
+
+inline Word loadWord(const char* p) {
+  Word word;
+#  ifdef __GNUC__
+  // p is aligned, telling the compiler makes this a single load
+  memcpy(&word, __builtin_assume_aligned(p, sizeof(Word)), sizeof(word));
+#  else
+  memcpy(&word, p, sizeof(word));
+#  endif
+  return word;
+}
+
+// Sets the high bit of every byte of x that is zero, without false positives
+inline Word zeroBytes(Word x) {
+  const Word low7 = lowBits * 0x7F;
+  return ~(((x & low7) + low7) | x | low7);
+}
+
+inline Word bytesEqual(Word word, char c) {
+  return zeroBytes(word ^ (lowBits * uint8_t(c)));
+}
+
+inline bool isPlainStringBlock(const char* p, char stopChar) {
+  Word word = loadWord(p);
+  return (zeroBytes(word) | bytesEqual(word, stopChar) |
+          bytesEqual(word, '\\')) == 0;
+}
+
+inline bool isSpaceBlock(const char* p) {
+  Word word = loadWord(p);
+  return (bytesEqual(word, ' ') | bytesEqual(word, '\n') |
+          bytesEqual(word, '\r') | bytesEqual(word, '\t')) == highBits;
+}
+
+#endif
+
+inline bool isAligned(const char* p) {
+  return (uintptr_t(p) & (blockAlignment - 1)) == 0;
+}
+
+inline bool isStringSpecial(char c, char stopChar) {
+  return c == stopChar || c == '\\' || c == '\0';
+}
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Returns the first quote, backslash, or null in [p, end).
+// end is null if the input is null-terminated and its size unknown.
+inline const char* findStringSpecial(const char* p, const char* end,
+                                     char stopChar) {
+  if (end) {
+    while (p < end && !isAligned(p) && !isStringSpecial(*p, stopChar))
+      p++;
+    while (size_t(end - p) >= blockSize && isPlainStringBlock(p, stopChar))
+      p += blockSize;
+    while (p < end && !isStringSpecial(*p, stopChar))
+      p++;
+  } else {
+    // No block loads, they could read past the terminator
+    while (!isStringSpecial(*p, stopChar))
+      p++;
+  }
+  return p;
+}
+
+// Returns the first character in [p, end) that is not a space.
+// end is null if the input is null-terminated and its size unknown.
+inline const char* skipSpaces(const char* p, const char* end) {
+  if (end) {
+    while (p < end && !isAligned(p) && isSpace(*p))
+      p++;
+    while (size_t(end - p) >= blockSize && isSpaceBlock(p))
+      p += blockSize;
+    while (p < end && isSpace(*p))
+      p++;
+  } else {
+    while (isSpace(*p))
+      p++;
+  }
+  return p;
+}
+
+}  // namespace FastScan
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
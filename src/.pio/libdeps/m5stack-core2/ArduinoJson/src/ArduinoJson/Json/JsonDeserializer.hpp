@@ -6,6 +6,7 @@
 
 #include <ArduinoJson/Deserialization/deserialize.hpp>
 #include <ArduinoJson/Json/EscapeSequence.hpp>
+#include <ArduinoJson/Json/FastScan.hpp>
 #include <ArduinoJson/Json/Latch.hpp>
 #include <ArduinoJson/Json/Utf16.hpp>
 #include <ArduinoJson/Json/Utf8.hpp>
@@ -42,7 +43,11 @@ class JsonDeserializer {
     return err;
   }
 
- private:
+ protected:
+  // Contiguous readers skip spaces and plain string characters in bulk
+  using UseFastScan = bool_constant<ARDUINOJSON_ENABLE_FAST_SCAN &&
+                                    IsContiguousReader<TReader>::value>;
+
   char current() {
     return latch_.current();
   }
@@ -255,7 +260,8 @@ class JsonDeserializer {
     // Read each key value pair
     for (;;) {
       // Parse key
-      err = parseKey();
+      JsonString key;
+      err = parseKey(key);
       if (err)
         return err;
 
@@ -268,18 +274,17 @@ class JsonDeserializer {
       if (!eat(':'))
         return DeserializationError::InvalidInput;
 
-      JsonString key = stringBuilder_.str();
-
       TFilter memberFilter = filter[key];
 
       if (memberFilter.allow()) {
         auto member = object.getMember(adaptString(key), resources_);
         if (!member) {
-          // Save key in memory pool.
-          auto savedKey = stringBuilder_.save();
-
-          // Allocate slot in object
-          member = object.addMember(savedKey, resources_);
+          // Allocate slot in object, linking keys parsed in place and saving
+          // the others in memory pool
+          if (key.isStatic())
+            member = object.addMember(adaptString(key), resources_);
+          else
+            member = object.addMember(stringBuilder_.save(), resources_);
           if (!member)
             return DeserializationError::NoMemory;
         } else {
@@ -372,21 +377,40 @@ class JsonDeserializer {
     }
   }
 
-  DeserializationError::Code parseKey() {
+  DeserializationError::Code parseKey(JsonString& key) {
+    return parseKey(key, IsInPlaceReader<TReader>());
+  }
+
+  DeserializationError::Code parseKey(JsonString& key, true_type) {
+    // Non-quoted keys have no closing quote to put the terminator on
+    if (isQuote(current()))
+      return parseQuotedStringInPlace(key);
+    return parseKey(key, false_type());
+  }
+
+  DeserializationError::Code parseKey(JsonString& key, false_type) {
+    DeserializationError::Code err;
+
     stringBuilder_.startString();
-    if (isQuote(current())) {
-      return parseQuotedString();
-    } else {
-      return parseNonQuotedString();
-    }
+    if (isQuote(current()))
+      err = parseQuotedString(stringBuilder_);
+    else
+      err = parseNonQuotedString(stringBuilder_);
+    key = stringBuilder_.str();
+    return err;
   }
 
   DeserializationError::Code parseStringValue(VariantData& variant) {
+    return parseStringValue(variant, IsInPlaceReader<TReader>());
+  }
+
+  DeserializationError::Code parseStringValue(VariantData& variant,
+                                              false_type) {
     DeserializationError::Code err;
 
     stringBuilder_.startString();
 
-    err = parseQuotedString();
+    err = parseQuotedString(stringBuilder_);
     if (err)
       return err;
 
@@ -395,7 +419,92 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
-  DeserializationError::Code parseQuotedString() {
+  DeserializationError::Code parseStringValue(VariantData& variant,
+                                              true_type) {
+    DeserializationError::Code err;
+    JsonString str;
+
+    err = parseQuotedStringInPlace(str);
+    if (err)
+      return err;
+
+    if (str.isStatic())
+      variant.setLinkedString(str.c_str());
+    else
+      variant.setOwnedString(stringBuilder_.save());
+
+    return DeserializationError::Ok;
+  }
+
+  // Writes the unescaped characters over the input they were read from.
+  // Escape sequences are never shorter than what they decode to, so the
+  // writer always stays behind the reader.
+  class InPlaceStringWriter {
+   public:
+    InPlaceStringWriter(char* ptr) : ptr_(ptr) {}
+
+    void append(char c) {
+      if (c == 0)  // only "\u0000" decodes to it
+        hasNul_ = true;
+      *ptr_++ = c;
+    }
+
+    void append(const char* s, size_t n) {
+      if (s != ptr_)  // no escape sequence so far
+        memmove(ptr_, s, n);
+      ptr_ += n;
+    }
+
+    bool isValid() const {
+      return true;
+    }
+
+    char* ptr() const {
+      return ptr_;
+    }
+
+    bool hasNul() const {
+      return hasNul_;
+    }
+
+   private:
+    char* ptr_;
+    bool hasNul_ = false;
+  };
+
+  // Returns a linked string, or, when it contains a NUL that a linked string
+  // would stop at, a copy in the string builder that the caller must save.
+  DeserializationError::Code parseQuotedStringInPlace(JsonString& result) {
+    DeserializationError::Code err;
+
+    // The opening quote is in the latch, so the reader points just after it
+    ARDUINOJSON_ASSERT(isQuote(current()));
+    char* start = latch_.reader().position();
+    InPlaceStringWriter writer(start);
+
+    err = parseQuotedString(writer);
+    if (err)
+      return err;
+
+    size_t size = size_t(writer.ptr() - start);
+    if (writer.hasNul()) {
+      stringBuilder_.startString();
+      stringBuilder_.append(start, size);
+      if (!stringBuilder_.isValid())
+        return DeserializationError::NoMemory;
+      result = stringBuilder_.str();
+      return DeserializationError::Ok;
+    }
+
+    // Overwrites the closing quote at the latest
+    *writer.ptr() = 0;
+    result = JsonString(start, size, true);
+
+    return DeserializationError::Ok;
+  }
+
+  template <typename TStringBuilder>
+  DeserializationError::Code parseQuotedString(TStringBuilder& builder) {
 #if ARDUINOJSON_DECODE_UNICODE
     Utf16::Codepoint codepoint;
     DeserializationError::Code err;
@@ -404,6 +513,8 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+      appendStringRun(builder, stopChar, UseFastScan());
+
       char c = current();
       move();
       if (c == stopChar)
@@ -426,9 +537,11 @@ class JsonDeserializer {
           if (err)
             return err;
           if (codepoint.append(codeunit))
-            Utf8::encodeCodepoint(codepoint.value(), stringBuilder_);
+            Utf8::encodeCodepoint(codepoint.value(), builder);
 #else
-          stringBuilder_.append('\\');
+          builder.append('\\');
+          builder.append('u');
+          move();
 #endif
           continue;
         }
@@ -440,30 +553,31 @@ class JsonDeserializer {
         move();
       }
 
-      stringBuilder_.append(c);
+      builder.append(c);
     }
 
-    if (!stringBuilder_.isValid())
+    if (!builder.isValid())
       return DeserializationError::NoMemory;
 
     return DeserializationError::Ok;
   }
 
-  DeserializationError::Code parseNonQuotedString() {
+  template <typename TStringBuilder>
+  DeserializationError::Code parseNonQuotedString(TStringBuilder& builder) {
     char c = current();
     ARDUINOJSON_ASSERT(c);
 
     if (canBeInNonQuotedString(c)) {  // no quotes
       do {
         move();
-        stringBuilder_.append(c);
+        builder.append(c);
         c = current();
       } while (canBeInNonQuotedString(c));
     } else {
       return DeserializationError::InvalidInput;
     }
 
-    if (!stringBuilder_.isValid())
+    if (!builder.isValid())
       return DeserializationError::NoMemory;
 
     return DeserializationError::Ok;
@@ -482,6 +596,8 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+      skipStringRun(stopChar, UseFastScan());
+
       char c = current();
       move();
       if (c == stopChar)
@@ -489,8 +605,9 @@ class JsonDeserializer {
       if (c == '\0')
         return DeserializationError::IncompleteInput;
       if (c == '\\') {
-        if (current() != '\0')
-          move();
+        if (current() == '\0')
+          return DeserializationError::IncompleteInput;
+        move();
       }
     }
 
@@ -507,17 +624,7 @@ class JsonDeserializer {
   }
 
   DeserializationError::Code parseNumericValue(VariantData& result) {
-    uint8_t n = 0;
-
-    char c = current();
-    while (canBeInNumber(c) && n < 63) {
-      move();
-      buffer_[n++] = c;
-      c = current();
-    }
-    buffer_[n] = 0;
-
-    auto number = parseNumber(buffer_);
+    auto number = readNumber(IsContiguousReader<TReader>());
     switch (number.type()) {
       case NumberType::UnsignedInteger:
         if (result.setInteger(number.asUnsignedInteger(), resources_))
@@ -550,6 +657,39 @@ class JsonDeserializer {
     }
   }
 
+  // Copies the number to buffer_, then parses it
+  Number readNumber(false_type) {
+    uint8_t n = 0;
+
+    char c = current();
+    while (canBeInNumber(c) && n < 63) {
+      move();
+      buffer_[n++] = c;
+      c = current();
+    }
+    buffer_[n] = 0;
+
+    return parseNumber(buffer_, buffer_ + n);
+  }
+
+  // Parses the number straight from the input
+  // Stops after 63 characters, like the copying version, so that both
+  // accept and reject the same inputs
+  Number readNumber(true_type) {
+    if (!canBeInNumber(current()))
+      return Number();
+    auto& reader = latch_.reader();
+    move();
+    const char* begin = reader.position() - 1;  // the latch read current()
+    const char* end = reader.end();
+    const char* p = begin + 1;
+    while (p - begin < 63 && (!end || p < end) && canBeInNumber(*p))
+      p++;
+    reader.skip(size_t(p - begin - 1));
+    current();  // load the next character, like the copying version
+    return parseNumber(begin, p);
+  }
+
   DeserializationError::Code skipNumericValue() {
     char c = current();
     while (canBeInNumber(c)) {
@@ -603,6 +743,39 @@ class JsonDeserializer {
     return uint8_t(c - 'A' + 10);
   }
 
+  // The fast scan functions below read straight from the reader, so they
+  // must be called when the latch is empty, i.e., right after move()
+
+  template <typename TStringBuilder>
+  void appendStringRun(TStringBuilder&, char, false_type) {}
+
+  template <typename TStringBuilder>
+  void appendStringRun(TStringBuilder& builder, char stopChar, true_type) {
+    auto& reader = latch_.reader();
+    const char* p = reader.position();
+    size_t n =
+        size_t(FastScan::findStringSpecial(p, reader.end(), stopChar) - p);
+    builder.append(p, n);
+    reader.skip(n);
+  }
+
+  void skipStringRun(char, false_type) {}
+
+  void skipStringRun(char stopChar, true_type) {
+    auto& reader = latch_.reader();
+    const char* p = reader.position();
+    reader.skip(
+        size_t(FastScan::findStringSpecial(p, reader.end(), stopChar) - p));
+  }
+
+  void skipSpaces(false_type) {}
+
+  void skipSpaces(true_type) {
+    auto& reader = latch_.reader();
+    const char* p = reader.position();
+    reader.skip(size_t(FastScan::skipSpaces(p, reader.end()) - p));
+  }
+
   DeserializationError::Code skipSpacesAndComments() {
     for (;;) {
       switch (current()) {
@@ -617,6 +790,7 @@ class JsonDeserializer {
         case '\r':
         case '\n':
           move();
+          skipSpaces(UseFastScan());
           continue;
 
 #if ARDUINOJSON_ENABLE_COMMENTS
@@ -719,4 +893,37 @@ inline DeserializationError deserializeJson(TDestination&& dst, TChar* input,
                                        input, detail::forward<Args>(args)...);
 }
 
+// Parses a mutable JSON input in place and puts the result in a JsonDocument.
+// Strings are unescaped inside the input and linked instead of copied, so the
+// input must stay alive and unchanged for as long as the document uses it.
+template <typename TDestination, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value &&
+                  !detail::is_integral<
+                      typename detail::first_or_void<Args...>::type>::value,
+              int> = 0>
+inline DeserializationError deserializeJsonInPlace(TDestination&& dst,
+                                                   char* input, Args... args) {
+  using namespace detail;
+  return doDeserialize<JsonDeserializer>(
+      dst, InPlaceReader(input, input ? input + ::strlen(input) : input),
+      makeDeserializationOptions(args...));
+}
+
+// Parses a mutable JSON input of a given size in place and puts the result in
+// a JsonDocument.
+template <typename TDestination, typename Size, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value &&
+                  detail::is_integral<Size>::value,
+              int> = 0>
+inline DeserializationError deserializeJsonInPlace(TDestination&& dst,
+                                                   char* input, Size inputSize,
+                                                   Args... args) {
+  using namespace detail;
+  return doDeserialize<JsonDeserializer>(
+      dst, InPlaceReader(input, input + size_t(inputSize)),
+      makeDeserializationOptions(args...));
+}
+
 ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,392 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/JsonDeserializer.hpp>
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// The callbacks of deserializeJsonEvents().
+// Derive from this class and redefine the callbacks you need; the others
+// accept everything. A callback returns false to stop the parsing.
+// Keys and strings are only valid during the call. They are truncated to
+// ARDUINOJSON_EVENT_STRING_SIZE - 1 bytes, on a UTF-8 character boundary.
+struct JsonEventHandler {
+  bool onStartObject() {
+    return true;
+  }
+
+  bool onEndObject() {
+    return true;
+  }
+
+  bool onStartArray() {
+    return true;
+  }
+
+  bool onEndArray() {
+    return true;
+  }
+
+  bool onKey(JsonString) {
+    return true;
+  }
+
+  bool onString(JsonString) {
+    return true;
+  }
+
+  bool onInteger(JsonInteger) {
+    return true;
+  }
+
+  bool onUnsignedInteger(JsonUInt) {
+    return true;
+  }
+
+  bool onFloat(JsonFloat) {
+    return true;
+  }
+
+  bool onBoolean(bool) {
+    return true;
+  }
+
+  bool onNull() {
+    return true;
+  }
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Reuses the tokenizer of JsonDeserializer, but reports the values to a
+// handler instead of storing them in a document.
+// It never allocates: strings go through a fixed buffer that truncates them,
+// and the nesting limit bounds the recursion, like for deserializeJson().
+template <typename TReader, typename THandler>
+class JsonEventDeserializer : public JsonDeserializer<TReader> {
+  using base = JsonDeserializer<TReader>;
+
+ public:
+  JsonEventDeserializer(TReader reader, THandler& handler)
+      : base(nullptr, reader), handler_(&handler) {}
+
+  DeserializationError parse(DeserializationOption::NestingLimit nestingLimit) {
+    bool isNumber = false;
+    DeserializationError::Code err = parseValue(nestingLimit, isNumber);
+
+    if (stopped_)
+      return DeserializationError::Ok;
+
+    if (!err && base::latch_.last() != 0 && isNumber) {
+      // We don't detect trailing characters earlier, so we need to check now
+      return DeserializationError::InvalidInput;
+    }
+
+    return err;
+  }
+
+ private:
+  // Keeps the first ARDUINOJSON_EVENT_STRING_SIZE - 1 bytes of a string, so
+  // that a long string doesn't fail the whole document
+  class FixedStringBuilder {
+   public:
+    void startString() {
+      size_ = 0;
+      truncated_ = false;
+    }
+
+    void append(char c) {
+      if (size_ < sizeof(data_) - 1)
+        data_[size_++] = c;
+      else
+        truncated_ = true;
+    }
+
+    void append(const char* s, size_t n) {
+      if (n > sizeof(data_) - 1 - size_) {
+        n = sizeof(data_) - 1 - size_;
+        truncated_ = true;
+      }
+      memcpy(data_ + size_, s, n);
+      size_ += n;
+    }
+
+    bool isValid() const {
+      return true;
+    }
+
+    JsonString str() {
+      if (truncated_)
+        dropPartialCharacter();
+      data_[size_] = 0;
+      return JsonString(data_, size_);
+    }
+
+   private:
+    // Removes the UTF-8 sequence that the truncation cut
+    void dropPartialCharacter() {
+      size_t start = size_;
+      while (start > 0 && (data_[start - 1] & 0xC0) == 0x80)
+        start--;
+      if (start == 0 || (data_[start - 1] & 0x80) == 0)
+        return;  // plain ASCII
+      uint8_t lead = uint8_t(data_[start - 1]);
+      size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+      if (size_ - (start - 1) < length)
+        size_ = start - 1;
+    }
+
+    char data_[ARDUINOJSON_EVENT_STRING_SIZE];
+    size_t size_ = 0;
+    bool truncated_ = false;
+  };
+
+  // Unwinds the recursion when the handler returns false
+  DeserializationError::Code emit(bool accepted) {
+    if (accepted)
+      return DeserializationError::Ok;
+    stopped_ = true;
+    return DeserializationError::InvalidInput;  // ignored by parse()
+  }
+
+  DeserializationError::Code parseValue(
+      DeserializationOption::NestingLimit nestingLimit, bool& isNumber) {
+    DeserializationError::Code err;
+
+    err = base::skipSpacesAndComments();
+    if (err)
+      return err;
+
+    switch (base::current()) {
+      case '[':
+        return parseArray(nestingLimit);
+
+      case '{':
+        return parseObject(nestingLimit);
+
+      case '\"':
+      case '\'':
+        string_.startString();
+        err = base::parseQuotedString(string_);
+        if (err)
+          return err;
+        return emit(handler_->onString(string_.str()));
+
+      case 't':
+        err = base::skipKeyword("true");
+        if (err)
+          return err;
+        return emit(handler_->onBoolean(true));
+
+      case 'f':
+        err = base::skipKeyword("false");
+        if (err)
+          return err;
+        return emit(handler_->onBoolean(false));
+
+      case 'n':
+        err = base::skipKeyword("null");
+        if (err)
+          return err;
+        return emit(handler_->onNull());
+
+      default:
+        return parseNumericValue(isNumber);
+    }
+  }
+
+  DeserializationError::Code parseArray(
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    // Skip opening braket
+    ARDUINOJSON_ASSERT(base::current() == '[');
+    base::move();
+
+    err = emit(handler_->onStartArray());
+    if (err)
+      return err;
+
+    // Skip spaces
+    err = base::skipSpacesAndComments();
+    if (err)
+      return err;
+
+    // Empty array?
+    if (base::eat(']'))
+      return emit(handler_->onEndArray());
+
+    // Read each value
+    for (;;) {
+      // 1 - Parse value
+      bool isNumber;
+      err = parseValue(nestingLimit.decrement(), isNumber);
+      if (err)
+        return err;
+
+      // 2 - Skip spaces
+      err = base::skipSpacesAndComments();
+      if (err)
+        return err;
+
+      // 3 - More values?
+      if (base::eat(']'))
+        return emit(handler_->onEndArray());
+      if (!base::eat(','))
+        return DeserializationError::InvalidInput;
+    }
+  }
+
+  DeserializationError::Code parseObject(
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    // Skip opening brace
+    ARDUINOJSON_ASSERT(base::current() == '{');
+    base::move();
+
+    err = emit(handler_->onStartObject());
+    if (err)
+      return err;
+
+    // Skip spaces
+    err = base::skipSpacesAndComments();
+    if (err)
+      return err;
+
+    // Empty object?
+    if (base::eat('}'))
+      return emit(handler_->onEndObject());
+
+    // Read each key value pair
+    for (;;) {
+      // Parse key
+      string_.startString();
+      if (base::isQuote(base::current()))
+        err = base::parseQuotedString(string_);
+      else
+        err = base::parseNonQuotedString(string_);
+      if (err)
+        return err;
+
+      err = emit(handler_->onKey(string_.str()));
+      if (err)
+        return err;
+
+      // Skip spaces
+      err = base::skipSpacesAndComments();
+      if (err)
+        return err;
+
+      // Colon
+      if (!base::eat(':'))
+        return DeserializationError::InvalidInput;
+
+      // Parse value
+      bool isNumber;
+      err = parseValue(nestingLimit.decrement(), isNumber);
+      if (err)
+        return err;
+
+      // Skip spaces
+      err = base::skipSpacesAndComments();
+      if (err)
+        return err;
+
+      // More keys/values?
+      if (base::eat('}'))
+        return emit(handler_->onEndObject());
+      if (!base::eat(','))
+        return DeserializationError::InvalidInput;
+
+      // Skip spaces
+      err = base::skipSpacesAndComments();
+      if (err)
+        return err;
+    }
+  }
+
+  DeserializationError::Code parseNumericValue(bool& isNumber) {
+    auto number = base::readNumber(IsContiguousReader<TReader>());
+    isNumber = true;
+    switch (number.type()) {
+      case NumberType::UnsignedInteger:
+        return emit(handler_->onUnsignedInteger(number.asUnsignedInteger()));
+
+      case NumberType::SignedInteger:
+        return emit(handler_->onInteger(number.asSignedInteger()));
+
+      case NumberType::Float:
+        return emit(handler_->onFloat(number.asFloat()));
+
+#if ARDUINOJSON_USE_DOUBLE
+      case NumberType::Double:
+        return emit(handler_->onFloat(number.asDouble()));
+#endif
+
+      default:
+        return DeserializationError::InvalidInput;
+    }
+  }
+
+  THandler* handler_;
+  FixedStringBuilder string_;
+  bool stopped_ = false;
+};
+
+template <typename THandler, typename TReader>
+DeserializationError doDeserializeEvents(
+    THandler& handler, TReader reader,
+    DeserializationOption::NestingLimit nestingLimit) {
+  return JsonEventDeserializer<TReader, THandler>(reader, handler)
+      .parse(nestingLimit);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Parses a JSON input and calls the handler for each value, without building
+// a document, so the input can be arbitrarily large.
+// See JsonEventHandler for the callbacks.
+template <typename THandler, typename TInput>
+inline DeserializationError deserializeJsonEvents(
+    THandler& handler, TInput&& input,
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  using namespace detail;
+  return doDeserializeEvents(handler, makeReader(detail::forward<TInput>(input)),
+                             nestingLimit);
+}
+
+// Parses a JSON input and calls the handler for each value.
+template <typename THandler, typename TChar>
+inline DeserializationError deserializeJsonEvents(
+    THandler& handler, TChar* input,
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  using namespace detail;
+  return doDeserializeEvents(handler, makeReader(input), nestingLimit);
+}
+
+// Parses a JSON input of a given size and calls the handler for each value.
+template <typename THandler, typename TChar, typename Size,
+          detail::enable_if_t<detail::is_integral<Size>::value, int> = 0>
+inline DeserializationError deserializeJsonEvents(
+    THandler& handler, TChar* input, Size inputSize,
+    DeserializationOption::NestingLimit nestingLimit = {}) {
+  using namespace detail;
+  return doDeserializeEvents(handler, makeReader(input, size_t(inputSize)),
+                             nestingLimit);
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -32,6 +32,10 @@ class Latch {
     return current_;
   }
 
+  TReader& reader() {
+    return reader_;
+  }
+
  private:
   void load() {
     ARDUINOJSON_ASSERT(!ended_);
@@ -0,0 +1,164 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/Allocator.hpp>
+
+#include <stdint.h>  // uintptr_t
+#include <string.h>  // memcpy
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Strict enough for any member of a slot, including 64-bit extensions
+union ArenaMaxAlign {
+  void* pointer;
+  double real;
+  uint64_t integer;
+};
+
+constexpr size_t arenaAlignUp(size_t n) {
+  return (n + alignof(ArenaMaxAlign) - 1) & ~(alignof(ArenaMaxAlign) - 1);
+}
+
+// Precedes every block of an ArenaAllocator
+struct ArenaBlock {
+  size_t size;  // padded size of the block, bit 0 set once deallocated
+  size_t prev;  // offset of the previous block
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// A monotonic allocator that bump-allocates from a caller-provided buffer,
+// so a document that is rebuilt over and over never touches the heap.
+// Freed blocks at the end of the buffer are given back immediately, which
+// lets a document be cleared and refilled; the rest is reclaimed by reset().
+//
+// The buffer must outlive the allocator, and every JsonDocument using the
+// allocator must be destroyed or cleared before reset().
+class ArenaAllocator : public Allocator {
+ public:
+  ArenaAllocator(void* buffer, size_t capacity) {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(buffer);
+    uintptr_t aligned = detail::arenaAlignUp(begin);
+    if (!buffer || capacity < aligned - begin)
+      return;
+    buffer_ = reinterpret_cast<char*>(aligned);
+    capacity_ = capacity - (aligned - begin);
+  }
+
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  void operator=(const ArenaAllocator&) = delete;
+
+  ~ArenaAllocator() = default;
+
+  void* allocate(size_t size) override {
+    size_t available = capacity_ - used_;
+    if (available < headerSize || size > available - headerSize ||
+        detail::arenaAlignUp(size) > available - headerSize)
+      return nullptr;
+    size_t offset = used_;
+    auto block = blockAt(offset);
+    block->size = detail::arenaAlignUp(size);
+    block->prev = last_;
+    last_ = offset;
+    setUsed(offset + headerSize + block->size);
+    return payloadOf(block);
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr)
+      return;
+    blockOf(ptr)->size |= freedFlag;
+    while (last_ != noBlock && (blockAt(last_)->size & freedFlag)) {
+      used_ = last_;
+      last_ = blockAt(last_)->prev;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t new_size) override {
+    if (!ptr)
+      return allocate(new_size);
+
+    auto block = blockOf(ptr);
+    size_t offset = offsetOf(block);
+    if (offset == last_) {  // grow or shrink in place
+      size_t available = capacity_ - offset - headerSize;
+      if (new_size > available || detail::arenaAlignUp(new_size) > available)
+        return nullptr;
+      block->size = detail::arenaAlignUp(new_size);
+      setUsed(offset + headerSize + block->size);
+      return ptr;
+    }
+
+    if (new_size <= block->size)  // the tail is lost until reset()
+      return ptr;
+
+    void* newPtr = allocate(new_size);
+    if (newPtr) {
+      memcpy(newPtr, ptr, block->size);
+      deallocate(ptr);
+    }
+    return newPtr;
+  }
+
+  // Forgets every block in O(1)
+  void reset() {
+    used_ = 0;
+    last_ = noBlock;
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  // Bytes currently in use, block headers and padding included
+  size_t used() const {
+    return used_;
+  }
+
+  // Largest value of used() since the allocator was created
+  size_t highWaterMark() const {
+    return highWaterMark_;
+  }
+
+ private:
+  static constexpr size_t headerSize =
+      detail::arenaAlignUp(sizeof(detail::ArenaBlock));
+  static constexpr size_t freedFlag = 1;
+  static constexpr size_t noBlock = size_t(-1);
+
+  detail::ArenaBlock* blockAt(size_t offset) const {
+    return reinterpret_cast<detail::ArenaBlock*>(buffer_ + offset);
+  }
+
+  static detail::ArenaBlock* blockOf(void* ptr) {
+    return reinterpret_cast<detail::ArenaBlock*>(static_cast<char*>(ptr) -
+                                                 headerSize);
+  }
+
+  static void* payloadOf(detail::ArenaBlock* block) {
+    return reinterpret_cast<char*>(block) + headerSize;
+  }
+
+  size_t offsetOf(detail::ArenaBlock* block) const {
+    return size_t(reinterpret_cast<char*>(block) - buffer_);
+  }
+
+  void setUsed(size_t used) {
+    used_ = used;
+    if (used > highWaterMark_)
+      highWaterMark_ = used;
+  }
+
+  char* buffer_ = nullptr;
+  size_t capacity_ = 0;
+  size_t used_ = 0;
+  size_t last_ = noBlock;
+  size_t highWaterMark_ = 0;
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
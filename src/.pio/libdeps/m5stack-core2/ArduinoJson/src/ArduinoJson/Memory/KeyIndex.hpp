@@ -0,0 +1,127 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/Allocator.hpp>
+#include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+
+#include <stddef.h>  // offsetof
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+class CollectionData;
+
+// Open-addressing hash table from the keys of one wide object to their slots.
+// ObjectData builds it lazily and keeps it in sync; see findKey().
+struct KeyIndex {
+  KeyIndex* next;
+  const CollectionData* object;
+  size_t capacity;  // power of two
+  size_t count;
+  SlotId slots[1];  // key slots, NULL_SLOT if empty
+
+  static constexpr size_t sizeForCapacity(size_t n) {
+    return offsetof(KeyIndex, slots) + n * sizeof(SlotId);
+  }
+
+  size_t mask() const {
+    return capacity - 1;
+  }
+
+  static KeyIndex* create(const CollectionData* object, size_t capacity,
+                          Allocator* allocator) {
+    ARDUINOJSON_ASSERT((capacity & (capacity - 1)) == 0);
+    auto index = reinterpret_cast<KeyIndex*>(
+        allocator->allocate(sizeForCapacity(capacity)));
+    if (index) {
+      index->object = object;
+      index->capacity = capacity;
+      index->count = 0;
+      for (size_t i = 0; i < capacity; i++)
+        index->slots[i] = NULL_SLOT;
+    }
+    return index;
+  }
+
+  static void destroy(KeyIndex* index, Allocator* allocator) {
+    allocator->deallocate(index);
+  }
+};
+
+// The key indexes of a document, most recently used first.
+// Indexes are a cache: they are dropped whenever slots may move.
+class KeyIndexList {
+ public:
+  KeyIndexList() = default;
+  KeyIndexList(const KeyIndexList&) = delete;
+  void operator=(const KeyIndexList&) = delete;
+
+  ~KeyIndexList() {
+    ARDUINOJSON_ASSERT(head_ == nullptr);
+  }
+
+  KeyIndex* find(const CollectionData* object) {
+    KeyIndex* prev = nullptr;
+    for (auto index = head_; index; index = index->next) {
+      if (index->object == object) {
+        if (prev) {  // move to front
+          prev->next = index->next;
+          index->next = head_;
+          head_ = index;
+        }
+        return index;
+      }
+      prev = index;
+    }
+    return nullptr;
+  }
+
+  KeyIndex* create(const CollectionData* object, size_t capacity,
+                   Allocator* allocator) {
+    ARDUINOJSON_ASSERT(find(object) == nullptr);
+    auto index = KeyIndex::create(object, capacity, allocator);
+    if (index) {
+      index->next = head_;
+      head_ = index;
+    }
+    return index;
+  }
+
+  void remove(const CollectionData* object, Allocator* allocator) {
+    KeyIndex* prev = nullptr;
+    for (auto index = head_; index; index = index->next) {
+      if (index->object == object) {
+        if (prev)
+          prev->next = index->next;
+        else
+          head_ = index->next;
+        KeyIndex::destroy(index, allocator);
+        return;
+      }
+      prev = index;
+    }
+  }
+
+  void clear(Allocator* allocator) {
+    while (head_) {
+      auto index = head_;
+      head_ = index->next;
+      KeyIndex::destroy(index, allocator);
+    }
+  }
+
+  size_t size() const {
+    size_t total = 0;
+    for (auto index = head_; index; index = index->next)
+      total += KeyIndex::sizeForCapacity(index->capacity);
+    return total;
+  }
+
+ private:
+  KeyIndex* head_ = nullptr;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Memory/Allocator.hpp>
+#include <ArduinoJson/Memory/KeyIndex.hpp>
 #include <ArduinoJson/Memory/MemoryPoolList.hpp>
 #include <ArduinoJson/Memory/StringPool.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
@@ -32,6 +33,9 @@ class ResourceManager {
       : allocator_(allocator), overflowed_(false) {}
 
   ~ResourceManager() {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+    keyIndexes_.clear(allocator_);
+#endif
     stringPool_.clear(allocator_);
     variantPools_.clear(allocator_);
   }
@@ -40,6 +44,11 @@ class ResourceManager {
   ResourceManager& operator=(const ResourceManager& src) = delete;
 
   friend void swap(ResourceManager& a, ResourceManager& b) {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+    // The root objects don't follow their resources
+    a.keyIndexes_.clear(a.allocator_);
+    b.keyIndexes_.clear(b.allocator_);
+#endif
     swap(a.stringPool_, b.stringPool_);
     swap(a.variantPools_, b.variantPools_);
     swap_(a.allocator_, b.allocator_);
@@ -51,7 +60,21 @@ class ResourceManager {
   }
 
   size_t size() const {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+    return variantPools_.size() + stringPool_.size() + keyIndexes_.size();
+#else
     return variantPools_.size() + stringPool_.size();
+#endif
+  }
+
+  // Like size(), but also counts the free slots of the pools
+  size_t allocatedSize() const {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+    return variantPools_.allocatedSize() + stringPool_.size() +
+           keyIndexes_.size();
+#else
+    return variantPools_.allocatedSize() + stringPool_.size();
+#endif
   }
 
   bool overflowed() const {
@@ -81,7 +104,7 @@ class ResourceManager {
   }
 
   void saveString(StringNode* node) {
-    stringPool_.add(node);
+    stringPool_.add(node, allocator_);
   }
 
   template <typename TAdaptedString>
@@ -111,13 +134,35 @@ class ResourceManager {
     stringPool_.dereference(s, allocator_);
   }
 
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  // Key indexes are a lookup cache, so they can be built from const methods
+  KeyIndex* getKeyIndex(const CollectionData* object) const {
+    return keyIndexes_.find(object);
+  }
+
+  KeyIndex* createKeyIndex(const CollectionData* object,
+                           size_t capacity) const {
+    return keyIndexes_.create(object, capacity, allocator_);
+  }
+
+  void dropKeyIndex(const CollectionData* object) const {
+    keyIndexes_.remove(object, allocator_);
+  }
+#endif
+
   void clear() {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+    keyIndexes_.clear(allocator_);
+#endif
     variantPools_.clear(allocator_);
     overflowed_ = false;
     stringPool_.clear(allocator_);
   }
 
   void shrinkToFit() {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+    keyIndexes_.clear(allocator_);  // the slots may move
+#endif
     variantPools_.shrinkToFit(allocator_);
   }
 
@@ -126,6 +171,9 @@ class ResourceManager {
   bool overflowed_;
   StringPool stringPool_;
   MemoryPoolList<SlotData> variantPools_;
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  mutable KeyIndexList keyIndexes_;
+#endif
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -6,6 +6,8 @@
 
 #include <ArduinoJson/Memory/ResourceManager.hpp>
 
+#include <string.h>  // memcpy
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 class StringBuilder {
@@ -46,8 +48,16 @@ class StringBuilder {
   }
 
   void append(const char* s, size_t n) {
-    while (n-- > 0)  // TODO: memcpy
-      append(*s++);
+    if (node_ && size_ + n > node_->length) {
+      size_t capacity = node_->length;
+      while (capacity < size_ + n)
+        capacity = capacity * 2U + 1;  // same growth as append(char)
+      node_ = resources_->resizeString(node_, capacity);
+    }
+    if (node_) {
+      memcpy(node_->data + size_, s, n);
+      size_ += n;
+    }
   }
 
   void append(char c) {
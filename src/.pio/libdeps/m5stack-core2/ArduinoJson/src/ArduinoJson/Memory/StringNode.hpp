@@ -22,6 +22,10 @@ struct StringNode {
   using length_type = uint_t<ARDUINOJSON_STRING_LENGTH_SIZE * 8>;
 
   struct StringNode* next;
+#if ARDUINOJSON_ENABLE_STRING_INDEX
+  struct StringNode* prev;  // to unlink without walking the list
+  uint32_t hash;            // see stringHash()
+#endif
   references_type references;
   length_type length;
   char data[1];
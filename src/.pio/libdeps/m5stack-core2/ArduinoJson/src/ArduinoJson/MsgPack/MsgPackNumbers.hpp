@@ -0,0 +1,313 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Deserialization/DeserializationError.hpp>
+#include <ArduinoJson/Deserialization/Reader.hpp>
+#include <ArduinoJson/MsgPack/MsgPackPackedType.hpp>
+#include <ArduinoJson/MsgPack/MsgPackSerializer.hpp>
+#include <ArduinoJson/MsgPack/endianness.hpp>
+#include <ArduinoJson/MsgPack/ieee754.hpp>
+#include <ArduinoJson/Numbers/convertNumber.hpp>
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// How serializeMsgPackArray() encodes the values
+enum class MsgPackArrayFormat : uint8_t {
+  Array,   // a regular array, readable by any MessagePack decoder
+  Packed,  // an extension holding the raw values, see MsgPackPackedType
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Reads an array of numbers straight into a caller's buffer.
+// Accepts both formats of serializeMsgPackArray(), whatever the type of the
+// elements in the input: they are converted like JsonVariant::as<T>() does.
+template <typename TReader>
+class MsgPackNumbersDeserializer {
+ public:
+  explicit MsgPackNumbersDeserializer(TReader reader) : reader_(reader) {}
+
+  template <typename T>
+  DeserializationError parse(T* values, size_t capacity, size_t& count) {
+    count = 0;
+
+    uint8_t header[5];
+    if (readBytes(header, 1))
+      return DeserializationError::EmptyInput;
+
+    const uint8_t& code = header[0];
+    uint8_t sizeBytes = 0;
+    size_t size = 0;
+
+    if ((code & 0xf0) == 0x90) {  // fixarray
+      size = code & 0x0f;
+    } else if (code == 0xdc || code == 0xdd) {  // array 16, array 32
+      sizeBytes = uint8_t(2 << (code - 0xdc));
+    } else if (code >= 0xc7 && code <= 0xc9) {  // ext 8, 16, 32
+      sizeBytes = uint8_t(1 << (code - 0xc7));
+    } else if (code >= 0xd4 && code <= 0xd8) {  // fixext
+      size = size_t(1) << (code - 0xd4);
+    } else {
+      return DeserializationError::InvalidInput;
+    }
+
+    if (sizeBytes) {
+      auto err = readBytes(header + 1, sizeBytes);
+      if (err)
+        return err;
+
+      uint32_t size32 = 0;
+      for (uint8_t i = 0; i < sizeBytes; i++)
+        size32 = (size32 << 8) | header[i + 1];
+
+      size = size_t(size32);
+      if (size < size32)                        // integer overflow
+        return DeserializationError::NoMemory;  // (not testable on 32/64-bit)
+    }
+
+    if ((code & 0xf0) == 0x90 || code == 0xdc || code == 0xdd)
+      return readArray(values, capacity, size, count);
+    else
+      return readPacked(values, capacity, size, count);
+  }
+
+ private:
+  template <typename T>
+  DeserializationError::Code readArray(T* values, size_t capacity, size_t n,
+                                       size_t& count) {
+    if (n > capacity)
+      return DeserializationError::NoMemory;
+
+    for (; count < n; count++) {
+      uint8_t code;
+      auto err = readBytes(&code, 1);
+      if (err)
+        return err;
+
+      if (code <= 0x7f || code >= 0xe0) {  // fixint
+        values[count] = convertNumber<T>(static_cast<int8_t>(code));
+        continue;
+      }
+
+      // Same layout as the packed values, with a different type code
+      int8_t type;
+      if (code >= 0xcc && code <= 0xcf)  // uint 8, 16, 32, 64
+        type = int8_t(0x11 + (code - 0xcc) * 2);
+      else if (code >= 0xd0 && code <= 0xd3)  // int 8, 16, 32, 64
+        type = int8_t(0x10 + (code - 0xd0) * 2);
+      else if (code == 0xca || code == 0xcb)  // float 32, 64
+        type = int8_t(0x18 + (code - 0xca));
+      else
+        return DeserializationError::InvalidInput;
+
+      err = readElement(type, values[count]);
+      if (err)
+        return err;
+    }
+
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  DeserializationError::Code readPacked(T* values, size_t capacity,
+                                        size_t size, size_t& count) {
+    int8_t type;
+    auto err = readBytes(&type, 1);
+    if (err)
+      return err;
+
+    uint8_t elementSize = msgPackPackedElementSize(type);
+    if (!elementSize || size % elementSize)
+      return DeserializationError::InvalidInput;
+
+    size_t n = size / elementSize;
+    if (n > capacity)
+      return DeserializationError::NoMemory;
+
+    if (type == MsgPackPackedType<T>::value) {
+      // The payload is already the array, except for the byte order
+      err = readBytes(values, size);
+      if (err)
+        return err;
+      for (count = 0; count < n; count++)
+        fixEndianness(values[count]);
+      return DeserializationError::Ok;
+    }
+
+    for (; count < n; count++) {
+      err = readElement(type, values[count]);
+      if (err)
+        return err;
+    }
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  DeserializationError::Code readElement(int8_t type, T& value) {
+    switch (type) {
+      case 0x10:
+        return readAndConvert<int8_t>(value);
+      case 0x11:
+        return readAndConvert<uint8_t>(value);
+      case 0x12:
+        return readAndConvert<int16_t>(value);
+      case 0x13:
+        return readAndConvert<uint16_t>(value);
+      case 0x14:
+        return readAndConvert<int32_t>(value);
+      case 0x15:
+        return readAndConvert<uint32_t>(value);
+      case 0x16:
+        return readAndConvert<int64_t>(value);
+      case 0x17:
+        return readAndConvert<uint64_t>(value);
+      case 0x18:
+        return readAndConvert<float>(value);
+      default:
+        ARDUINOJSON_ASSERT(type == 0x19);
+        return readFloat64(value);
+    }
+  }
+
+  template <typename TIn, typename T>
+  DeserializationError::Code readAndConvert(T& value) {
+    TIn in;
+    auto err = readBytes(&in, sizeof(in));
+    if (err)
+      return err;
+    fixEndianness(in);
+    value = convertNumber<T>(in);
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  DeserializationError::Code readFloat64(T& value) {
+    return readFloat64(value, integral_constant<size_t, sizeof(double)>());
+  }
+
+  template <typename T>
+  DeserializationError::Code readFloat64(T& value,
+                                         integral_constant<size_t, 8>) {
+    return readAndConvert<double>(value);
+  }
+
+  // double is 32-bit on this platform: narrow the value like
+  // MsgPackDeserializer does
+  template <typename T>
+  DeserializationError::Code readFloat64(T& value,
+                                         integral_constant<size_t, 4>) {
+    uint8_t i[8];
+    float f;
+    auto err = readBytes(i, 8);
+    if (err)
+      return err;
+    doubleToFloat(i, reinterpret_cast<uint8_t*>(&f));
+    fixEndianness(f);
+    value = convertNumber<T>(f);
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError::Code readBytes(void* p, size_t n) {
+    if (reader_.readBytes(reinterpret_cast<char*>(p), n) == n)
+      return DeserializationError::Ok;
+    return DeserializationError::IncompleteInput;
+  }
+
+  TReader reader_;
+};
+
+template <typename TWriter, typename T>
+size_t doSerializeNumbers(const T* values, size_t count, TWriter writer,
+                          MsgPackArrayFormat format) {
+  MsgPackSerializer<TWriter> serializer(writer, nullptr);
+  if (format == MsgPackArrayFormat::Packed)
+    return serializer.visitPackedNumbers(values, count);
+  else
+    return serializer.visitNumbers(values, count);
+}
+
+template <typename TReader, typename T>
+DeserializationError doDeserializeNumbers(TReader reader, T* values,
+                                          size_t capacity, size_t& count) {
+  return MsgPackNumbersDeserializer<TReader>(reader).parse(values, capacity,
+                                                           count);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Produces a MessagePack array from an array of numbers, without a
+// JsonDocument.
+template <
+    typename T, typename TDestination,
+    detail::enable_if_t<!detail::is_pointer<TDestination>::value, int> = 0>
+inline size_t serializeMsgPackArray(
+    const T* values, size_t count, TDestination& output,
+    MsgPackArrayFormat format = MsgPackArrayFormat::Array) {
+  using namespace detail;
+  Writer<TDestination> writer(output);
+  return doSerializeNumbers(values, count, writer, format);
+}
+
+// Produces a MessagePack array from an array of numbers, without a
+// JsonDocument.
+template <typename T>
+inline size_t serializeMsgPackArray(
+    const T* values, size_t count, void* output, size_t size,
+    MsgPackArrayFormat format = MsgPackArrayFormat::Array) {
+  using namespace detail;
+  StaticStringWriter writer(reinterpret_cast<char*>(output), size);
+  return doSerializeNumbers(values, count, writer, format);
+}
+
+// Computes the length of the document that serializeMsgPackArray() produces.
+template <typename T>
+inline size_t measureMsgPackArray(
+    const T* values, size_t count,
+    MsgPackArrayFormat format = MsgPackArrayFormat::Array) {
+  using namespace detail;
+  DummyWriter writer;
+  return doSerializeNumbers(values, count, writer, format);
+}
+
+// Parses a MessagePack array of numbers into a caller's buffer, without a
+// JsonDocument.
+// Returns NoMemory if the array has more than capacity elements, and
+// InvalidInput if it contains something other than numbers.
+template <typename T, typename TInput>
+inline DeserializationError deserializeMsgPackArray(TInput&& input, T* values,
+                                                    size_t capacity,
+                                                    size_t& count) {
+  using namespace detail;
+  return doDeserializeNumbers(makeReader(detail::forward<TInput>(input)),
+                              values, capacity, count);
+}
+
+// Parses a MessagePack array of numbers into a caller's buffer.
+template <typename T, typename TChar>
+inline DeserializationError deserializeMsgPackArray(TChar* input, T* values,
+                                                    size_t capacity,
+                                                    size_t& count) {
+  using namespace detail;
+  return doDeserializeNumbers(makeReader(input), values, capacity, count);
+}
+
+// Parses a MessagePack array of numbers of a given size into a caller's
+// buffer.
+template <typename T, typename TChar>
+inline DeserializationError deserializeMsgPackArray(TChar* input,
+                                                    size_t inputSize,
+                                                    T* values, size_t capacity,
+                                                    size_t& count) {
+  using namespace detail;
+  return doDeserializeNumbers(makeReader(input, inputSize), values, capacity,
+                              count);
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
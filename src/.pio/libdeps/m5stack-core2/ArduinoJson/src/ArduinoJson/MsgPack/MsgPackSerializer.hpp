@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <ArduinoJson/MsgPack/MsgPackPackedType.hpp>
 #include <ArduinoJson/MsgPack/endianness.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
@@ -48,16 +49,7 @@ class MsgPackSerializer : public VariantDataVisitor<size_t> {
   }
 
   size_t visit(const ArrayData& array) {
-    size_t n = array.size(resources_);
-    if (n < 0x10) {
-      writeByte(uint8_t(0x90 + n));
-    } else if (n < 0x10000) {
-      writeByte(0xDC);
-      writeInteger(uint16_t(n));
-    } else {
-      writeByte(0xDD);
-      writeInteger(uint32_t(n));
-    }
+    writeArrayHeader(array.size(resources_));
 
     auto slotId = array.head();
     while (slotId != NULL_SLOT) {
@@ -189,7 +181,91 @@ class MsgPackSerializer : public VariantDataVisitor<size_t> {
     return bytesWritten();
   }
 
+  // Writes an array of numbers exactly like a JsonArray holding the same
+  // values, but without the slots
+  template <typename T>
+  size_t visitNumbers(const T* values, size_t n) {
+    writeArrayHeader(n);
+    for (size_t i = 0; i < n; i++)
+      visitNumber(values[i]);
+    return bytesWritten();
+  }
+
+  // Writes an array of numbers as an extension whose payload is the raw
+  // big-endian values; see MsgPackPackedType for the extension types
+  template <typename T>
+  size_t visitPackedNumbers(const T* values, size_t n) {
+    writeExtensionHeader(MsgPackPackedType<T>::value, n * sizeof(T));
+
+    // Swap the bytes in small batches, so the writer gets few calls
+    uint8_t chunk[64 - 64 % sizeof(T)];
+    size_t chunkSize = 0;
+    for (size_t i = 0; i < n; i++) {
+      T value = values[i];
+      fixEndianness(value);
+      memcpy(chunk + chunkSize, &value, sizeof(T));
+      chunkSize += sizeof(T);
+      if (chunkSize == sizeof(chunk)) {
+        writeBytes(chunk, chunkSize);
+        chunkSize = 0;
+      }
+    }
+    writeBytes(chunk, chunkSize);
+    return bytesWritten();
+  }
+
  private:
+  template <typename T>
+  enable_if_t<is_integral<T>::value && is_signed<T>::value> visitNumber(
+      T value) {
+    static_assert(sizeof(T) <= sizeof(JsonInteger), "integer too large");
+    visit(JsonInteger(value));
+  }
+
+  template <typename T>
+  enable_if_t<is_integral<T>::value && is_unsigned<T>::value> visitNumber(
+      T value) {
+    static_assert(sizeof(T) <= sizeof(JsonUInt), "integer too large");
+    visit(JsonUInt(value));
+  }
+
+  template <typename T>
+  enable_if_t<is_floating_point<T>::value> visitNumber(T value) {
+    visit(value);
+  }
+
+  void writeArrayHeader(size_t n) {
+    if (n < 0x10) {
+      writeByte(uint8_t(0x90 + n));
+    } else if (n < 0x10000) {
+      writeByte(0xDC);
+      writeInteger(uint16_t(n));
+    } else {
+      writeByte(0xDD);
+      writeInteger(uint32_t(n));
+    }
+  }
+
+  void writeExtensionHeader(int8_t type, size_t n) {
+    if (n == 1 || n == 2 || n == 4 || n == 8 || n == 16) {
+      writeByte(uint8_t(n == 1   ? 0xD4    // fixext 1
+                        : n == 2 ? 0xD5    // fixext 2
+                        : n == 4 ? 0xD6    // fixext 4
+                        : n == 8 ? 0xD7    // fixext 8
+                                 : 0xD8));  // fixext 16
+    } else if (n < 0x100) {
+      writeByte(0xC7);
+      writeInteger(uint8_t(n));
+    } else if (n < 0x10000) {
+      writeByte(0xC8);
+      writeInteger(uint16_t(n));
+    } else {
+      writeByte(0xC9);
+      writeInteger(uint32_t(n));
+    }
+    writeByte(uint8_t(type));
+  }
+
   size_t bytesWritten() const {
     return writer_.count();
   }
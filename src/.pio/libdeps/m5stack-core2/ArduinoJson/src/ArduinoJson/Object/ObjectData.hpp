@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Collection/CollectionData.hpp>
+#include <ArduinoJson/Memory/KeyIndex.hpp>
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
@@ -39,9 +40,7 @@ class ObjectData : public CollectionData {
     obj->removeMember(key, resources);
   }
 
-  void remove(iterator it, ResourceManager* resources) {
-    CollectionData::removePair(it, resources);
-  }
+  void remove(iterator it, ResourceManager* resources);
 
   static void remove(ObjectData* obj, ObjectData::iterator it,
                      ResourceManager* resources) {
@@ -63,6 +62,17 @@ class ObjectData : public CollectionData {
  private:
   template <typename TAdaptedString>
   iterator findKey(TAdaptedString key, const ResourceManager* resources) const;
+
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  template <typename TAdaptedString>
+  iterator findIndexedKey(const KeyIndex& index, TAdaptedString key,
+                          const ResourceManager* resources) const;
+  void indexKeys(const ResourceManager* resources) const;
+  void indexKey(KeyIndex& index, SlotId keyId,
+                const ResourceManager* resources) const;
+  void unindexKey(KeyIndex& index, iterator it,
+                  const ResourceManager* resources);
+#endif
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -34,15 +34,117 @@ inline ObjectData::iterator ObjectData::findKey(
     TAdaptedString key, const ResourceManager* resources) const {
   if (key.isNull())
     return iterator();
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  auto index = resources->getKeyIndex(this);
+  if (index)
+    return findIndexedKey(*index, key, resources);
+  size_t walked = 0;
+#endif
   bool isKey = true;
   for (auto it = createIterator(resources); !it.done(); it.next(resources)) {
-    if (isKey && stringEquals(key, adaptString(it->asString())))
-      return it;
+    if (isKey) {
+      if (stringEquals(key, adaptString(it->asString()))) {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+        if (walked >= ARDUINOJSON_KEY_INDEX_THRESHOLD)
+          indexKeys(resources);
+#endif
+        return it;
+      }
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+      walked++;
+#endif
+    }
     isKey = !isKey;
   }
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  if (walked >= ARDUINOJSON_KEY_INDEX_THRESHOLD)
+    indexKeys(resources);
+#endif
   return iterator();
 }
 
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+inline uint32_t hashKeySlot(SlotId keyId, const ResourceManager* resources) {
+  return stringHash(adaptString(resources->getVariant(keyId)->asString()));
+}
+
+template <typename TAdaptedString>
+inline ObjectData::iterator ObjectData::findIndexedKey(
+    const KeyIndex& index, TAdaptedString key,
+    const ResourceManager* resources) const {
+  for (size_t i = stringHash(key) & index.mask();; i = (i + 1) & index.mask()) {
+    auto keyId = index.slots[i];
+    if (keyId == NULL_SLOT)
+      return iterator();
+    auto it = createIterator(keyId, resources);
+    if (stringEquals(key, adaptString(it->asString())))
+      return it;
+  }
+}
+
+inline void ObjectData::indexKeys(const ResourceManager* resources) const {
+  size_t members = size(resources);
+  size_t capacity = 8;
+  while (capacity < members * 2)
+    capacity *= 2;
+
+  auto index = resources->createKeyIndex(this, capacity);
+  if (!index)
+    return;  // lookups keep walking the members
+
+  for (auto keyId = head(); keyId != NULL_SLOT;) {
+    indexKey(*index, keyId, resources);
+    auto valueId = resources->getVariant(keyId)->next();
+    keyId = resources->getVariant(valueId)->next();
+  }
+}
+
+inline void ObjectData::indexKey(KeyIndex& index, SlotId keyId,
+                                 const ResourceManager* resources) const {
+  size_t i = hashKeySlot(keyId, resources) & index.mask();
+  while (index.slots[i] != NULL_SLOT)
+    i = (i + 1) & index.mask();
+  index.slots[i] = keyId;
+  index.count++;
+}
+
+// Removes the key with backward-shift deletion, so the table never needs
+// tombstones
+inline void ObjectData::unindexKey(KeyIndex& index, iterator it,
+                                   const ResourceManager* resources) {
+  size_t mask = index.mask();
+  size_t i = stringHash(adaptString(it->asString())) & mask;
+  for (;;) {
+    ARDUINOJSON_ASSERT(index.slots[i] != NULL_SLOT);
+    if (resources->getVariant(index.slots[i]) == it.data())
+      break;
+    i = (i + 1) & mask;
+  }
+
+  for (size_t j = (i + 1) & mask; index.slots[j] != NULL_SLOT;
+       j = (j + 1) & mask) {
+    size_t home = hashKeySlot(index.slots[j], resources) & mask;
+    // The entry stays if its home is cyclically in (i, j]
+    bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+    if (!stays) {
+      index.slots[i] = index.slots[j];
+      i = j;
+    }
+  }
+  index.slots[i] = NULL_SLOT;
+  index.count--;
+}
+#endif
+
+inline void ObjectData::remove(iterator it, ResourceManager* resources) {
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  auto index = resources->getKeyIndex(this);
+  if (index && !it.done())
+    unindexKey(*index, it, resources);
+#endif
+  CollectionData::removePair(it, resources);
+}
+
 template <typename TAdaptedString>
 inline void ObjectData::removeMember(TAdaptedString key,
                                      ResourceManager* resources) {
@@ -65,6 +167,18 @@ inline VariantData* ObjectData::addMember(TAdaptedString key,
 
   CollectionData::appendPair(keySlot, valueSlot, resources);
 
+#if ARDUINOJSON_KEY_INDEX_THRESHOLD
+  auto index = resources->getKeyIndex(this);
+  if (index) {
+    if ((index->count + 1) * 4 > index->capacity * 3) {
+      resources->dropKeyIndex(this);
+      indexKeys(resources);  // twice as large, with the new key
+    } else {
+      indexKey(*index, keySlot.id(), resources);
+    }
+  }
+#endif
+
   return valueSlot.ptr();
 }
 
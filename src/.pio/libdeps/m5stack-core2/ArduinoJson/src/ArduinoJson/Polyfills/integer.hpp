@@ -4,9 +4,10 @@
 
 #pragma once
 
-#include <stdint.h>  // int8_t, int16_t
+#include <stdint.h>  // int8_t, int16_t, uint64_t
 
 #include <ArduinoJson/Namespace.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
@@ -28,7 +29,52 @@ struct uint_<32> {
   using type = uint32_t;
 };
 
+template <>
+struct uint_<64> {
+  using type = uint64_t;
+};
+
 template <int Bits>
 using uint_t = typename uint_<Bits>::type;
 
+struct Uint128 {
+  uint64_t high;
+  uint64_t low;
+};
+
+inline Uint128 multiply64(uint64_t a, uint64_t b) {
+  Uint128 result;
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 uint128_t;
+  uint128_t product = static_cast<uint128_t>(a) * b;
+  result.high = uint64_t(product >> 64);
+  result.low = uint64_t(product);
+#else
+  uint64_t aLow = uint32_t(a), aHigh = a >> 32;
+  uint64_t bLow = uint32_t(b), bHigh = b >> 32;
+  uint64_t lowLow = aLow * bLow;
+  uint64_t highLow = aHigh * bLow;
+  uint64_t lowHigh = aLow * bHigh;
+  uint64_t highHigh = aHigh * bHigh;
+  uint64_t middle = (lowLow >> 32) + uint32_t(highLow) + lowHigh;
+  result.high = highHigh + (highLow >> 32) + (middle >> 32);
+  result.low = (middle << 32) | uint32_t(lowLow);
+#endif
+  return result;
+}
+
+inline int countLeadingZeros(uint64_t x) {
+  ARDUINOJSON_ASSERT(x != 0);
+#ifdef __GNUC__
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x & (uint64_t(1) << 63))) {
+    x <<= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,105 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2024, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/JsonSerializer.hpp>
+#include <ArduinoJson/Json/PrettyJsonSerializer.hpp>
+#include <ArduinoJson/MsgPack/MsgPackSerializer.hpp>
+
+#include <string.h>  // memcpy
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Collects the output of a serializer and sends it to a Print in chunks of N
+// bytes, instead of calling Print::write() for every punctuation character.
+// The buffer is flushed when full, by flush(), and by the destructor.
+//
+// serializeJson(doc, BufferedPrint<64>(client));
+template <size_t N>
+class BufferedPrint {
+  static_assert(N > 0, "BufferedPrint needs a buffer");
+
+ public:
+  explicit BufferedPrint(::Print& target) : target_(&target) {}
+
+  BufferedPrint(const BufferedPrint&) = delete;
+  BufferedPrint& operator=(const BufferedPrint&) = delete;
+
+  ~BufferedPrint() {
+    flush();
+  }
+
+  size_t write(uint8_t c) {
+    if (size_ == N)
+      flush();
+    buffer_[size_++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t* s, size_t n) {
+    if (n > N - size_) {
+      flush();
+      if (n >= N) {  // too big to be worth copying
+        size_t written = target_->write(s, n);
+        rejected_ += n - written;
+        return n;
+      }
+    }
+    memcpy(buffer_ + size_, s, n);
+    size_ += n;
+    return n;
+  }
+
+  // Sends the buffered bytes to the Print
+  void flush() {
+    if (size_ == 0)
+      return;
+    size_t written = target_->write(buffer_, size_);
+    rejected_ += size_ - written;
+    size_ = 0;
+  }
+
+  // Number of bytes that the Print refused so far
+  size_t bytesRejected() const {
+    return rejected_;
+  }
+
+ private:
+  ::Print* target_;
+  size_t size_ = 0;
+  size_t rejected_ = 0;
+  uint8_t buffer_[N];
+};
+
+// Produces a minified JSON document through a temporary BufferedPrint.
+// Returns the number of bytes accepted by the Print.
+template <size_t N>
+size_t serializeJson(JsonVariantConst source, BufferedPrint<N>&& destination) {
+  size_t n = serializeJson(source, destination);
+  destination.flush();
+  return n - destination.bytesRejected();
+}
+
+// Produces a prettified JSON document through a temporary BufferedPrint.
+// Returns the number of bytes accepted by the Print.
+template <size_t N>
+size_t serializeJsonPretty(JsonVariantConst source,
+                           BufferedPrint<N>&& destination) {
+  size_t n = serializeJsonPretty(source, destination);
+  destination.flush();
+  return n - destination.bytesRejected();
+}
+
+// Produces a MessagePack document through a temporary BufferedPrint.
+// Returns the number of bytes accepted by the Print.
+template <size_t N>
+size_t serializeMsgPack(JsonVariantConst source,
+                        BufferedPrint<N>&& destination) {
+  size_t n = serializeMsgPack(source, destination);
+  destination.flush();
+  return n - destination.bytesRejected();
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
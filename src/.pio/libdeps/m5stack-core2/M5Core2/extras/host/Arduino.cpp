@@ -0,0 +1,342 @@
+// Host build: the Arduino core, file system, network and ROM functions that
+// the display drivers use. The bus lives in VirtualPanel.cpp.
+
+#include <Arduino.h>
+#include <FS.h>
+#include <HTTPClient.h>
+#include <M5Touch.h>
+#include <SPIFFS.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rom/miniz.h"
+#include "rom/tjpgd.h"
+
+/***************************************************************************************
+** Time: the clock of the host, plus the time spent in delay()
+***************************************************************************************/
+static const auto startTime = std::chrono::steady_clock::now();
+static std::atomic<uint64_t> delayedMicros(0);
+
+unsigned long micros(void) {
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() +
+           delayedMicros;
+}
+
+unsigned long millis(void) {
+    return micros() / 1000;
+}
+
+void delay(uint32_t ms) {
+    delayedMicros += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+    delayedMicros += us;
+}
+
+void yield(void) {}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+bool psramFound(void) {
+    return true;
+}
+
+void *ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+void *ps_calloc(size_t n, size_t size) {
+    return calloc(n, size);
+}
+
+/***************************************************************************************
+** Tasks and queues
+***************************************************************************************/
+struct HostQueue {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    size_t length, itemSize;
+};
+
+// Waits for ready() under the lock, for ticks milliseconds at most
+template <typename Ready>
+static bool waitFor(HostQueue *q, std::unique_lock<std::mutex> &lock,
+                    TickType_t ticks, Ready ready) {
+    if (ticks == portMAX_DELAY) {
+        q->changed.wait(lock, ready);
+        return true;
+    }
+    return q->changed.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue *q = new HostQueue;
+    q->length    = length;
+    q->itemSize  = itemSize;
+    return q;
+}
+
+// The other side is woken before the lock is released, so that a queue can
+// be deleted as soon as the last item has been taken
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+    HostQueue *q = (HostQueue *)queue;
+    std::unique_lock<std::mutex> lock(q->mutex);
+    if (!waitFor(q, lock, wait, [q] { return q->items.size() < q->length; }))
+        return pdFAIL;
+    const uint8_t *bytes = (const uint8_t *)item;
+    q->items.emplace_back(bytes, bytes + q->itemSize);
+    q->changed.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+    HostQueue *q = (HostQueue *)queue;
+    std::unique_lock<std::mutex> lock(q->mutex);
+    if (!waitFor(q, lock, wait, [q] { return !q->items.empty(); }))
+        return pdFAIL;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    q->changed.notify_all();
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete (HostQueue *)queue;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *,
+                                   uint32_t, void *arg, UBaseType_t,
+                                   TaskHandle_t *handle, BaseType_t) {
+    std::thread task(function, arg);
+    if (handle) *handle = (TaskHandle_t)(uintptr_t)task.native_handle();
+    task.detach();
+    return pdPASS;
+}
+
+/***************************************************************************************
+** Number conversions
+***************************************************************************************/
+char *ultoa(unsigned long value, char *str, int radix) {
+    char buf[8 * sizeof(long) + 1], *p = buf + sizeof(buf) - 1;
+    *p = 0;
+    do {
+        unsigned d = value % radix;
+        *--p       = d < 10 ? '0' + d : 'a' + d - 10;
+        value /= radix;
+    } while (value);
+    return strcpy(str, p);
+}
+
+char *ltoa(long value, char *str, int radix) {
+    if (value < 0 && radix == 10) {
+        str[0] = '-';
+        ultoa(-(unsigned long)value, str + 1, radix);
+        return str;
+    }
+    return ultoa((unsigned long)value, str, radix);
+}
+
+char *itoa(int value, char *str, int radix) {
+    return ltoa(value, str, radix);
+}
+
+char *utoa(unsigned int value, char *str, int radix) {
+    return ultoa(value, str, radix);
+}
+
+char *dtostrf(double value, signed char width, unsigned char prec, char *str) {
+    sprintf(str, "%*.*f", width, prec, value);
+    return str;
+}
+
+/***************************************************************************************
+** Print
+***************************************************************************************/
+size_t Print::printf(const char *format, ...) {
+    char buf[64];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(buf)) return write((const uint8_t *)buf, len);
+
+    std::string big(len + 1, 0);
+    va_start(args, format);
+    vsnprintf(&big[0], big.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)big.data(), len);
+}
+
+size_t Print::print(const String &s) {
+    return write(s.c_str(), s.length());
+}
+
+size_t Print::print(long n, int base) {
+    char buf[8 * sizeof(long) + 2];
+    if (base == 10) return print(ltoa(n, buf, 10));
+    return print(ultoa((unsigned long)n, buf, base));
+}
+
+size_t Print::print(unsigned long n, int base) {
+    char buf[8 * sizeof(long) + 1];
+    return print(ultoa(n, buf, base));
+}
+
+size_t Print::print(double n, int digits) {
+    return printf("%.*f", digits, n);
+}
+
+HardwareSerial Serial;
+
+/***************************************************************************************
+** File system
+***************************************************************************************/
+static std::string hostPath(const char *path) {
+    const char *root = getenv("HOST_FS_ROOT");
+    std::string full = root ? root : "data";
+    if (path[0] != '/') full += '/';
+    return full + path;
+}
+
+fs::File fs::FS::open(const char *path, const char *mode) {
+    std::string m = mode;
+    if (m.find('b') == std::string::npos) m += 'b';
+    return fs::File(fopen(hostPath(path).c_str(), m.c_str()));
+}
+
+bool fs::FS::exists(const char *path) {
+    return access(hostPath(path).c_str(), F_OK) == 0;
+}
+
+fs::FS SPIFFS;
+
+/***************************************************************************************
+** Network and touch panel, neither of which exist
+***************************************************************************************/
+WiFiClass WiFi;
+
+static M5Touch noTouch;
+M5Touch *M5Touch::instance = &noTouch;
+
+/***************************************************************************************
+** ROM: miniz on top of zlib, and a stand-in for TJpgDec
+***************************************************************************************/
+void tinfl_init(tinfl_decompressor *r) {
+    if (r->started) inflateEnd(&r->zs);
+    r->started = 0;
+}
+
+mz_ulong mz_crc32(mz_ulong crc, const mz_uint8 *ptr, size_t buf_len) {
+    return crc32(crc, ptr, buf_len);
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *pIn_buf_next,
+                              size_t *pIn_buf_size, mz_uint8 *,
+                              mz_uint8 *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags) {
+    z_stream *zs = &r->zs;
+    if (!r->started) {
+        memset(zs, 0, sizeof(*zs));
+        int windowBits = decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER ? 15 : -15;
+        if (inflateInit2(zs, windowBits) != Z_OK) return TINFL_STATUS_FAILED;
+        r->started = 1;
+    }
+
+    // zlib keeps its own window, so the wrapping output buffer of tinfl
+    // only receives the output
+    zs->next_in   = (Bytef *)pIn_buf_next;
+    zs->avail_in  = *pIn_buf_size;
+    zs->next_out  = pOut_buf_next;
+    zs->avail_out = *pOut_buf_size;
+    int ret       = inflate(zs, Z_NO_FLUSH);
+    *pIn_buf_size -= zs->avail_in;
+    *pOut_buf_size -= zs->avail_out;
+
+    if (ret == Z_STREAM_END) {
+        tinfl_init(r);
+        return TINFL_STATUS_DONE;
+    }
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        tinfl_init(r);
+        return TINFL_STATUS_FAILED;
+    }
+    return zs->avail_out ? TINFL_STATUS_NEEDS_MORE_INPUT
+                         : TINFL_STATUS_HAS_MORE_OUTPUT;
+}
+
+// The stand-in format of rom/tjpgd.h. The pool holds a whole block as read
+// and the block handed over.
+static const uint8_t hostJpegMagic[8] = {'H', 'O', 'S', 'T', 'J', 'P', 'E', 'G'};
+static const size_t hostJpegBlock     = 16 * 16 * 3;
+
+JRESULT jd_prepare(JDEC *jd, uint32_t (*infunc)(JDEC *, uint8_t *, uint32_t),
+                   void *pool, uint32_t sz_pool, void *dev) {
+    memset(jd, 0, sizeof(*jd));
+    jd->infunc  = infunc;
+    jd->device  = dev;
+    jd->pool    = pool;
+    jd->sz_pool = sz_pool;
+
+    uint8_t header[14];
+    if (infunc(jd, header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, hostJpegMagic, sizeof(hostJpegMagic)))
+        return JDR_FMT3;
+    jd->width  = header[8] | header[9] << 8;
+    jd->height = header[10] | header[11] << 8;
+    if (!jd->width || !jd->height) return JDR_FMT1;
+    if ((header[12] != 8 && header[12] != 16) ||
+        (header[13] != 8 && header[13] != 16))
+        return JDR_FMT3;
+    jd->msx = header[12] / 8;
+    jd->msy = header[13] / 8;
+    if (sz_pool < 2 * hostJpegBlock) return JDR_MEM1;
+    return JDR_OK;
+}
+
+JRESULT jd_decomp(JDEC *jd, uint32_t (*outfunc)(JDEC *, void *, JRECT *),
+                  uint8_t scale) {
+    if (scale > 3) return JDR_PAR;
+    jd->scale = scale;
+
+    uint8_t *block = (uint8_t *)jd->pool;
+    uint8_t *out   = block + hostJpegBlock;
+    uint32_t mx = jd->msx * 8, my = jd->msy * 8;
+
+    for (uint32_t y = 0; y < jd->height; y += my)
+        for (uint32_t x = 0; x < jd->width; x += mx) {
+            if (jd->infunc(jd, block, mx * my * 3) != mx * my * 3)
+                return JDR_INP;
+
+            // Clipped to the image, then scaled
+            uint32_t rx = std::min(mx, jd->width - x) >> scale;
+            uint32_t ry = std::min(my, jd->height - y) >> scale;
+            if (!rx || !ry) continue;
+            for (uint32_t j = 0; j < ry; j++)
+                for (uint32_t i = 0; i < rx; i++)
+                    memcpy(out + (j * rx + i) * 3,
+                           block + ((j << scale) * mx + (i << scale)) * 3, 3);
+
+            JRECT rect;
+            rect.left   = x >> scale;
+            rect.right  = rect.left + rx - 1;
+            rect.top    = y >> scale;
+            rect.bottom = rect.top + ry - 1;
+            if (!outfunc(jd, out, &rect)) return JDR_INTR;
+        }
+    return JDR_OK;
+}
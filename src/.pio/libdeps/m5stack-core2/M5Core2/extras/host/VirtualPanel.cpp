@@ -0,0 +1,379 @@
+// Host build: the SPI bus of the display and the panel at its end
+
+#include "VirtualPanel.h"
+
+#include <string.h>
+
+#include <unordered_map>
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "soc/spi_reg.h"
+#include "utility/ILI9341_Defines.h"
+#include "utility/In_eSPI_Setup.h"
+
+VirtualPanel Panel;
+
+#define RAMWR_CONTINUE 0x3C
+
+/***************************************************************************************
+** Function name:           VirtualPanel
+** Description:             The panel as it powers on
+***************************************************************************************/
+VirtualPanel::VirtualPanel() {
+    reset();
+}
+
+void VirtualPanel::reset() {
+    memset(memory_, 0, sizeof(memory_));
+    csLow_     = false;
+    dcData_    = true;
+    command_   = 0;
+    argCount_  = 0;
+    pixelHigh_ = 0;
+    readColor_ = 0;
+    colStart_  = 0;
+    colEnd_    = WIDTH - 1;
+    pageStart_ = 0;
+    pageEnd_   = HEIGHT - 1;
+    col_       = 0;
+    page_      = 0;
+    madctl_    = 0;
+    inverted_  = false;
+    resetStats();
+}
+
+/***************************************************************************************
+** Function name:           pinsChanged
+** Description:             Follow the CS and DC lines
+***************************************************************************************/
+void VirtualPanel::pinsChanged(uint32_t levels) {
+    bool csLow = !(levels & (1u << TFT_CS));
+    if (csLow && !csLow_) stats_.transactions++;
+    csLow_  = csLow;
+    dcData_ = levels & (1u << TFT_DC);
+}
+
+/***************************************************************************************
+** Function name:           transfer
+** Description:             Clock one byte each way, returns the byte the panel sends
+***************************************************************************************/
+uint8_t VirtualPanel::transfer(uint8_t mosi) {
+    stats_.bytes++;
+    if (!csLow_) return 0xFF;  // Not selected, nothing drives the line
+
+    if (!dcData_) {
+        command(mosi);
+        return 0;
+    }
+    if (command_ == TFT_RAMRD) return readData();
+    data(mosi);
+    return 0;
+}
+
+void VirtualPanel::command(uint8_t cmd) {
+    stats_.commands++;
+    command_  = cmd;
+    argCount_ = 0;
+
+    switch (cmd) {
+        case TFT_RAMWR:
+        case TFT_RAMRD:
+            stats_.windows++;
+            col_  = colStart_;
+            page_ = pageStart_;
+            break;
+        case TFT_INVON:
+            inverted_ = true;
+            break;
+        case TFT_INVOFF:
+            inverted_ = false;
+            break;
+    }
+}
+
+void VirtualPanel::data(uint8_t value) {
+    switch (command_) {
+        case TFT_CASET:
+        case TFT_PASET:
+            if (argCount_ < 4) args_[argCount_] = value;
+            if (argCount_ == 3) {
+                uint16_t start = args_[0] << 8 | args_[1];
+                uint16_t end   = args_[2] << 8 | args_[3];
+                if (command_ == TFT_CASET) {
+                    colStart_ = start;
+                    colEnd_   = end;
+                } else {
+                    pageStart_ = start;
+                    pageEnd_   = end;
+                }
+            }
+            break;
+        case TFT_MADCTL:
+            if (argCount_ == 0) madctl_ = value;
+            break;
+        case TFT_RAMWR:
+        case RAMWR_CONTINUE:
+            // 16 bit pixels, high byte first
+            if (argCount_ & 1)
+                storePixel(pixelHigh_ << 8 | value);
+            else
+                pixelHigh_ = value;
+            break;
+    }
+    argCount_++;
+}
+
+/***************************************************************************************
+** Function name:           readData
+** Description:             Memory read: a dummy byte, then 3 bytes per pixel, the 5 or
+**                          6 bits of each colour in the top of a byte
+***************************************************************************************/
+uint8_t VirtualPanel::readData() {
+    uint32_t n = argCount_++;
+    if (n == 0) return 0;
+
+    switch ((n - 1) % 3) {
+        case 0: {
+            uint16_t *pixel = memoryAt(col_, page_);
+            readColor_      = pixel ? *pixel : 0;
+            stats_.pixelsRead++;
+            return (readColor_ >> 11) << 3;
+        }
+        case 1:
+            return ((readColor_ >> 5) & 0x3F) << 2;
+        default:
+            advance();
+            return (readColor_ & 0x1F) << 3;
+    }
+}
+
+void VirtualPanel::storePixel(uint16_t color) {
+    uint16_t *pixel = memoryAt(col_, page_);
+    if (pixel) {
+        *pixel = color;
+        stats_.pixelsWritten++;
+    }
+    advance();
+}
+
+/***************************************************************************************
+** Function name:           memoryAt
+** Description:             Map a column and page to the memory, following MADCTL.
+**                          Returns nullptr outside of the memory.
+***************************************************************************************/
+uint16_t *VirtualPanel::memoryAt(uint16_t col, uint16_t page) {
+    bool mv     = madctl_ & TFT_MAD_MV;
+    int columns = mv ? HEIGHT : WIDTH;
+    int pages   = mv ? WIDTH : HEIGHT;
+    if (col >= columns || page >= pages) return nullptr;
+
+    if (madctl_ & TFT_MAD_MX) col = columns - 1 - col;
+    if (madctl_ & TFT_MAD_MY) page = pages - 1 - page;
+    if (mv) return &memory_[col * WIDTH + page];
+    return &memory_[page * WIDTH + col];
+}
+
+// Next address of the window, wrapping to its start after the end
+void VirtualPanel::advance() {
+    if (col_ < colEnd_) {
+        col_++;
+        return;
+    }
+    col_ = colStart_;
+    if (page_ < pageEnd_)
+        page_++;
+    else
+        page_ = pageStart_;
+}
+
+uint16_t VirtualPanel::readPixel(int x, int y) const {
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) return 0;
+    return memory_[y * WIDTH + x];
+}
+
+/***************************************************************************************
+** Function name:           writePPM
+** Description:             Save the memory as a binary PPM image. The colours are the
+**                          ones the library drew, the inversion and the colour order
+**                          of the glass aren't applied.
+***************************************************************************************/
+bool VirtualPanel::writePPM(const char *path) const {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+    uint8_t row[WIDTH * 3];
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            uint16_t c     = memory_[y * WIDTH + x];
+            row[x * 3]     = ((c >> 11) * 255 + 15) / 31;
+            row[x * 3 + 1] = (((c >> 5) & 0x3F) * 255 + 31) / 63;
+            row[x * 3 + 2] = ((c & 0x1F) * 255 + 15) / 31;
+        }
+        fwrite(row, 1, sizeof(row), f);
+    }
+    return fclose(f) == 0;
+}
+
+/***************************************************************************************
+** Function name:           beginCall, endCall
+** Description:             Attribute the bus traffic in between to a named call. Nested
+**                          calls count towards the outermost one.
+***************************************************************************************/
+static VirtualPanel::Stats difference(const VirtualPanel::Stats &a,
+                                      const VirtualPanel::Stats &b) {
+    VirtualPanel::Stats d;
+    d.transactions  = a.transactions - b.transactions;
+    d.windows       = a.windows - b.windows;
+    d.commands      = a.commands - b.commands;
+    d.pixelsWritten = a.pixelsWritten - b.pixelsWritten;
+    d.pixelsRead    = a.pixelsRead - b.pixelsRead;
+    d.bytes         = a.bytes - b.bytes;
+    return d;
+}
+
+static void accumulate(VirtualPanel::Stats &total, const VirtualPanel::Stats &d) {
+    total.transactions += d.transactions;
+    total.windows += d.windows;
+    total.commands += d.commands;
+    total.pixelsWritten += d.pixelsWritten;
+    total.pixelsRead += d.pixelsRead;
+    total.bytes += d.bytes;
+}
+
+void VirtualPanel::beginCall(const char *name) {
+    if (callDepth_++) return;
+    callName_  = name;
+    callStart_ = stats_;
+}
+
+void VirtualPanel::endCall() {
+    if (!callDepth_ || --callDepth_) return;
+    lastCall_         = difference(stats_, callStart_);
+    CallTotals &total = calls_[callName_];
+    total.calls++;
+    accumulate(total.stats, lastCall_);
+}
+
+void VirtualPanel::resetStats() {
+    memset(&stats_, 0, sizeof(stats_));
+    memset(&lastCall_, 0, sizeof(lastCall_));
+    callStart_ = stats_;
+    callDepth_ = 0;
+    calls_.clear();
+}
+
+void VirtualPanel::printReport(FILE *out) const {
+    fprintf(out, "%-24s %8s %8s %8s %8s %10s %10s %12s %10s\n", "call", "calls",
+            "trans", "windows", "commands", "px written", "px read", "bytes",
+            "bytes/call");
+    for (const auto &it : calls_) {
+        const Stats &s = it.second.stats;
+        fprintf(out, "%-24s %8u %8u %8u %8u %10u %10u %12llu %10llu\n",
+                it.first.c_str(), it.second.calls, s.transactions, s.windows,
+                s.commands, s.pixelsWritten, s.pixelsRead,
+                (unsigned long long)s.bytes,
+                (unsigned long long)(s.bytes / it.second.calls));
+    }
+    fprintf(out, "%-24s %8s %8u %8u %8u %10u %10u %12llu\n", "total", "",
+            stats_.transactions, stats_.windows, stats_.commands,
+            stats_.pixelsWritten, stats_.pixelsRead,
+            (unsigned long long)stats_.bytes);
+}
+
+/***************************************************************************************
+** The bus: GPIO set and clear registers, the SPI controller registers that the
+** drivers write directly, and the Arduino SPI class. Only VSPI is wired to the panel.
+***************************************************************************************/
+HostGpio GPIO;
+
+HostGpioSetClear &HostGpioSetClear::operator=(uint32_t mask) {
+    if (set_)
+        *target_ |= mask;
+    else
+        *target_ &= ~mask;
+    if (target_ == &GPIO.out) Panel.pinsChanged(GPIO.out);
+    return *this;
+}
+
+uint32_t gpio_input_get(void) {
+    return GPIO.out;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= 32) return;
+    if (val)
+        GPIO.out_w1ts = 1u << pin;
+    else
+        GPIO.out_w1tc = 1u << pin;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < 32 && (GPIO.out & (1u << pin)) ? HIGH : LOW;
+}
+
+void pinMatrixOutAttach(uint8_t, uint8_t, bool, bool) {}
+void pinMatrixOutDetach(uint8_t, bool, bool) {}
+void pinMatrixInAttach(uint8_t, uint8_t, bool) {}
+void pinMatrixInDetach(uint8_t, bool, bool) {}
+
+static std::unordered_map<uint32_t, uint32_t> registers;
+
+uint32_t hostPeriRead(uint32_t addr) {
+    auto it = registers.find(addr);
+    return it == registers.end() ? 0 : it->second;
+}
+
+void hostPeriWrite(uint32_t addr, uint32_t value) {
+    if (addr == SPI_CMD_REG(VSPI) && (value & SPI_USR)) {
+        // Send the bits of W0..W15, low byte of each word first, and
+        // finish at once
+        uint32_t bits = (hostPeriRead(SPI_MOSI_DLEN_REG(VSPI)) & SPI_USR_MOSI_DBITLEN) + 1;
+        for (uint32_t i = 0; i < (bits + 7) / 8 && i < 64; i++) {
+            uint32_t word = hostPeriRead(SPI_W0_REG(VSPI) + (i & ~3u));
+            Panel.transfer(word >> ((i & 3) * 8));
+        }
+        value &= ~SPI_USR;
+    }
+    registers[addr] = value;
+}
+
+SPIClass SPI(VSPI);
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    return bus_ == VSPI ? Panel.transfer(data) : 0xFF;
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+    uint16_t in = transfer(data >> 8) << 8;
+    return in | transfer(data);
+}
+
+uint32_t SPIClass::transfer32(uint32_t data) {
+    uint32_t in = (uint32_t)transfer16(data >> 16) << 16;
+    return in | transfer16(data);
+}
+
+void SPIClass::transferBytes(const uint8_t *data, uint8_t *out, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        uint8_t in = transfer(data ? data[i] : 0xFF);
+        if (out) out[i] = in;
+    }
+}
+
+void SPIClass::writeBytes(const uint8_t *data, uint32_t size) {
+    while (size--) transfer(*data++);
+}
+
+void SPIClass::writePixels(const void *data, uint32_t size) {
+    const uint16_t *pixels = (const uint16_t *)data;
+    for (uint32_t i = 0; i < size / 2; i++) transfer16(pixels[i]);
+}
+
+void SPIClass::writePattern(const uint8_t *data, uint8_t size, uint32_t repeat) {
+    while (repeat--) writeBytes(data, size);
+}
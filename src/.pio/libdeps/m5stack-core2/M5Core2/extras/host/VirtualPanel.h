@@ -0,0 +1,119 @@
+// Host build: the display panel at the other end of the SPI bus.
+//
+// VirtualPanel decodes the bytes the drivers clock out, using the CS and DC
+// pins like the ILI9342C of the Core2 does: the column and page addresses,
+// the memory access control (rotation), memory writes and reads. Pixels land
+// in a 320x240 RGB565 memory in the panel's native orientation, which is
+// what the screen shows with setRotation(1).
+//
+// Along the way it counts what the drawing cost on the bus, for the whole
+// run and for each named call:
+//
+//     Panel.resetStats();
+//     {
+//         VirtualPanel::Call call("fillRect");
+//         M5.Lcd.fillRect(10, 10, 100, 50, RED);
+//     }
+//     Panel.printReport();
+//     Panel.writePPM("frame.ppm");
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <map>
+#include <string>
+
+class VirtualPanel {
+   public:
+    static const int WIDTH  = 320;
+    static const int HEIGHT = 240;
+
+    struct Stats {
+        uint32_t transactions;   // Times CS went low
+        uint32_t windows;        // Memory writes and reads started (RAMWR, RAMRD)
+        uint32_t commands;       // Command bytes, including the windows
+        uint32_t pixelsWritten;  // Pixels stored in the panel memory
+        uint32_t pixelsRead;     // Pixels sent back by the panel
+        uint64_t bytes;          // Bytes clocked on the bus, both ways
+    };
+
+    // Per-call accounting: the statistics between the constructor and the
+    // destructor are added to the calls of that name
+    class Call {
+       public:
+        explicit Call(const char *name);
+        ~Call();
+    };
+
+    VirtualPanel();
+
+    // Power on: black memory, default registers, statistics cleared
+    void reset();
+
+    // Bus side, called by the SPI and GPIO emulation
+    void pinsChanged(uint32_t levels);
+    uint8_t transfer(uint8_t mosi);
+
+    // The panel memory
+    uint16_t readPixel(int x, int y) const;
+    const uint16_t *frameBuffer() const { return memory_; }
+    bool inverted() const { return inverted_; }
+    bool writePPM(const char *path) const;
+
+    // Statistics
+    const Stats &stats() const { return stats_; }
+    void resetStats();
+    void beginCall(const char *name);
+    void endCall();
+    const Stats &lastCall() const { return lastCall_; }
+    void printReport(FILE *out = stdout) const;
+
+   private:
+    struct CallTotals {
+        uint32_t calls;
+        Stats stats;
+    };
+
+    uint16_t memory_[WIDTH * HEIGHT];
+
+    // Interface state
+    bool csLow_;
+    bool dcData_;
+    uint8_t command_;
+    uint32_t argCount_;
+    uint8_t args_[4];
+    uint8_t pixelHigh_;
+    uint16_t readColor_;
+
+    // Controller registers
+    uint16_t colStart_, colEnd_;
+    uint16_t pageStart_, pageEnd_;
+    uint16_t col_, page_;
+    uint8_t madctl_;
+    bool inverted_;
+
+    Stats stats_;
+    Stats callStart_;
+    Stats lastCall_;
+    std::string callName_;
+    uint32_t callDepth_;
+    std::map<std::string, CallTotals> calls_;
+
+    void command(uint8_t cmd);
+    void data(uint8_t value);
+    uint8_t readData();
+    void storePixel(uint16_t color);
+    uint16_t *memoryAt(uint16_t col, uint16_t page);
+    void advance();
+};
+
+extern VirtualPanel Panel;
+
+inline VirtualPanel::Call::Call(const char *name) {
+    Panel.beginCall(name);
+}
+
+inline VirtualPanel::Call::~Call() {
+    Panel.endCall();
+}
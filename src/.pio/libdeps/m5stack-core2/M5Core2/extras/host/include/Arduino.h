@@ -0,0 +1,91 @@
+// Host build: the parts of the Arduino core for ESP32 that the display
+// drivers use. Time is real time plus the delays, which return at once, pins
+// go to the virtual panel, and PSRAM is ordinary heap.
+#pragma once
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "Print.h"
+#include "WString.h"
+#include "pgmspace.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "soc/gpio_struct.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+using std::max;
+using std::min;
+
+#define HIGH   0x1
+#define LOW    0x0
+#define INPUT  0x01
+#define OUTPUT 0x02
+#define INPUT_PULLUP   0x05
+#define INPUT_PULLDOWN 0x09
+
+#define PI         3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) \
+    ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define sq(x)        ((x) * (x))
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// The LED PWM controller, which only drives the back-light
+inline double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcWrite(uint8_t, uint32_t) {}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+bool psramFound(void);
+void *ps_malloc(size_t size);
+void *ps_calloc(size_t n, size_t size);
+
+// The ESP-IDF log macros, printed to stderr for errors and warnings only
+#define log_e(format, ...) fprintf(stderr, "[E] " format "\n", ##__VA_ARGS__)
+#define log_w(format, ...) fprintf(stderr, "[W] " format "\n", ##__VA_ARGS__)
+#define log_i(format, ...)
+#define log_d(format, ...)
+#define log_v(format, ...)
+
+// The serial port writes to stdout
+class HardwareSerial : public Print {
+   public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+extern HardwareSerial Serial;
+
+// The number conversions of the AVR libc that the ESP32 core also provides
+char *ltoa(long value, char *str, int radix);
+char *ultoa(unsigned long value, char *str, int radix);
+char *itoa(int value, char *str, int radix);
+char *utoa(unsigned int value, char *str, int radix);
+char *dtostrf(double value, signed char width, unsigned char prec, char *str);
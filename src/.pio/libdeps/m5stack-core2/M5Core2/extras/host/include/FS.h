@@ -0,0 +1,77 @@
+// Host build: files are read from a directory of the host, the one given by
+// the HOST_FS_ROOT environment variable, or "data" like PlatformIO's
+// filesystem image
+#pragma once
+
+#include <stdio.h>
+
+#include <Arduino.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Print {
+   public:
+    File(FILE *f = nullptr) : f_(f) {}
+
+    size_t write(uint8_t c) override { return f_ && fputc(c, f_) != EOF ? 1 : 0; }
+    size_t write(const uint8_t *buf, size_t size) override {
+        return f_ ? fwrite(buf, 1, size, f_) : 0;
+    }
+    using Print::write;
+
+    int read() { return f_ ? fgetc(f_) : -1; }
+    size_t read(uint8_t *buf, size_t size) { return f_ ? fread(buf, 1, size, f_) : 0; }
+    size_t readBytes(char *buf, size_t size) { return read((uint8_t *)buf, size); }
+    int peek() {
+        int c = read();
+        if (c != -1) ungetc(c, f_);
+        return c;
+    }
+    int available() { return f_ ? (int)(size() - position()) : 0; }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+        return f_ && fseek(f_, pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+    }
+    size_t position() const { return f_ ? ftell(f_) : 0; }
+    size_t size() const {
+        if (!f_) return 0;
+        long pos = ftell(f_);
+        fseek(f_, 0, SEEK_END);
+        long end = ftell(f_);
+        fseek(f_, pos, SEEK_SET);
+        return end;
+    }
+    void close() {
+        if (f_) fclose(f_);
+        f_ = nullptr;
+    }
+    operator bool() const { return f_ != nullptr; }
+
+   private:
+    FILE *f_;
+};
+
+class FS {
+   public:
+    bool begin(bool = false) { return true; }
+    File open(const char *path, const char *mode = FILE_READ);
+    File open(const String &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+};
+
+}  // namespace fs
+
+#ifndef FS_NO_GLOBALS
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
+#endif
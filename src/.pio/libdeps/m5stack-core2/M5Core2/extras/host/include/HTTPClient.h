@@ -0,0 +1,32 @@
+// Host build: there is no network, so M5Display::drawPngUrl() finds WiFi
+// disconnected and returns
+#pragma once
+
+#include <Arduino.h>
+
+#define HTTP_CODE_OK 200
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class WiFiClient {
+   public:
+    int available() { return 0; }
+    size_t readBytes(uint8_t *, size_t) { return 0; }
+    bool connected() { return false; }
+};
+
+class WiFiClass {
+   public:
+    wl_status_t status() { return WL_DISCONNECTED; }
+};
+extern WiFiClass WiFi;
+
+class HTTPClient {
+   public:
+    bool begin(const char *) { return false; }
+    int GET() { return -1; }
+    int getSize() { return -1; }
+    WiFiClient *getStreamPtr() { return nullptr; }
+    bool connected() { return false; }
+    void end() {}
+};
@@ -0,0 +1,20 @@
+// Host build: a touch panel that is never touched, for the TFT_eSPI touch
+// emulation of M5Display
+#pragma once
+
+#include <stdint.h>
+
+class M5Touch {
+   public:
+    struct TouchPoint {
+        int16_t x, y;
+    };
+
+    static M5Touch *instance;
+
+    bool ispressed() { return false; }
+    void read() {}
+
+    uint8_t points = 0;
+    TouchPoint point[2];
+};
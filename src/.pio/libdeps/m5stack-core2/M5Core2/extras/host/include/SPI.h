@@ -0,0 +1,57 @@
+// Host build: the Arduino SPI class, connected to the virtual panel
+#pragma once
+
+#include <Arduino.h>
+
+#define HSPI 2
+#define VSPI 3
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+class SPISettings {
+   public:
+    SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = MSBFIRST,
+                uint8_t dataMode = SPI_MODE0)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+   public:
+    explicit SPIClass(uint8_t bus = VSPI) : bus_(bus) {}
+
+    void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+    void end() {}
+    void setHwCs(bool) {}
+    void setBitOrder(uint8_t) {}
+    void setDataMode(uint8_t) {}
+    void setFrequency(uint32_t) {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction(void) {}
+
+    // Everything goes out MSB first, like the ESP32 core
+    uint8_t transfer(uint8_t data);
+    uint16_t transfer16(uint16_t data);
+    uint32_t transfer32(uint32_t data);
+    void transferBytes(const uint8_t *data, uint8_t *out, uint32_t size);
+
+    void write(uint8_t data) { transfer(data); }
+    void write16(uint16_t data) { transfer16(data); }
+    void write32(uint32_t data) { transfer32(data); }
+    void writeBytes(const uint8_t *data, uint32_t size);
+    void writePixels(const void *data, uint32_t size);  // 16 bit words, sent MSB first
+    void writePattern(const uint8_t *data, uint8_t size, uint32_t repeat);
+
+   private:
+    uint8_t bus_;
+};
+
+extern SPIClass SPI;
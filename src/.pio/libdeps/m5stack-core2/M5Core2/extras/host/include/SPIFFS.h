@@ -0,0 +1,6 @@
+// Host build: see FS.h
+#pragma once
+
+#include "FS.h"
+
+extern fs::FS SPIFFS;
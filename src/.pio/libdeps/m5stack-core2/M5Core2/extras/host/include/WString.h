@@ -0,0 +1,87 @@
+// Host build: the String class of the Arduino core, on top of std::string
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+class String {
+   public:
+    String(const char *s = "") : s_(s ? s : "") {}
+    String(const std::string &s) : s_(s) {}
+    explicit String(char c) : s_(1, c) {}
+    explicit String(int n, unsigned char base = 10) { fromLong(n, base); }
+    explicit String(unsigned int n, unsigned char base = 10) { fromULong(n, base); }
+    explicit String(long n, unsigned char base = 10) { fromLong(n, base); }
+    explicit String(unsigned long n, unsigned char base = 10) { fromULong(n, base); }
+    explicit String(double n, unsigned int digits = 2) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", digits, n);
+        s_ = buf;
+    }
+
+    const char *c_str() const { return s_.c_str(); }
+    unsigned int length() const { return s_.length(); }
+    char charAt(unsigned int i) const { return i < s_.length() ? s_[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+
+    void toCharArray(char *buf, unsigned int size, unsigned int index = 0) const {
+        getBytes((unsigned char *)buf, size, index);
+    }
+    void getBytes(unsigned char *buf, unsigned int size, unsigned int index = 0) const {
+        if (!size || !buf) return;
+        size_t n = index < s_.length() ? s_.length() - index : 0;
+        if (n > size - 1) n = size - 1;
+        memcpy(buf, s_.c_str() + (index < s_.length() ? index : 0), n);
+        buf[n] = 0;
+    }
+
+    int indexOf(const char *str, unsigned int from = 0) const {
+        size_t i = s_.find(str, from);
+        return i == std::string::npos ? -1 : (int)i;
+    }
+    int indexOf(const String &str, unsigned int from = 0) const { return indexOf(str.c_str(), from); }
+    bool endsWith(const String &suffix) const {
+        return s_.size() >= suffix.s_.size() && s_.compare(s_.size() - suffix.s_.size(), suffix.s_.size(), suffix.s_) == 0;
+    }
+    bool startsWith(const String &prefix) const { return s_.compare(0, prefix.s_.size(), prefix.s_) == 0; }
+    String substring(unsigned int from, unsigned int to = ~0u) const {
+        if (from > s_.size()) return String();
+        return String(s_.substr(from, to == ~0u ? std::string::npos : to - from));
+    }
+    long toInt() const { return atol(s_.c_str()); }
+    float toFloat() const { return atof(s_.c_str()); }
+
+    String &operator+=(const String &rhs) { s_ += rhs.s_; return *this; }
+    String &operator+=(const char *rhs) { s_ += rhs; return *this; }
+    String &operator+=(char c) { s_ += c; return *this; }
+    friend String operator+(String lhs, const String &rhs) { return lhs += rhs; }
+    friend String operator+(String lhs, const char *rhs) { return lhs += rhs; }
+    bool operator==(const String &rhs) const { return s_ == rhs.s_; }
+    bool operator!=(const String &rhs) const { return s_ != rhs.s_; }
+    bool operator==(const char *rhs) const { return s_ == rhs; }
+
+   private:
+    std::string s_;
+
+    void fromULong(unsigned long n, unsigned char base) {
+        char buf[8 * sizeof(long) + 1], *p = buf + sizeof(buf) - 1;
+        *p = 0;
+        do {
+            unsigned d = n % base;
+            *--p = d < 10 ? '0' + d : 'A' + d - 10;
+            n /= base;
+        } while (n);
+        s_ = p;
+    }
+    void fromLong(long n, unsigned char base) {
+        if (n < 0 && base == 10) {
+            fromULong(-(unsigned long)n, base);
+            s_.insert(s_.begin(), '-');
+        } else {
+            fromULong((unsigned long)n, base);
+        }
+    }
+};
@@ -0,0 +1,34 @@
+// Host build: queues and tasks on host threads, for the code that hands work
+// to the other core. Priorities and cores are ignored, and a task ends when
+// its function returns.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void *QueueHandle_t;
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE        1
+#define pdFALSE       0
+#define pdPASS        pdTRUE
+#define pdFAIL        pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+
+// Items are copied in and out. The waits take the ticks as milliseconds.
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait);
+void vQueueDelete(QueueHandle_t queue);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name,
+                                   uint32_t stackDepth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core);
+inline void vTaskDelete(TaskHandle_t) {}
+inline UBaseType_t uxTaskPriorityGet(TaskHandle_t) { return 1; }
+inline BaseType_t xPortGetCoreID(void) { return 1; }
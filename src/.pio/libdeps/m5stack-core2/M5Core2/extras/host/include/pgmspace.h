@@ -0,0 +1,32 @@
+// Host build: program memory is ordinary memory
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+#define PROGMEM
+#define PGM_P       const char *
+#define PSTR(s)     (s)
+#define F(s)        (s)
+
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) hostPgmReadDword(addr)
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define pgm_read_ptr(addr)   (*(void *const *)(addr))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+// The drivers read the pointers of their font tables with pgm_read_dword(),
+// which only works where pointers are 32 bits: on a 64 bit host, read those
+// as whole pointers
+template <typename T>
+inline auto hostPgmReadDword(const T *addr) {
+    if constexpr (std::is_pointer<T>::value)
+        return (uintptr_t)*addr;
+    else
+        return *(const uint32_t *)addr;
+}
@@ -0,0 +1,53 @@
+// Host build: the inflater of the ESP32 ROM (miniz tinfl), implemented with
+// the host's zlib. Only the streaming use that pngle makes of it is covered.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned long mz_ulong;
+typedef unsigned char mz_uint8;
+typedef unsigned int mz_uint;
+typedef uint32_t mz_uint32;
+
+#define MZ_CRC32_INIT 0
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+#define TINFL_FLAG_PARSE_ZLIB_HEADER             1
+#define TINFL_FLAG_HAS_MORE_INPUT                2
+#define TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF 4
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM        = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED           = -1,
+    TINFL_STATUS_DONE             = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT  = 2
+} tinfl_status;
+
+typedef struct {
+    z_stream zs;
+    int started;
+} tinfl_decompressor;
+
+// pngle resets the decompressor before and after each image, which is
+// where the zlib stream of the last one is released
+void tinfl_init(tinfl_decompressor *r);
+
+mz_ulong mz_crc32(mz_ulong crc, const mz_uint8 *ptr, size_t buf_len);
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *pIn_buf_next,
+                              size_t *pIn_buf_size, mz_uint8 *pOut_buf_start,
+                              mz_uint8 *pOut_buf_next, size_t *pOut_buf_size,
+                              const mz_uint32 decomp_flags);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+// Host build: the ESP32 keeps TJpgDec in ROM and the host has no copy of it.
+// Instead jd_prepare() and jd_decomp() read a raw stand-in, so that the code
+// around the decoder can be checked:
+//
+//     "HOSTJPEG", width and height (16 bits, little endian), block width and
+//     height (8 or 16 each), then the blocks left to right and top to
+//     bottom, each one whole, as RGB bytes row by row
+//
+// The blocks are handed to the output function clipped to the image, as
+// TJpgDec does. Scaling keeps the top left pixel of each square, and drops
+// the edge blocks left with no pixels. Real JPEG files are rejected with
+// JDR_FMT3 (unsupported format).
+#pragma once
+
+#include <stdint.h>
+
+typedef enum {
+    JDR_OK = 0,
+    JDR_INTR,
+    JDR_INP,
+    JDR_MEM1,
+    JDR_MEM2,
+    JDR_PAR,
+    JDR_FMT1,
+    JDR_FMT2,
+    JDR_FMT3
+} JRESULT;
+
+typedef struct {
+    uint16_t left, right, top, bottom;
+} JRECT;
+
+typedef struct JDEC JDEC;
+struct JDEC {
+    uint32_t dctr;
+    uint8_t *dptr;
+    uint8_t *inbuf;
+    uint8_t dmsk;
+    uint8_t scale;
+    uint8_t msx, msy;
+    uint8_t qtid[3];
+    int16_t dcv[3];
+    uint16_t nrst;
+    uint16_t width, height;
+    uint8_t *huffbits[2][2];
+    uint16_t *huffcode[2][2];
+    uint8_t *huffdata[2][2];
+    int32_t *qttbl[4];
+    void *workbuf;
+    uint8_t *mcubuf;
+    void *pool;
+    uint32_t sz_pool;
+    uint32_t (*infunc)(JDEC *, uint8_t *, uint32_t);
+    void *device;
+};
+
+JRESULT jd_prepare(JDEC *jd, uint32_t (*infunc)(JDEC *, uint8_t *, uint32_t),
+                   void *pool, uint32_t sz_pool, void *dev);
+JRESULT jd_decomp(JDEC *jd, uint32_t (*outfunc)(JDEC *, void *, JRECT *),
+                  uint8_t scale);
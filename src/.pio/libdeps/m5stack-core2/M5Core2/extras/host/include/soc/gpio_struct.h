@@ -0,0 +1,50 @@
+// Host build: the GPIO output registers. Writing a set or clear register
+// updates the pin levels that the virtual panel watches for its CS and DC
+// lines. It is initialized at compile time, so that the constructors of
+// global display objects can use it.
+#pragma once
+
+#include <stdint.h>
+
+class HostGpioSetClear {
+   public:
+    constexpr HostGpioSetClear(uint32_t *target, bool set) : target_(target), set_(set) {}
+    HostGpioSetClear &operator=(uint32_t mask);
+
+   private:
+    uint32_t *target_;
+    bool set_;
+};
+
+struct HostGpioPin {
+    uint32_t val;
+};
+
+struct HostGpio {
+    uint32_t out    = 0xFFFFFFFF;  // Pins idle high
+    uint32_t enable = 0;
+    HostGpioSetClear out_w1ts{&out, true};
+    HostGpioSetClear out_w1tc{&out, false};
+    HostGpioSetClear enable_w1ts{&enable, true};
+    HostGpioSetClear enable_w1tc{&enable, false};
+    HostGpioPin pin[40] = {};
+};
+
+extern HostGpio GPIO;
+
+uint32_t gpio_input_get(void);
+
+// The ESP32 GPIO matrix, used to turn MOSI around for reads
+void pinMatrixOutAttach(uint8_t pin, uint8_t function, bool invertOut, bool invertEnable);
+void pinMatrixOutDetach(uint8_t pin, bool invertOut, bool invertEnable);
+void pinMatrixInAttach(uint8_t pin, uint8_t signal, bool inverted);
+void pinMatrixInDetach(uint8_t signal, bool high, bool inverted);
+
+#define VSPID_IN_IDX  64
+#define VSPID_OUT_IDX 64
+#define VSPIQ_IN_IDX  65
+#define VSPIQ_OUT_IDX 65
+#define HSPID_IN_IDX  9
+#define HSPID_OUT_IDX 9
+#define HSPIQ_IN_IDX  8
+#define HSPIQ_OUT_IDX 8
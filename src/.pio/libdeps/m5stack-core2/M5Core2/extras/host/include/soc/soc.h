@@ -0,0 +1,22 @@
+// Host build: peripheral registers are simulated, see VirtualPanel.cpp
+#pragma once
+
+#include <stdint.h>
+
+uint32_t hostPeriRead(uint32_t addr);
+void hostPeriWrite(uint32_t addr, uint32_t value);
+
+#define REG_READ(addr)         hostPeriRead((uint32_t)(addr))
+#define REG_WRITE(addr, val)   hostPeriWrite((uint32_t)(addr), (uint32_t)(val))
+#define READ_PERI_REG(addr)    hostPeriRead((uint32_t)(addr))
+#define WRITE_PERI_REG(addr, val) \
+    hostPeriWrite((uint32_t)(addr), (uint32_t)(val))
+#define SET_PERI_REG_MASK(addr, mask) \
+    WRITE_PERI_REG((addr), READ_PERI_REG(addr) | (mask))
+#define CLEAR_PERI_REG_MASK(addr, mask) \
+    WRITE_PERI_REG((addr), READ_PERI_REG(addr) & ~(mask))
+#define SET_PERI_REG_BITS(addr, bit_map, value, shift)                  \
+    WRITE_PERI_REG((addr), (READ_PERI_REG(addr) & ~((bit_map) << (shift))) | \
+                               (((value) & (bit_map)) << (shift)))
+#define GET_PERI_REG_BITS2(addr, mask, shift) \
+    ((READ_PERI_REG(addr) >> (shift)) & (mask))
@@ -0,0 +1,26 @@
+// Host build: helpers for the benchmarks
+#pragma once
+
+#include <stdlib.h>
+
+#include <chrono>
+
+// Iteration count from the command line, so that CTest can run a benchmark
+// once as a smoke test
+inline int benchIterations(int argc, char *argv[], int defaultValue) {
+    return argc > 1 ? atoi(argv[1]) : defaultValue;
+}
+
+class Stopwatch {
+   public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             start_)
+            .count();
+    }
+
+   private:
+    std::chrono::steady_clock::time_point start_;
+};
@@ -0,0 +1,27 @@
+// Host build: minimal assertions for the checks. A failed CHECK() reports the
+// location and the check keeps going; checkResult() is the exit code.
+#pragma once
+
+#include <stdio.h>
+
+inline int &checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition)) {                                                \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                    #condition);                                           \
+            checkFailures()++;                                             \
+        }                                                                  \
+    } while (0)
+
+inline int checkResult() {
+    if (checkFailures())
+        fprintf(stderr, "%d check(s) failed\n", checkFailures());
+    else
+        printf("ok\n");
+    return checkFailures() ? 1 : 0;
+}
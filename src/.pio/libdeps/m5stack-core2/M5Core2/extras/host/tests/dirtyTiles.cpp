@@ -0,0 +1,281 @@
+// Host build: pushSprite() with dirty tiles against a full pushSprite().
+//
+// Two sprites of the same random size, depth and tile size get the same
+// random drawing, frame after frame: rectangles, lines and pixels straddling
+// the tile edges and reaching past the sprite, then circles, text and images.
+// The sprite with tiles is pushed first, then the other one on top of it, and
+// the panel memory must not change. The sprite also moves now and then,
+// partly off the screen. For frames drawn with fillRect(), the fast lines and
+// pixels only, a tile map kept alongside gives the exact tiles and bytes
+// getDirtyTileStats() and the bus must show.
+#include <M5Display.h>
+
+#include <vector>
+
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static unsigned seed = 5;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+static int32_t between(int32_t low, int32_t high) {
+    return low + (int32_t)random(high - low + 1);
+}
+
+/***************************************************************************************
+** The tiles the drawing should mark
+***************************************************************************************/
+class TileModel {
+   public:
+    TileModel(int32_t width, int32_t height, uint8_t size)
+        : width_(width), height_(height) {
+        // The largest power of 2 up to size, from 8 to 128
+        tile_ = 8;
+        while (tile_ < 128 && tile_ * 2 <= size) tile_ *= 2;
+        tilesX_ = (width + tile_ - 1) / tile_;
+        tilesY_ = (height + tile_ - 1) / tile_;
+        dirty_.assign(tilesX_ * tilesY_, 1);
+    }
+
+    void mark(int32_t x, int32_t y, int32_t w, int32_t h) {
+        int32_t x0 = std::max(x, 0), y0 = std::max(y, 0);
+        int32_t x1 = std::min(x + w, width_), y1 = std::min(y + h, height_);
+        if (x1 <= x0 || y1 <= y0) return;
+        for (int32_t ty = 0; ty < tilesY_; ty++)
+            for (int32_t tx = 0; tx < tilesX_; tx++)
+                if (tx * tile_ < x1 && (tx + 1) * tile_ > x0 &&
+                    ty * tile_ < y1 && (ty + 1) * tile_ > y0)
+                    dirty_[ty * tilesX_ + tx] = 1;
+    }
+
+    void markAll() { dirty_.assign(dirty_.size(), 1); }
+
+    uint32_t tiles() const {
+        uint32_t n = 0;
+        for (uint8_t d : dirty_) n += d;
+        return n;
+    }
+
+    // Pixel bytes of the dirty tiles that land on the screen, for a push at
+    // x, y, and of the whole sprite
+    uint32_t sent(int32_t x, int32_t y) const { return bytes(x, y, true); }
+    uint32_t full(int32_t x, int32_t y) const { return bytes(x, y, false); }
+
+    void clear() { dirty_.assign(dirty_.size(), 0); }
+
+   private:
+    uint32_t bytes(int32_t x, int32_t y, bool dirtyOnly) const {
+        uint32_t n = 0;
+        for (int32_t py = 0; py < height_; py++)
+            for (int32_t px = 0; px < width_; px++) {
+                if (dirtyOnly && !dirty_[(py / tile_) * tilesX_ + px / tile_])
+                    continue;
+                int32_t sx = x + px, sy = y + py;
+                if (sx >= 0 && sy >= 0 && sx < tft.width() &&
+                    sy < tft.height())
+                    n += 2;
+            }
+        return n;
+    }
+
+    int32_t width_, height_, tile_, tilesX_, tilesY_;
+    std::vector<uint8_t> dirty_;
+};
+
+/***************************************************************************************
+** Drawing
+***************************************************************************************/
+// Draws on both sprites. Filled rectangles, fast lines and pixels are also
+// marked in the model, other shapes return false since it can't follow them.
+static bool drawSomething(TFT_eSprite &tiled, TFT_eSprite &plain,
+                          TileModel &model, bool rectsOnly) {
+    int32_t w = tiled.width(), h = tiled.height();
+    // A palette index for 4 bpp, 565 otherwise (the low byte is the index
+    // of an 8 bpp sprite with a palette)
+    uint32_t color = tiled.getColorDepth() == 4 ? random(16) : random(0x10000);
+    int32_t x = between(-20, w + 4), y = between(-20, h + 4);
+    int32_t dw = between(1, 60), dh = between(1, 60);
+
+    switch (random(rectsOnly ? 4 : 8)) {
+        case 0:
+            tiled.fillRect(x, y, dw, dh, color);
+            plain.fillRect(x, y, dw, dh, color);
+            model.mark(x, y, dw, dh);
+            return true;
+        case 1:
+            tiled.drawFastHLine(x, y, dw, color);
+            plain.drawFastHLine(x, y, dw, color);
+            model.mark(x, y, dw, 1);
+            return true;
+        case 2:
+            tiled.drawFastVLine(x, y, dh, color);
+            plain.drawFastVLine(x, y, dh, color);
+            model.mark(x, y, 1, dh);
+            return true;
+        case 3:
+            tiled.drawPixel(x, y, color);
+            plain.drawPixel(x, y, color);
+            model.mark(x, y, 1, 1);
+            return true;
+        case 4:
+            tiled.drawLine(x, y, x + dw - 30, y + dh - 30, color);
+            plain.drawLine(x, y, x + dw - 30, y + dh - 30, color);
+            return false;
+        case 5:
+            tiled.fillCircle(x, y, dw / 3, color);
+            plain.fillCircle(x, y, dw / 3, color);
+            return false;
+        case 6:
+            tiled.setTextColor(color);
+            plain.setTextColor(color);
+            tiled.drawString("Hit!", x, y, 2);
+            plain.drawString("Hit!", x, y, 2);
+            return false;
+        default: {
+            std::vector<uint16_t> image(dw * dh);
+            for (uint16_t &pixel : image) pixel = random(0x10000);
+            tiled.pushImage(x, y, dw, dh, image.data());
+            plain.pushImage(x, y, dw, dh, image.data());
+            return false;
+        }
+    }
+}
+
+/***************************************************************************************
+** Checks
+***************************************************************************************/
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static void setUp(TFT_eSprite &sprite, uint8_t depth, bool palette, int32_t w,
+                  int32_t h) {
+    sprite.setColorDepth(depth);
+    sprite.createSprite(w, h);
+    if (palette) sprite.createPalette();
+    sprite.fillSprite(0);
+}
+
+// Returns whether the tiles left anything out
+static bool checkCase(int index) {
+    static const uint8_t tileSizes[] = {8, 16, 20, 32, 64, 100, 128, 255};
+    static const uint8_t depths[]    = {4, 8, 8, 16};
+
+    uint8_t depth = depths[random(4)];
+    bool palette  = depth == 4 || (depth == 8 && random(2));
+    int32_t w     = between(1, 200);
+    int32_t h     = between(1, 150);
+    uint8_t size  = tileSizes[random(8)];
+    int failures  = checkFailures();
+
+    TFT_eSprite tiled(&tft), plain(&tft);
+    setUp(tiled, depth, palette, w, h);
+    setUp(plain, depth, palette, w, h);
+    tiled.setDirtyTiles(size);
+    TileModel model(w, h, size);
+
+    tft.fillScreen(random(0x10000));
+    int32_t x = between(-w / 2, tft.width() - w / 2);
+    int32_t y = between(-h / 2, tft.height() - h / 2);
+    uint32_t saved = 0;
+
+    for (int frame = 0; frame < 20; frame++) {
+        if (frame && random(6) == 0) {
+            x = between(-w / 2, tft.width() - w / 2);
+            y = between(-h / 2, tft.height() - h / 2);
+            model.markAll();
+        }
+        bool rectsOnly = random(2), modelled = true;
+        for (int n = random(6); n > 0; n--)
+            modelled &= drawSomething(tiled, plain, model, rectsOnly);
+
+        TFT_eSprite::dirtyTileStats before = tiled.getDirtyTileStats();
+        {
+            VirtualPanel::Call call("tiles");
+            tiled.pushSprite(x, y);
+        }
+        VirtualPanel::Stats bus           = Panel.lastCall();
+        TFT_eSprite::dirtyTileStats after = tiled.getDirtyTileStats();
+        std::vector<uint16_t> pushed      = panelMemory();
+
+        plain.pushSprite(x, y);
+        CHECK(panelMemory() == pushed);
+
+        CHECK(after.pushes == before.pushes + 1);
+        CHECK(after.lastSent + after.lastSaved == model.full(x, y));
+        CHECK(bus.pixelsWritten * 2 == after.lastSent);
+        CHECK(bus.transactions <= 1);
+        if (modelled) {
+            CHECK(after.tiles - before.tiles == model.tiles());
+            CHECK(after.lastSent == model.sent(x, y));
+        }
+        model.clear();
+        saved += after.lastSaved;
+    }
+
+    if (checkFailures() > failures)
+        fprintf(stderr, "  case %d: %dx%d at %u bpp%s, tiles of %u, at %d, %d\n",
+                index, w, h, depth, palette ? " with a palette" : "", size, x,
+                y);
+    return saved > 0;
+}
+
+// A 1 bpp sprite has no tiles, and is always pushed whole
+static void checkOneBit() {
+    TFT_eSprite sprite(&tft);
+    sprite.setColorDepth(1);
+    sprite.createSprite(64, 32);
+    sprite.setDirtyTiles(16);
+    sprite.fillSprite(TFT_WHITE);
+    {
+        VirtualPanel::Call call("1 bpp");
+        sprite.pushSprite(10, 10);
+        sprite.pushSprite(10, 10);
+    }
+    CHECK(Panel.lastCall().pixelsWritten == 2 * 64 * 32);
+    CHECK(sprite.getDirtyTileStats().pushes == 0);
+}
+
+// markDirty() after writing to the buffer directly
+static void checkMarkDirty() {
+    TFT_eSprite sprite(&tft);
+    sprite.setColorDepth(16);
+    uint16_t *pixels = (uint16_t *)sprite.createSprite(64, 64);
+    sprite.setDirtyTiles(16);
+    sprite.fillSprite(TFT_BLACK);
+    sprite.pushSprite(100, 100);
+
+    pixels[40 * 64 + 40] = 0xFFFF;
+    sprite.pushSprite(100, 100);
+    CHECK(sprite.getDirtyTileStats().lastSent == 0);
+    CHECK(Panel.readPixel(140, 140) != 0xFFFF);
+
+    sprite.markDirty(40, 40, 1, 1);
+    sprite.resetDirtyTileStats();
+    sprite.pushSprite(100, 100);
+    CHECK(sprite.getDirtyTileStats().tiles == 1);
+    CHECK(sprite.getDirtyTileStats().lastSent == 16 * 16 * 2);
+    CHECK(Panel.readPixel(140, 140) == 0xFFFF);
+}
+
+int main() {
+    tft.begin();
+    tft.setRotation(1);
+
+    int saving = 0;
+    for (int i = 0; i < 300; i++) saving += checkCase(i);
+    CHECK(saving > 100);  // the tiles did leave most frames out
+
+    checkOneBit();
+    checkMarkDirty();
+
+    return checkResult();
+}
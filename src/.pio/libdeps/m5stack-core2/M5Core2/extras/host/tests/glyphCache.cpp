@@ -0,0 +1,185 @@
+// Host build: smooth-font text with and without the glyph cache.
+//
+// A synthetic vlw font is written to a temporary directory. Each frame of a
+// weather screen draws labels in four colour pairs, some clipped at the
+// screen edges, and a ticking timestamp. The frame is drawn by a display
+// without the cache, then by one with it, on the same background, and the
+// panel memories must be identical. The budget shrinks for a while to force
+// evictions. The time and the bus cost of a frame are reported for both.
+#include <M5Display.h>
+#include <SPIFFS.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft, uncached;
+
+static unsigned seed = 1;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+static void put32(std::string &out, int32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out += char(value >> shift);
+}
+
+// The printable ASCII characters, with random sizes and alpha values: a
+// third transparent, a third opaque, the rest in between
+static std::string makeFont() {
+    const int count = 95;
+    std::string header, metrics, bitmaps;
+    put32(header, count);
+    put32(header, 11);  // version
+    put32(header, 18);  // size
+    put32(header, 0);
+    put32(header, 13);  // ascent
+    put32(header, 5);   // descent
+
+    for (int i = 0; i < count; i++) {
+        int width = 4 + random(9), height = 6 + random(10);
+        put32(metrics, 0x21 + i);
+        put32(metrics, height);
+        put32(metrics, width);
+        put32(metrics, width + 1);                  // xAdvance
+        put32(metrics, height - (int)random(4));    // dY
+        put32(metrics, (int)random(3) - 1);         // dX
+        put32(metrics, 0);
+        for (int p = 0; p < width * height; p++) {
+            unsigned r = random(10);
+            bitmaps += char(r < 4 ? 0 : r < 7 ? 255 : random(256));
+        }
+    }
+
+    std::string font = header + metrics + bitmaps;
+    font += char(9);
+    font += std::string("Synthetic") + '\0';
+    font += char(9);
+    font += std::string("Synthetic") + '\0';
+    font += char(1);  // smoothed
+    return font;
+}
+
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static void drawFrame(TFT_eSPI &tft, int frame) {
+    static const char *labels[] = {
+        "Temperature", "Feels like", "Humidity", "Wind",      "Pressure",
+        "Sunrise",     "Sunset",     "Fresno, CA", "Clear sky"};
+    static const uint16_t colors[] = {TFT_RED, TFT_BLUE, TFT_WHITE,
+                                      TFT_DARKGREY};
+
+    for (int i = 0; i < 9; i++) {
+        tft.setTextColor(colors[i % 4], i == 7 ? TFT_BLACK : TFT_WHITE);
+        // The last label starts past the left edge, the seventh one ends
+        // past the right edge
+        int x = (i % 2) * 160 - (i == 8 ? 6 : 0) + (i == 6 ? 130 : 0);
+        tft.drawString(labels[i], x, 10 + i * 22);
+    }
+
+    char timestamp[64];
+    snprintf(timestamp, sizeof(timestamp), "Last sync: %02d:%02d:%02d  %d.%dF",
+             (frame / 3600) % 24, (frame / 60) % 60, frame % 60,
+             40 + frame % 50, frame % 10);
+    tft.setTextColor(TFT_DARKGREY, TFT_WHITE);
+    tft.drawString(timestamp, 4, 220);
+}
+
+static uint16_t checkerboard(uint16_t x, uint16_t y) {
+    return (x / 8 + y / 8) % 2 ? TFT_WHITE : TFT_LIGHTGREY;
+}
+
+int main(int argc, char *argv[]) {
+    int frames            = benchIterations(argc, argv, 600);
+    const uint32_t budget = 16 * 1024;
+
+    char dir[] = "/tmp/fontXXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    std::string path = std::string(dir) + "/Synthetic.vlw";
+    std::string font = makeFont();
+    FILE *f          = fopen(path.c_str(), "wb");
+    fwrite(font.data(), 1, font.size(), f);
+    fclose(f);
+    setenv("HOST_FS_ROOT", dir, 1);
+
+    uncached.begin();
+    uncached.setRotation(1);
+    uncached.loadFont("Synthetic", SPIFFS);
+    tft.begin();
+    tft.setRotation(1);
+    tft.loadFont("Synthetic", SPIFFS);
+    tft.setGlyphCacheSize(budget);
+
+    double seconds[2] = {0, 0};
+    uint64_t bytes[2] = {0, 0};
+    int differing     = 0;
+
+    for (int frame = 0; frame < frames; frame++) {
+        if (frame == frames / 2) tft.setGlyphCacheSize(1024);
+        if (frame == frames * 2 / 3) tft.setGlyphCacheSize(budget);
+
+        std::vector<uint16_t> expected;
+        for (int pass = 0; pass < 2; pass++) {
+            tft.fillScreen(TFT_WHITE);
+            Panel.resetStats();
+            Stopwatch stopwatch;
+            drawFrame(pass ? (TFT_eSPI &)tft : uncached, frame);
+            seconds[pass] += stopwatch.seconds();
+            bytes[pass] += Panel.stats().bytes;
+            if (!pass) expected = panelMemory();
+        }
+        differing += panelMemory() != expected;
+    }
+    CHECK(differing == 0);
+
+    TFT_eSPI::glyphCacheStats stats = tft.getGlyphCacheStats();
+    CHECK(stats.used <= stats.budget);
+    if (frames > 1) {
+        CHECK(stats.hits > stats.misses);
+        CHECK(stats.evictions > 0);
+    }
+
+    printf("%d frames, %d with differing pixels\n", frames, differing);
+    for (int pass = 0; pass < 2; pass++)
+        printf("  %-9s %8.1f us %8llu bus bytes\n",
+               pass ? "cached" : "uncached", seconds[pass] * 1e6 / frames,
+               (unsigned long long)bytes[pass] / frames);
+    printf("  %u hits, %u misses (%.1f%%), %u evictions, %u of %u bytes\n",
+           stats.hits, stats.misses,
+           100.0 * stats.hits / (stats.hits + stats.misses), stats.evictions,
+           stats.used, stats.budget);
+
+    // A getColor callback bypasses the cache
+    tft.resetGlyphCacheStats();
+    tft.setCallback(checkerboard);
+    uncached.setCallback(checkerboard);
+    tft.fillScreen(TFT_WHITE);
+    drawFrame(uncached, 0);
+    std::vector<uint16_t> expected = panelMemory();
+    tft.fillScreen(TFT_WHITE);
+    drawFrame(tft, 0);
+    CHECK(panelMemory() == expected);
+    CHECK(tft.getGlyphCacheStats().hits == 0);
+    CHECK(tft.getGlyphCacheStats().misses == 0);
+    tft.setCallback(nullptr);
+
+    // Unloading the font frees the tiles
+    tft.unloadFont();
+    uncached.unloadFont();
+    CHECK(tft.getGlyphCacheStats().used == 0);
+
+    unlink(path.c_str());
+    rmdir(dir);
+    return checkResult();
+}
@@ -0,0 +1,294 @@
+// Host build: drawJpgPipelined() against drawJpg() and the source pixels.
+//
+// Random images in the stand-in format of rom/tjpgd.h, with blocks of 8x8,
+// 16x8 and 16x16 pixels and junk in the padding of the edge blocks, are drawn
+// at random positions, sizes, offsets and scales. drawJpg() sends each block
+// in its own window; drawJpgPipelined() collects each row of blocks in a
+// strip that a second task sends while the next one fills. Both must leave
+// the panel as the source pixels say, and the pipeline must take one window
+// per row of blocks. It also draws into sprites and from files, and rejects
+// what it should.
+#include <M5Display.h>
+#include <SPIFFS.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static unsigned seed = 13;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+static int32_t between(int32_t low, int32_t high) {
+    return low + (int32_t)random(high - low + 1);
+}
+
+/***************************************************************************************
+** Images
+***************************************************************************************/
+struct Image {
+    int w, h, mcuW, mcuH;
+    std::vector<uint8_t> rgb;  // w x h pixels
+    std::string stream;        // in the stand-in format
+};
+
+static Image makeImage(int w, int h, int mcuW, int mcuH) {
+    Image image = {w, h, mcuW, mcuH, {}, {}};
+    image.rgb.resize(w * h * 3);
+    for (uint8_t &byte : image.rgb) byte = random(256);
+
+    std::string &s = image.stream;
+    s = "HOSTJPEG";
+    s += char(w & 0xFF);
+    s += char(w >> 8);
+    s += char(h & 0xFF);
+    s += char(h >> 8);
+    s += char(mcuW);
+    s += char(mcuH);
+    for (int by = 0; by < h; by += mcuH)
+        for (int bx = 0; bx < w; bx += mcuW)
+            for (int j = 0; j < mcuH; j++)
+                for (int i = 0; i < mcuW; i++)
+                    for (int c = 0; c < 3; c++) {
+                        int x = bx + i, y = by + j;
+                        s += x < w && y < h
+                                 ? char(image.rgb[(y * w + x) * 3 + c])
+                                 : char(random(256));
+                    }
+    return image;
+}
+
+static std::string root;
+
+static void writeFile(const char *name, const std::string &data) {
+    FILE *f = fopen((root + name).c_str(), "wb");
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+/***************************************************************************************
+** Model
+***************************************************************************************/
+struct Placement {
+    uint16_t x, y, maxWidth, maxHeight, offX, offY;
+    jpeg_div_t scale;
+};
+
+// A random placement on a target of width x height that both functions take
+static Placement randomPlacement(const Image &image, int width, int height) {
+    Placement p;
+    int s = random(4);
+    while ((image.w >> s) == 0 || (image.h >> s) == 0) s--;
+    p.scale   = (jpeg_div_t)s;
+    p.offX    = random(4) ? 0 : random(image.w >> s);
+    p.offY    = random(4) ? 0 : random(image.h >> s);
+    p.x         = random(width);
+    p.y         = random(height);
+    p.maxWidth  = random(3) ? 0 : between(1, width - p.x);
+    p.maxHeight = random(3) ? 0 : between(1, height - p.y);
+    return p;
+}
+
+// The area drawn on a target of width x height
+static void drawnSize(const Image &image, const Placement &p, int width,
+                      int height, int *w, int *h) {
+    int s = p.scale;
+    *w = std::min(p.maxWidth ? p.maxWidth : width - p.x,
+                  (image.w >> s) - p.offX);
+    *h = std::min(p.maxHeight ? p.maxHeight : height - p.y,
+                  (image.h >> s) - p.offY);
+}
+
+// The target memory after drawing the image on it
+static std::vector<uint16_t> expectedMemory(std::vector<uint16_t> memory,
+                                            const Image &image,
+                                            const Placement &p, int width,
+                                            int height) {
+    int w, h, s = p.scale;
+    drawnSize(image, p, width, height, &w, &h);
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++) {
+            int u = (p.offX + x) << s, v = (p.offY + y) << s;
+            const uint8_t *c = &image.rgb[(v * image.w + u) * 3];
+            memory[(p.y + y) * width + p.x + x] =
+                (c[0] & 0xF8) << 8 | (c[1] & 0xFC) << 3 | c[2] >> 3;
+        }
+    return memory;
+}
+
+// The rows of blocks that have pixels in the drawn area
+static uint32_t visibleBlockRows(const Image &image, const Placement &p,
+                                 int width, int height) {
+    int w, h, s = p.scale;
+    drawnSize(image, p, width, height, &w, &h);
+    uint32_t rows = 0;
+    for (int by = 0; by < image.h; by += image.mcuH) {
+        int top    = by >> s;
+        int bottom = (std::min(by + image.mcuH, image.h) >> s) - 1;
+        if (bottom >= top && bottom >= p.offY && top < p.offY + h) rows++;
+    }
+    return rows;
+}
+
+/***************************************************************************************
+** Checks
+***************************************************************************************/
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> spriteMemory(TFT_eSprite &sprite) {
+    std::vector<uint16_t> pixels;
+    for (int y = 0; y < sprite.height(); y++)
+        for (int x = 0; x < sprite.width(); x++)
+            pixels.push_back(sprite.readPixel(x, y));
+    return pixels;
+}
+
+static Image randomImage() {
+    static const int blocks[][2] = {{8, 8}, {16, 8}, {16, 16}};
+    const int *mcu = blocks[random(3)];
+    return makeImage(between(1, 360), between(1, 270), mcu[0], mcu[1]);
+}
+
+static bool checkOnPanel(const Image &image, bool fromFile) {
+    Placement p = randomPlacement(image, tft.width(), tft.height());
+    uint16_t background = random(0x10000);
+    tft.fillScreen(background);
+    std::vector<uint16_t> expected =
+        expectedMemory(panelMemory(), image, p, tft.width(), tft.height());
+    const uint8_t *data = (const uint8_t *)image.stream.data();
+
+    tft.fillScreen(background);
+    uint32_t blockWindows;
+    {
+        VirtualPanel::Call call("drawJpg");
+        tft.drawJpg(data, image.stream.size(), p.x, p.y, p.maxWidth,
+                    p.maxHeight, p.offX, p.offY, p.scale);
+    }
+    blockWindows = Panel.lastCall().windows;
+    bool blocksMatch = panelMemory() == expected;
+
+    tft.fillScreen(background);
+    bool ok;
+    {
+        VirtualPanel::Call call("drawJpgPipelined");
+        if (fromFile) {
+            writeFile("/case.jpg", image.stream);
+            ok = tft.drawJpgPipelined(SPIFFS, "/case.jpg", p.x, p.y,
+                                      p.maxWidth, p.maxHeight, p.offX, p.offY,
+                                      p.scale);
+        } else {
+            ok = tft.drawJpgPipelined(data, image.stream.size(), p.x, p.y,
+                                      p.maxWidth, p.maxHeight, p.offX, p.offY,
+                                      p.scale);
+        }
+    }
+    CHECK(ok);
+    CHECK(blocksMatch);
+    CHECK(Panel.lastCall().windows ==
+          visibleBlockRows(image, p, tft.width(), tft.height()));
+    CHECK(Panel.lastCall().windows <= blockWindows);
+    CHECK(Panel.lastCall().transactions == Panel.lastCall().windows);
+    return panelMemory() == expected;
+}
+
+static bool checkOnSprite(const Image &image) {
+    TFT_eSprite sprite(&tft);
+    sprite.createSprite(between(1, 200), between(1, 150));
+    sprite.fillSprite(random(0x10000));
+    bool swap = random(2);
+    sprite.setSwapBytes(swap);
+
+    Placement p = randomPlacement(image, sprite.width(), sprite.height());
+    std::vector<uint16_t> expected = expectedMemory(
+        spriteMemory(sprite), image, p, sprite.width(), sprite.height());
+
+    Panel.resetStats();
+    CHECK(tft.drawJpgPipelined((const uint8_t *)image.stream.data(),
+                               image.stream.size(), p.x, p.y, p.maxWidth,
+                               p.maxHeight, p.offX, p.offY, p.scale, &sprite));
+    CHECK(sprite.getSwapBytes() == swap);
+    CHECK(Panel.stats().pixelsWritten == 0);
+    return spriteMemory(sprite) == expected;
+}
+
+static void checkAgainstModel(int cases) {
+    for (int i = 0; i < cases; i++) {
+        Image image = randomImage();
+        int failures = checkFailures();
+        if (random(3) == 0) {
+            if (!checkOnSprite(image))
+                CHECK(!"drawJpgPipelined() differs in a sprite");
+        } else {
+            if (!checkOnPanel(image, random(4) == 0))
+                CHECK(!"drawJpgPipelined() differs on the panel");
+        }
+        if (checkFailures() > failures)
+            fprintf(stderr, "  case %d: %dx%d in blocks of %dx%d\n", i, image.w,
+                    image.h, image.mcuW, image.mcuH);
+    }
+}
+
+// What both functions refuse leaves the panel alone
+static void checkRejected() {
+    Image image = makeImage(40, 30, 16, 16);
+    const uint8_t *data = (const uint8_t *)image.stream.data();
+    size_t size         = image.stream.size();
+    std::string real(size, '\0');
+    real[0] = (char)0xFF;
+    real[1] = (char)0xD8;
+
+    tft.fillScreen(TFT_NAVY);
+    std::vector<uint16_t> before = panelMemory();
+    Panel.resetStats();
+
+    CHECK(!tft.drawJpgPipelined((const uint8_t *)real.data(), size));
+    // Offsets past the image, scaled or not, and an area past the screen
+    CHECK(!tft.drawJpgPipelined(data, size, 0, 0, 0, 0, 40, 0));
+    CHECK(!tft.drawJpgPipelined(data, size, 0, 0, 0, 0, 0, 4, JPEG_DIV_8));
+    CHECK(!tft.drawJpgPipelined(data, size, 300, 0, 40, 30));
+    CHECK(!tft.drawJpgPipelined(SPIFFS, "/missing.jpg"));
+
+    TFT_eSprite sprite(&tft);
+    sprite.createSprite(20, 20);
+    CHECK(!tft.drawJpgPipelined(data, size, 10, 0, 20, 0, 0, 0, JPEG_DIV_NONE,
+                                &sprite));
+
+    CHECK(Panel.stats().pixelsWritten == 0);
+    CHECK(panelMemory() == before);
+
+    // And what works reports its time
+    jpeg_timing_t timing = {0, 0, 0};
+    CHECK(tft.drawJpgPipelined(data, size, 0, 0, 0, 0, 0, 0, JPEG_DIV_NONE,
+                               NULL, &timing));
+    CHECK(timing.total >= timing.decode);
+}
+
+int main() {
+    char dir[] = "/tmp/jpegXXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    root = dir;
+    setenv("HOST_FS_ROOT", dir, 1);
+
+    tft.begin();
+    tft.setRotation(1);
+
+    checkAgainstModel(300);
+    checkRejected();
+
+    unlink((root + "/case.jpg").c_str());
+    rmdir(dir);
+    return checkResult();
+}
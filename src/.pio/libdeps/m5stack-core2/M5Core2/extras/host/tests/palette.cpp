@@ -0,0 +1,305 @@
+// Host build: palette-indexed sprites against 16 bpp ones.
+//
+// A 4 bpp sprite and an 8 bpp sprite with createPalette() take random
+// fills, lines, rectangles, circles, text, images and scrolls in palette
+// indices, at odd sizes and mostly odd positions so that the nibble paths
+// of fillRect() and drawFastHLine() start and end in the middle of a byte. A
+// 16 bpp sprite gets the same drawing in the palette colours. Their pixels,
+// what they push to the panel at odd x, with and without a transparent
+// colour, and both again after a palette change must all match.
+//
+// Then a 320x240 sprite is measured at each depth: its heap blocks, a 251x61
+// fillRect() at an odd x, and the time and bus bytes of a pushSprite().
+#include <M5Display.h>
+
+#include <malloc.h>
+
+#include <vector>
+
+#include "Bench.h"
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static unsigned seed = 11;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+static int32_t between(int32_t low, int32_t high) {
+    return low + (int32_t)random(high - low + 1);
+}
+
+// Mostly odd, to start in the second pixel of a 4 bpp byte
+static int32_t oddBetween(int32_t low, int32_t high) {
+    int32_t v = between(low, high);
+    return random(4) ? v | 1 : v;
+}
+
+/***************************************************************************************
+** The two sprites
+***************************************************************************************/
+// An indexed sprite and its 16 bpp twin, drawn in the colours of its palette.
+// The colours are all different, so that the index of a colour is known.
+struct Twins {
+    TFT_eSprite indexed, reference;
+    std::vector<uint16_t> colors;
+
+    Twins(uint8_t depth, int32_t w, int32_t h)
+        : indexed(&tft), reference(&tft) {
+        colors.resize(1 << depth);
+        for (size_t i = 0; i < colors.size(); i++) colors[i] = freshColor();
+
+        indexed.setColorDepth(depth);
+        indexed.createSprite(w, h);
+        indexed.createPalette(colors.data(), colors.size());
+        reference.setColorDepth(16);
+        reference.createSprite(w, h);
+    }
+
+    uint16_t freshColor() const {
+        for (;;) {
+            uint16_t color = random(0x10000);
+            bool used      = false;
+            for (uint16_t c : colors) used |= c == color;
+            if (!used) return color;
+        }
+    }
+
+    // A palette change, followed on the reference
+    void recolor(uint8_t index) {
+        uint16_t old = colors[index], color = freshColor();
+        colors[index] = color;
+        indexed.setPaletteColor(index, color);
+        for (int32_t y = 0; y < reference.height(); y++)
+            for (int32_t x = 0; x < reference.width(); x++)
+                if (reference.readPixel(x, y) == old)
+                    reference.drawPixel(x, y, color);
+    }
+};
+
+static void drawSomething(Twins &t) {
+    int32_t w = t.indexed.width(), h = t.indexed.height();
+    uint8_t index  = random(t.colors.size());
+    uint16_t color = t.colors[index];
+    int32_t x = oddBetween(-10, w + 2), y = between(-10, h + 2);
+    int32_t dw = oddBetween(1, w + 10), dh = between(1, h + 10);
+
+    switch (random(10)) {
+        case 0:
+            t.indexed.fillRect(x, y, dw, dh, index);
+            t.reference.fillRect(x, y, dw, dh, color);
+            break;
+        case 1:
+            t.indexed.drawFastHLine(x, y, dw, index);
+            t.reference.drawFastHLine(x, y, dw, color);
+            break;
+        case 2:
+            t.indexed.drawFastVLine(x, y, dh, index);
+            t.reference.drawFastVLine(x, y, dh, color);
+            break;
+        case 3:
+            t.indexed.drawPixel(x, y, index);
+            t.reference.drawPixel(x, y, color);
+            break;
+        case 4:
+            t.indexed.drawLine(x, y, x + dw - w / 2, y + dh - h / 2, index);
+            t.reference.drawLine(x, y, x + dw - w / 2, y + dh - h / 2, color);
+            break;
+        case 5:
+            t.indexed.drawRect(x, y, dw, dh, index);
+            t.reference.drawRect(x, y, dw, dh, color);
+            break;
+        case 6:
+            t.indexed.fillCircle(x, y, dw / 4, index);
+            t.reference.fillCircle(x, y, dw / 4, color);
+            break;
+        case 7: {
+            // With a background half of the time
+            uint8_t bg = random(t.colors.size());
+            if (random(2)) {
+                t.indexed.setTextColor(index, bg);
+                t.reference.setTextColor(color, t.colors[bg]);
+            } else {
+                t.indexed.setTextColor(index);
+                t.reference.setTextColor(color);
+            }
+            t.indexed.drawString("Miss", x, y, 2);
+            t.reference.drawString("Miss", x, y, 2);
+            break;
+        }
+        case 8: {
+            // In palette colours, which pushImage() maps back to their index
+            std::vector<uint16_t> image(dw * dh);
+            for (uint16_t &pixel : image)
+                pixel = t.colors[random(t.colors.size())];
+            t.indexed.pushImage(x, y, dw, dh, image.data());
+            t.reference.pushImage(x, y, dw, dh, image.data());
+            break;
+        }
+        default: {
+            int32_t sx = between(0, w - 1), sy = between(0, h - 1);
+            int32_t sw = between(1, w - sx), sh = between(1, h - sy);
+            int16_t dx = between(-5, 5), dy = between(-5, 5);
+            t.indexed.setScrollRect(sx, sy, sw, sh, index);
+            t.reference.setScrollRect(sx, sy, sw, sh, color);
+            t.indexed.scroll(dx, dy);
+            t.reference.scroll(dx, dy);
+            break;
+        }
+    }
+}
+
+/***************************************************************************************
+** Checks
+***************************************************************************************/
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> spriteMemory(TFT_eSprite &sprite) {
+    std::vector<uint16_t> pixels;
+    for (int y = 0; y < sprite.height(); y++)
+        for (int x = 0; x < sprite.width(); x++)
+            pixels.push_back(sprite.readPixel(x, y));
+    return pixels;
+}
+
+// Pushes both sprites on the same background, returns whether the panel
+// memories match
+static bool samePush(Twins &t, int32_t x, int32_t y, int transparent) {
+    uint16_t background = t.freshColor();
+
+    tft.fillScreen(background);
+    if (transparent < 0)
+        t.reference.pushSprite(x, y);
+    else
+        t.reference.pushSprite(x, y, t.colors[transparent]);
+    std::vector<uint16_t> expected = panelMemory();
+
+    tft.fillScreen(background);
+    if (transparent < 0)
+        t.indexed.pushSprite(x, y);
+    else
+        t.indexed.pushSprite(x, y, transparent);
+    return panelMemory() == expected;
+}
+
+static void checkCase(int index) {
+    static const uint8_t depths[] = {4, 8};
+    uint8_t depth = depths[random(2)];
+    int32_t w     = oddBetween(1, 120);
+    int32_t h     = between(1, 90);
+    int failures  = checkFailures();
+
+    Twins t(depth, w, h);
+    uint8_t first = random(t.colors.size());
+    t.indexed.fillSprite(first);
+    t.reference.fillSprite(t.colors[first]);
+    CHECK(t.indexed.getPaletteColor(first) == t.colors[first]);
+
+    for (int n = random(30); n > 0; n--) drawSomething(t);
+    CHECK(spriteMemory(t.indexed) == spriteMemory(t.reference));
+
+    int32_t x = oddBetween(-w / 2, tft.width() - w / 2);
+    int32_t y = between(-h / 2, tft.height() - h / 2);
+    CHECK(samePush(t, x, y, -1));
+    CHECK(samePush(t, x, y, random(t.colors.size())));
+
+    t.recolor(random(t.colors.size()));
+    CHECK(spriteMemory(t.indexed) == spriteMemory(t.reference));
+    CHECK(samePush(t, x, y, -1));
+
+    if (checkFailures() > failures)
+        fprintf(stderr, "  case %d: %dx%d at %u bpp, pushed at %d, %d\n", index,
+                w, h, depth, x, y);
+}
+
+// The default palettes: the 16 colours of In_eSPI.h, and RGB332
+static void checkDefaultPalettes() {
+    static const uint16_t cga[] = {
+        TFT_BLACK,  TFT_NAVY,   TFT_DARKGREEN, TFT_DARKCYAN,
+        TFT_MAROON, TFT_PURPLE, TFT_OLIVE,     TFT_LIGHTGREY,
+        TFT_DARKGREY, TFT_BLUE, TFT_GREEN,     TFT_CYAN,
+        TFT_RED,    TFT_MAGENTA, TFT_YELLOW,   TFT_WHITE};
+
+    TFT_eSprite four(&tft), eight(&tft), rgb332(&tft);
+    four.setColorDepth(4);
+    four.createSprite(16, 1);
+    eight.setColorDepth(8);
+    eight.createSprite(16, 16);
+    eight.createPalette();
+    rgb332.setColorDepth(8);
+    rgb332.createSprite(16, 16);
+
+    for (int i = 0; i < 16; i++) {
+        four.drawPixel(i, 0, i);
+        CHECK(four.readPixel(i, 0) == cga[i]);
+    }
+    for (int i = 0; i < 256; i++) {
+        // The same byte, as an index and as RGB332
+        eight.drawPixel(i % 16, i / 16, i);
+        rgb332.drawPixel(i % 16, i / 16,
+                         (i & 0xE0) << 8 | (i & 0x1C) << 6 | (i & 0x03) << 3);
+    }
+    CHECK(spriteMemory(eight) == spriteMemory(rgb332));
+}
+
+/***************************************************************************************
+** Benchmark
+***************************************************************************************/
+// The heap blocks of a sprite: its pixels and its palette
+struct MeasuredSprite : TFT_eSprite {
+    MeasuredSprite() : TFT_eSprite(&tft) {}
+
+    size_t memory() {
+        return malloc_usable_size(_img8) +
+               (_colorMap ? malloc_usable_size(_colorMap) : 0);
+    }
+};
+
+static void benchmark(const char *name, uint8_t depth, bool palette,
+                      int iterations) {
+    MeasuredSprite sprite;
+    sprite.setColorDepth(depth);
+    sprite.createSprite(320, 240);
+    if (palette) sprite.createPalette();
+
+    uint32_t color = depth == 4 ? 9 : palette ? 0x4C : TFT_BLUE;
+    Stopwatch fillTime;
+    for (int i = 0; i < iterations * 20; i++)
+        sprite.fillRect(33, 91, 251, 61, color + (i & 1));
+    double fill = fillTime.seconds() / (iterations * 20);
+
+    Panel.resetStats();
+    Stopwatch pushTime;
+    for (int i = 0; i < iterations; i++) sprite.pushSprite(0, 0);
+    double push = pushTime.seconds() / iterations;
+
+    printf("  %-12s %7zu B %7.2f us %8.1f us %8llu\n", name, sprite.memory(),
+           fill * 1e6, push * 1e6,
+           (unsigned long long)Panel.stats().bytes / iterations);
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = benchIterations(argc, argv, 200);
+
+    tft.begin();
+    tft.setRotation(1);
+
+    checkDefaultPalettes();
+    for (int i = 0; i < 400; i++) checkCase(i);
+
+    printf("320x240 sprite    memory  fillRect  pushSprite bus bytes\n");
+    benchmark("16 bpp", 16, false, iterations);
+    benchmark("8 bpp RGB332", 8, false, iterations);
+    benchmark("8 bpp index", 8, true, iterations);
+    benchmark("4 bpp index", 4, true, iterations);
+
+    return checkResult();
+}
@@ -0,0 +1,100 @@
+// Host build: the virtual panel receives what the drivers send. Fills land in
+// its memory with the expected bus cost, reads come back through RAMRD, the
+// rotations map to the panel, and a scene drawn straight to the panel matches
+// the same scene drawn in a sprite.
+#include <M5Display.h>
+
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static int countPixels(uint16_t color) {
+    int count = 0;
+    for (int i = 0; i < VirtualPanel::WIDTH * VirtualPanel::HEIGHT; i++)
+        count += Panel.frameBuffer()[i] == color;
+    return count;
+}
+
+// fillScreen() isn't virtual, so the scene is drawn through the real type
+template <typename T>
+static void drawScene(T &g) {
+    g.fillScreen(TFT_NAVY);
+    g.fillCircle(160, 120, 50, TFT_YELLOW);
+    g.drawRoundRect(5, 5, 100, 60, 8, TFT_GREEN);
+    g.drawLine(0, 239, 319, 0, TFT_MAGENTA);
+    g.setTextColor(TFT_WHITE, TFT_NAVY);
+    g.drawString("Hello 123", 20, 200, 4);
+    g.drawNumber(4567, 200, 10, 7);
+    g.drawString("Free", 200, 180, 2);
+}
+
+int main() {
+    tft.begin();
+    Panel.resetStats();
+
+    {
+        VirtualPanel::Call call("fillScreen");
+        tft.fillScreen(TFT_RED);
+    }
+    CHECK(Panel.lastCall().windows == 1);
+    CHECK(Panel.lastCall().pixelsWritten == 320 * 240);
+    CHECK(countPixels(TFT_RED) == 320 * 240);
+
+    {
+        VirtualPanel::Call call("fillRect");
+        tft.fillRect(10, 20, 30, 40, TFT_BLUE);
+    }
+    CHECK(Panel.lastCall().transactions == 1);
+    CHECK(Panel.lastCall().pixelsWritten == 30 * 40);
+    CHECK(Panel.readPixel(10, 20) == TFT_BLUE);
+    CHECK(Panel.readPixel(39, 59) == TFT_BLUE);
+    CHECK(Panel.readPixel(9, 20) == TFT_RED);
+    CHECK(Panel.readPixel(40, 59) == TFT_RED);
+    CHECK(Panel.readPixel(39, 60) == TFT_RED);
+
+    // Reads go through RAMRD
+    tft.drawPixel(100, 100, 0x1234);
+    uint16_t read;
+    {
+        VirtualPanel::Call call("readPixel");
+        read = tft.readPixel(100, 100);
+    }
+    CHECK(read == Panel.readPixel(100, 100));
+    CHECK(Panel.lastCall().pixelsRead == 1);
+
+    // (5, 10) in each rotation, in the panel's native orientation
+    const int expected[4][2] = {
+        {319 - 10, 5}, {5, 10}, {10, 239 - 5}, {319 - 5, 239 - 10}};
+    for (int r = 0; r < 4; r++) {
+        tft.setRotation(r);
+        tft.fillScreen(TFT_BLACK);
+        tft.drawPixel(5, 10, TFT_WHITE);
+        CHECK(countPixels(TFT_WHITE) == 1);
+        CHECK(Panel.readPixel(expected[r][0], expected[r][1]) == TFT_WHITE);
+    }
+    tft.setRotation(1);
+
+    // The same scene on the panel and in a sprite
+    TFT_eSprite sprite(&tft);
+    sprite.setColorDepth(16);
+    CHECK(sprite.createSprite(320, 240) != nullptr);
+    drawScene(tft);
+    drawScene(sprite);
+    int differences = 0;
+    for (int y = 0; y < 240; y++)
+        for (int x = 0; x < 320; x++)
+            differences += sprite.readPixel(x, y) != Panel.readPixel(x, y);
+    CHECK(differences == 0);
+
+    tft.fillScreen(TFT_BLACK);
+    sprite.pushSprite(0, 0);
+    differences = 0;
+    for (int y = 0; y < 240; y++)
+        for (int x = 0; x < 320; x++)
+            differences += sprite.readPixel(x, y) != Panel.readPixel(x, y);
+    CHECK(differences == 0);
+    sprite.deleteSprite();
+
+    return checkResult();
+}
@@ -0,0 +1,261 @@
+// Host build: drawPngFile() against a per-pixel reference.
+//
+// The images are encoded here with zlib: RGB and RGBA, progressive and Adam7
+// interlaced. The reference decodes the same file with pngle and calls
+// fillRect() for every pixel, which is what drawPngFile() did before it
+// buffered rows. Both draw on the panel, and the panel memories must be
+// identical, with fewer address windows for drawPngFile().
+#include <M5Display.h>
+#include <SPIFFS.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "VirtualPanel.h"
+#include "utility/pngle.h"
+
+M5Display tft;
+
+static unsigned seed = 7;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+/***************************************************************************************
+** Encoder
+***************************************************************************************/
+static void put32(std::string &out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out += char(value >> shift);
+}
+
+static void putChunk(std::string &out, const char *type,
+                     const std::string &data) {
+    put32(out, data.size());
+    std::string body = type + data;
+    out += body;
+    put32(out, crc32(0, (const Bytef *)body.data(), body.size()));
+}
+
+// The pixels are RGBA, the alpha is dropped when hasAlpha is false
+static std::string encodePng(const std::vector<uint8_t> &rgba, int w, int h,
+                             bool hasAlpha, bool interlaced) {
+    static const int adam7[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8},
+                                    {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2},
+                                    {0, 1, 1, 2}};
+    static const int progressive[1][4] = {{0, 0, 1, 1}};
+    const int(*passes)[4] = interlaced ? adam7 : progressive;
+    int channels          = hasAlpha ? 4 : 3;
+
+    // Filter type 0 on every row
+    std::string raw;
+    for (int pass = 0; pass < (interlaced ? 7 : 1); pass++) {
+        const int *p = passes[pass];
+        if (p[0] >= w || p[1] >= h) continue;
+        for (int y = p[1]; y < h; y += p[3]) {
+            raw += '\0';
+            for (int x = p[0]; x < w; x += p[2])
+                raw.append((const char *)&rgba[(y * w + x) * 4], channels);
+        }
+    }
+
+    std::vector<uint8_t> packed(compressBound(raw.size()));
+    uLongf packedSize = packed.size();
+    compress(packed.data(), &packedSize, (const Bytef *)raw.data(), raw.size());
+
+    std::string ihdr;
+    put32(ihdr, w);
+    put32(ihdr, h);
+    ihdr += char(8);                  // bit depth
+    ihdr += char(hasAlpha ? 6 : 2);   // colour type
+    ihdr += char(0);                  // compression
+    ihdr += char(0);                  // filter
+    ihdr += char(interlaced ? 1 : 0);
+
+    std::string png = "\x89PNG\r\n\x1a\n";
+    putChunk(png, "IHDR", ihdr);
+    putChunk(png, "IDAT", std::string((const char *)packed.data(), packedSize));
+    putChunk(png, "IEND", "");
+    return png;
+}
+
+static std::string root;
+
+static void writeFile(const char *name, const std::string &data) {
+    FILE *f = fopen((root + name).c_str(), "wb");
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+/***************************************************************************************
+** Reference: one fillRect() per pixel
+***************************************************************************************/
+struct Reference {
+    uint16_t x, y, maxWidth, maxHeight, offX, offY;
+    double scale;
+    uint8_t alphaThreshold;
+};
+
+static void referencePixel(pngle_t *pngle, uint32_t x, uint32_t y, uint32_t,
+                           uint32_t, uint8_t rgba[4]) {
+    Reference *p = (Reference *)pngle_get_user_data(pngle);
+    if (x < p->offX || y < p->offY) return;
+    x -= p->offX;
+    y -= p->offY;
+
+    uint32_t w = 1, h = 1;
+    if (p->scale != 1.0) {
+        x = (uint32_t)ceil(x * p->scale);
+        y = (uint32_t)ceil(y * p->scale);
+        w = (uint32_t)ceil(w * p->scale);
+        h = (uint32_t)ceil(h * p->scale);
+    }
+
+    if (x >= p->maxWidth || y >= p->maxHeight) return;
+    if (x + w >= p->maxWidth) w = p->maxWidth - x;
+    if (y + h >= p->maxHeight) h = p->maxHeight - y;
+
+    if (rgba[3] >= p->alphaThreshold)
+        tft.fillRect(x + p->x, y + p->y, w, h,
+                     tft.color565(rgba[0], rgba[1], rgba[2]));
+}
+
+static void drawReference(const std::string &png, Reference params) {
+    if (!params.maxWidth) params.maxWidth = tft.width() - params.x;
+    if (!params.maxHeight) params.maxHeight = tft.height() - params.y;
+
+    pngle_t *pngle = pngle_new();
+    pngle_set_user_data(pngle, &params);
+    pngle_set_draw_callback(pngle, referencePixel);
+    tft.startWrite();
+    CHECK(pngle_feed(pngle, png.data(), png.size()) == (int)png.size());
+    tft.endWrite();
+    pngle_destroy(pngle);
+}
+
+/***************************************************************************************
+** Checks
+***************************************************************************************/
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static std::vector<uint8_t> randomImage(int w, int h, bool opaque) {
+    std::vector<uint8_t> rgba(w * h * 4);
+    for (uint8_t &c : rgba) c = random(256);
+    if (opaque)
+        for (size_t i = 3; i < rgba.size(); i += 4) rgba[i] = 255;
+    return rgba;
+}
+
+// An opaque image at scale 1 lands pixel for pixel, one window per row
+static void checkExactPixels(bool interlaced) {
+    const int w = 37, h = 23;
+    std::vector<uint8_t> rgba = randomImage(w, h, true);
+    writeFile("/exact.png", encodePng(rgba, w, h, false, interlaced));
+
+    tft.fillScreen(TFT_BLACK);
+    {
+        VirtualPanel::Call call("drawPngFile");
+        tft.drawPngFile(SPIFFS, "/exact.png", 50, 60);
+    }
+    CHECK(Panel.lastCall().windows == h);
+    CHECK(Panel.lastCall().pixelsWritten == w * h);
+    // pushImage() ends the transaction that png_flush() starts
+    CHECK(Panel.lastCall().transactions == h);
+
+    int wrong = 0;
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++) {
+            const uint8_t *c = &rgba[(y * w + x) * 4];
+            wrong += Panel.readPixel(50 + x, 60 + y) !=
+                     tft.color565(c[0], c[1], c[2]);
+        }
+    CHECK(wrong == 0);
+    CHECK(Panel.readPixel(49, 60) == TFT_BLACK);
+    CHECK(Panel.readPixel(50 + w, 60 + h - 1) == TFT_BLACK);
+    CHECK(Panel.readPixel(50, 60 + h) == TFT_BLACK);
+}
+
+static void checkAgainstReference(int cases) {
+    static const double scales[] = {0.25, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0};
+    uint64_t windows = 0, referenceWindows = 0;
+
+    for (int i = 0; i < cases; i++) {
+        int w = 1 + random(90), h = 1 + random(70);
+        bool interlaced = random(2), alpha = random(3), opaque = !random(3);
+        std::vector<uint8_t> rgba = randomImage(w, h, opaque);
+        std::string png           = encodePng(rgba, w, h, alpha, interlaced);
+        writeFile("/case.png", png);
+
+        Reference params;
+        params.x         = random(300);
+        params.y         = random(220);
+        params.maxWidth  = random(2) ? 0 : 1 + random(320 - params.x);
+        params.maxHeight = random(2) ? 0 : 1 + random(240 - params.y);
+        params.offX      = random(4) ? 0 : random(w + 2);
+        params.offY      = random(4) ? 0 : random(h + 2);
+        params.scale     = scales[random(7)];
+        params.alphaThreshold = random(3) ? random(256) : 0;
+
+        uint16_t background = random(0x10000);
+        tft.fillScreen(background);
+        {
+            VirtualPanel::Call call("reference");
+            drawReference(png, params);
+        }
+        referenceWindows += Panel.lastCall().windows;
+        std::vector<uint16_t> expected = panelMemory();
+
+        tft.fillScreen(background);
+        {
+            VirtualPanel::Call call("drawPngFile");
+            tft.drawPngFile(SPIFFS, "/case.png", params.x, params.y,
+                            params.maxWidth, params.maxHeight, params.offX,
+                            params.offY, params.scale, params.alphaThreshold);
+        }
+        windows += Panel.lastCall().windows;
+        CHECK(Panel.lastCall().transactions <= Panel.lastCall().windows);
+
+        if (panelMemory() != expected) {
+            CHECK(panelMemory() == expected);
+            fprintf(stderr,
+                    "  %dx%d interlaced %d alpha %d at %u,%u max %u,%u "
+                    "offset %u,%u scale %g threshold %u\n",
+                    w, h, interlaced, alpha, params.x, params.y,
+                    params.maxWidth, params.maxHeight, params.offX,
+                    params.offY, params.scale, params.alphaThreshold);
+        }
+    }
+
+    CHECK(windows < referenceWindows);
+    printf("%d images: %llu windows, %llu per pixel (%.1fx fewer)\n", cases,
+           (unsigned long long)windows, (unsigned long long)referenceWindows,
+           (double)referenceWindows / windows);
+}
+
+int main() {
+    char dir[] = "/tmp/pngXXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    root = dir;
+    setenv("HOST_FS_ROOT", dir, 1);
+
+    tft.begin();
+    tft.setRotation(1);
+
+    checkExactPixels(false);
+    checkExactPixels(true);
+    checkAgainstReference(400);
+
+    unlink((root + "/exact.png").c_str());
+    unlink((root + "/case.png").c_str());
+    rmdir(dir);
+    return checkResult();
+}
@@ -0,0 +1,281 @@
+// Host build: pushRotated() against the float version it replaced, which
+// rounded two expressions, called readPixel() and drawPixel() for every pixel
+// of the bounding box.
+//
+// Random sprites, pivots, angles, depths and destinations must give the same
+// pixels, except for rounding ties along the edges, and right angles must
+// match exactly. Indexed sprites take a palette index as the transparent
+// colour. Then a gauge dial and a compass needle turn through a full
+// circle both ways, on the panel, and the time and the bus cost of a frame
+// are reported.
+#include <M5Display.h>
+
+#include <math.h>
+
+#include <vector>
+
+#include "Bench.h"
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static unsigned seed = 9;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+/***************************************************************************************
+** Reference: the float version, per pixel
+***************************************************************************************/
+// Draws through the real type, because drawPixel() isn't virtual. For an
+// indexed source transp is compared with the palette index.
+template <typename T>
+static void referenceRotated(TFT_eSprite &src, T &dst, int16_t angle,
+                             int32_t transp, bool indexed = false) {
+    float radAngle = -angle * 0.0174532925;
+    float sinra    = sin(radAngle);
+    float cosra    = cos(radAngle);
+
+    int16_t min_x, min_y, max_x, max_y;
+    src.getRotatedBounds(sinra, cosra, src.width(), src.height(),
+                         src.getPivotX(), src.getPivotY(), &min_x, &min_y,
+                         &max_x, &max_y);
+    min_x += dst.getPivotX();
+    max_x += dst.getPivotX();
+    min_y += dst.getPivotY();
+    max_y += dst.getPivotY();
+
+    if (min_x > dst.width() || min_y > dst.height()) return;
+    if (max_x < 0 || max_y < 0) return;
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > dst.width()) max_x = dst.width();
+    if (max_y > dst.height()) max_y = dst.height();
+
+    for (int32_t x = min_x; x <= max_x; x++) {
+        int32_t xt        = x - dst.getPivotX();
+        float cxt         = cosra * xt + src.getPivotX();
+        float sxt         = sinra * xt + src.getPivotY();
+        bool column_drawn = false;
+        for (int32_t y = min_y; y <= max_y; y++) {
+            int32_t yt = y - dst.getPivotY();
+            int32_t xs = (int32_t)round(cxt - sinra * yt);
+            if (xs >= 0 && xs < src.width()) {
+                int32_t ys = (int32_t)round(sxt + cosra * yt);
+                if (ys >= 0 && ys < src.height()) {
+                    int32_t rp    = src.readPixel(xs, ys);
+                    int32_t value = indexed ? src.readPixelValue(xs, ys) : rp;
+                    if (value != transp) dst.drawPixel(x, y, rp);
+                    column_drawn = true;
+                }
+            } else if (column_drawn)
+                y = max_y;
+        }
+    }
+}
+
+static void referenceRotated(TFT_eSprite &src, int16_t angle, int32_t transp,
+                             bool indexed = false) {
+    tft.startWrite();
+    referenceRotated(src, tft, angle, transp, indexed);
+    tft.endWrite();
+}
+
+/***************************************************************************************
+** Checks
+***************************************************************************************/
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> spriteMemory(TFT_eSprite &sprite) {
+    std::vector<uint16_t> pixels;
+    for (int y = 0; y < sprite.height(); y++)
+        for (int x = 0; x < sprite.width(); x++)
+            pixels.push_back(sprite.readPixel(x, y));
+    return pixels;
+}
+
+static long countDifferences(const std::vector<uint16_t> &a,
+                             const std::vector<uint16_t> &b) {
+    long count = 0;
+    for (size_t i = 0; i < a.size(); i++) count += a[i] != b[i];
+    return count;
+}
+
+static void fillRandom(TFT_eSprite &sprite) {
+    for (int y = 0; y < sprite.height(); y++)
+        for (int x = 0; x < sprite.width(); x++)
+            sprite.drawPixel(x, y, random(4) ? random(0x10000) : TFT_GREEN);
+}
+
+static void checkAgainstReference(int cases) {
+    long pixels = 0, differences = 0;
+    for (int i = 0; i < cases; i++) {
+        int w = 1 + random(120), h = 1 + random(120);
+        TFT_eSprite src(&tft);
+        src.setColorDepth(random(3) ? 16 : 8);
+        src.createSprite(w, h);
+        fillRandom(src);
+        src.setPivot(random(w + 20) - 10, random(h + 20) - 10);
+        int16_t angle  = random(720) - 360;
+        int32_t transp = random(2) ? -1 : src.readPixel(0, 0);
+
+        if (random(2)) {
+            tft.setPivot(random(400) - 40, random(300) - 30);
+            uint16_t background = random(0x10000);
+            tft.fillScreen(background);
+            referenceRotated(src, angle, transp);
+            std::vector<uint16_t> expected = panelMemory();
+            tft.fillScreen(background);
+            src.pushRotated(angle, transp);
+            long d = countDifferences(expected, panelMemory());
+            CHECK(d <= 2 * (w + h));
+            differences += d;
+            pixels += expected.size();
+        } else {
+            int dw = 1 + random(200), dh = 1 + random(200);
+            uint8_t depth = random(3) ? 16 : 8;
+            TFT_eSprite expected(&tft), actual(&tft);
+            expected.setColorDepth(depth);
+            actual.setColorDepth(depth);
+            expected.createSprite(dw, dh);
+            actual.createSprite(dw, dh);
+            expected.setPivot(random(dw), random(dh));
+            actual.setPivot(expected.getPivotX(), expected.getPivotY());
+            bool swap = random(2);
+            expected.setSwapBytes(swap);
+            actual.setSwapBytes(swap);
+
+            referenceRotated(src, expected, angle, transp);
+            src.pushRotated(&actual, angle, transp);
+            CHECK(actual.getSwapBytes() == swap);
+            long d =
+                countDifferences(spriteMemory(expected), spriteMemory(actual));
+            CHECK(d <= 2 * (w + h));
+            differences += d;
+            pixels += dw * dh;
+        }
+    }
+    CHECK(differences * 10000 < pixels);
+    printf("%d random cases: %.4f%% of the pixels differ\n", cases,
+           100.0 * differences / pixels);
+
+    // Right angles have no ties
+    TFT_eSprite src(&tft);
+    src.createSprite(101, 57);
+    fillRandom(src);
+    tft.setPivot(160, 120);
+    for (int16_t angle = -360; angle <= 360; angle += 90) {
+        tft.fillScreen(TFT_BLACK);
+        referenceRotated(src, angle, -1);
+        std::vector<uint16_t> expected = panelMemory();
+        tft.fillScreen(TFT_BLACK);
+        src.pushRotated(angle, -1);
+        CHECK(panelMemory() == expected);
+    }
+}
+
+// A palette with a repeated colour: only the transparent index may be
+// skipped, not the other entry of the same colour
+static void checkIndexed(int cases) {
+    uint16_t colors[16];
+    for (int i = 0; i < 16; i++) colors[i] = random(0x10000);
+    colors[9] = colors[3];
+
+    for (int i = 0; i < cases; i++) {
+        int w = 1 + random(80), h = 1 + random(80);
+        TFT_eSprite src(&tft);
+        src.setColorDepth(random(2) ? 4 : 8);
+        src.createSprite(w, h);
+        src.createPalette(colors, 16);
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++) src.drawPixel(x, y, random(16));
+        src.setPivot(random(w), random(h));
+        int16_t angle = random(4) * 90 + (random(2) ? 0 : random(90));
+
+        tft.setPivot(random(320), random(240));
+        tft.fillScreen(TFT_BLACK);
+        referenceRotated(src, angle, 3, true);
+        std::vector<uint16_t> expected = panelMemory();
+        tft.fillScreen(TFT_BLACK);
+        src.pushRotated(angle, 3);
+        CHECK(countDifferences(expected, panelMemory()) <= 2 * (w + h));
+        if (angle % 90 == 0) CHECK(panelMemory() == expected);
+    }
+}
+
+/***************************************************************************************
+** Benchmark
+***************************************************************************************/
+static void benchmark(const char *name, TFT_eSprite &sprite, int turns) {
+    double seconds[2];
+    uint64_t bytes[2];
+    uint32_t transactions[2];
+    int frames = 0;
+
+    tft.setPivot(160, 120);
+    for (int pass = 0; pass < 2; pass++) {
+        tft.fillScreen(TFT_BLACK);
+        Panel.resetStats();
+        Stopwatch stopwatch;
+        frames = 0;
+        for (int turn = 0; turn < turns; turn++)
+            for (int16_t angle = 0; angle < 360; angle += 3, frames++) {
+                if (pass)
+                    sprite.pushRotated(angle, TFT_BLACK);
+                else
+                    referenceRotated(sprite, angle, TFT_BLACK);
+            }
+        seconds[pass]      = stopwatch.seconds();
+        bytes[pass]        = Panel.stats().bytes;
+        transactions[pass] = Panel.stats().transactions;
+    }
+
+    printf("%s\n", name);
+    for (int pass = 0; pass < 2; pass++)
+        printf("  %-12s %8.1f us %8llu bus bytes %6u transactions\n",
+               pass ? "pushRotated" : "per pixel", seconds[pass] * 1e6 / frames,
+               (unsigned long long)bytes[pass] / frames,
+               transactions[pass] / frames);
+    printf("  %.1fx the frames per second, %.1fx fewer bus bytes\n",
+           seconds[0] / seconds[1], (double)bytes[0] / bytes[1]);
+}
+
+int main(int argc, char *argv[]) {
+    int turns = benchIterations(argc, argv, 5);
+
+    tft.begin();
+    tft.setRotation(1);
+
+    checkAgainstReference(300);
+    checkIndexed(100);
+
+    // A dial with a black background, turning around its centre
+    TFT_eSprite gauge(&tft);
+    gauge.createSprite(200, 200);
+    gauge.fillSprite(TFT_BLACK);
+    for (int y = 0; y < 200; y++)
+        for (int x = 0; x < 200; x++)
+            if ((x - 100) * (x - 100) + (y - 100) * (y - 100) < 99 * 99)
+                gauge.drawPixel(x, y, 0xF800 + x);
+    benchmark("gauge, 200x200 dial", gauge, turns);
+
+    // A needle with a transparent background, turning around its base
+    TFT_eSprite needle(&tft);
+    needle.createSprite(12, 110);
+    needle.fillSprite(TFT_BLACK);
+    for (int y = 0; y < 110; y++)
+        for (int x = 0; x < 12; x++)
+            if (abs(x - 6) <= (110 - y) * 12 / 220)
+                needle.drawPixel(x, y, 0xF800 + x);
+    needle.setPivot(6, 100);
+    benchmark("compass needle, 12x110", needle, turns);
+
+    return checkResult();
+}
@@ -0,0 +1,120 @@
+// Host build: qrcode() against the renderer it replaced, which filled the
+// whole area white and called fillRect() for every dark module. Both draw
+// on the panel, and the panel memories must be identical, for codes inside
+// the screen and codes that reach past its edges.
+#include <M5Display.h>
+
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static unsigned seed = 5;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+// The previous qrcode(), with the offsets widened to 16 bits like now
+static void drawReference(const char *text, uint16_t x, uint16_t y,
+                          uint8_t width, uint8_t version) {
+    QRCode code;
+    std::vector<uint8_t> data(qrcode_getBufferSize(version));
+    qrcode_initText(&code, data.data(), version, 0, text);
+
+    uint8_t thickness   = width / code.size;
+    uint16_t lineLength = code.size * thickness;
+    uint16_t xOffset    = x + (width - lineLength) / 2;
+    uint16_t yOffset    = y + (width - lineLength) / 2;
+
+    tft.fillRect(x, y, width, width, TFT_WHITE);
+    for (uint8_t row = 0; row < code.size; row++)
+        for (uint8_t col = 0; col < code.size; col++)
+            if (qrcode_getModule(&code, col, row))
+                tft.fillRect(col * thickness + xOffset,
+                             row * thickness + yOffset, thickness, thickness,
+                             TFT_BLACK);
+}
+
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+// Draws both ways on the same background and compares. Reports the
+// transactions of each when asked.
+static bool matchesReference(const char *text, uint16_t x, uint16_t y,
+                             uint8_t width, uint8_t version,
+                             uint32_t *transactions          = nullptr,
+                             uint32_t *referenceTransactions = nullptr) {
+    uint16_t background = random(0x10000);
+    tft.fillScreen(background);
+    {
+        VirtualPanel::Call call("reference");
+        drawReference(text, x, y, width, version);
+    }
+    if (referenceTransactions)
+        *referenceTransactions = Panel.lastCall().transactions;
+    std::vector<uint16_t> expected = panelMemory();
+
+    tft.fillScreen(background);
+    {
+        VirtualPanel::Call call("qrcode");
+        tft.qrcode(text, x, y, width, version);
+    }
+    if (transactions) *transactions = Panel.lastCall().transactions;
+    return panelMemory() == expected;
+}
+
+int main() {
+    tft.begin();
+    tft.setRotation(1);
+
+    // The default code: the four sides of the quiet zone, then the modules
+    // in a single transaction
+    uint32_t transactions, referenceTransactions;
+    CHECK(matchesReference("https://example.com", 50, 10, 220, 6,
+                           &transactions, &referenceTransactions));
+    CHECK(transactions == 5);
+    printf("default code: %u transactions, %u with fillRect() per module\n",
+           transactions, referenceTransactions);
+
+    for (int i = 0; i < 300; i++) {
+        uint8_t version = 1 + random(8);
+        std::string text;
+        for (unsigned n = 1 + random(version * 8); n > 0; n--)
+            text += char('!' + random(90));
+        uint16_t x = random(320), y = random(240);
+        uint8_t width = random(256);
+
+        if (!matchesReference(text.c_str(), x, y, width, version)) {
+            CHECK(!"qrcode() differs from the reference");
+            fprintf(stderr, "  version %u at %u,%u width %u: %s\n", version,
+                    x, y, width, text.c_str());
+        }
+    }
+
+    // The kept code is made again when the text or the version changes
+    CHECK(matchesReference("https://example.com", 50, 10, 220, 6));
+    CHECK(matchesReference("https://example.com", 60, 0, 230, 6));
+    CHECK(matchesReference("https://example.org", 50, 10, 220, 6));
+    CHECK(matchesReference("https://example.org", 50, 10, 220, 7));
+
+    // A code made and kept by the caller
+    QRCode code;
+    std::vector<uint8_t> data(qrcode_getBufferSize(3));
+    qrcode_initText(&code, data.data(), 3, 0, "M5Stack");
+    tft.fillScreen(TFT_BLUE);
+    drawReference("M5Stack", 100, 50, 120, 3);
+    std::vector<uint16_t> expected = panelMemory();
+    tft.fillScreen(TFT_BLUE);
+    tft.qrcode(&code, 100, 50, 120);
+    CHECK(panelMemory() == expected);
+
+    return checkResult();
+}
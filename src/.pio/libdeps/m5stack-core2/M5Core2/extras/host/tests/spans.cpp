@@ -0,0 +1,250 @@
+// Host build: drawSpans() against the shape functions it batches.
+//
+// Random scenes of rectangles, outlines, filled circles and lines, in a few
+// colours so that shapes overlap and merge, some reaching past the edges, are
+// drawn one shape at a time with fillRect(), drawRect(), fillCircle() and
+// drawLine(), then as spans with a single drawSpans(). Both draw on the panel
+// and on sprites of each depth, and the memories must be identical. A
+// Battleship board must take a single transaction, with fewer windows.
+#include <M5Display.h>
+
+#include <vector>
+
+#include "Check.h"
+#include "VirtualPanel.h"
+
+M5Display tft;
+
+static unsigned seed = 3;
+
+static unsigned random(unsigned n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+/***************************************************************************************
+** Scenes
+***************************************************************************************/
+enum ShapeKind { FILL_RECT, DRAW_RECT, FILL_CIRCLE, DRAW_LINE };
+
+struct Shape {
+    ShapeKind kind;
+    int32_t x0, y0, x1, y1;  // Rectangles: x, y, w, h; circles: x, y, r
+    uint32_t color;
+};
+
+typedef std::vector<Shape> Scene;
+
+// Draws through the real type, like a sketch would
+template <typename T>
+static void drawReference(T &dst, const Scene &scene) {
+    for (const Shape &s : scene) switch (s.kind) {
+            case FILL_RECT:
+                dst.fillRect(s.x0, s.y0, s.x1, s.y1, s.color);
+                break;
+            case DRAW_RECT:
+                dst.drawRect(s.x0, s.y0, s.x1, s.y1, s.color);
+                break;
+            case FILL_CIRCLE:
+                dst.fillCircle(s.x0, s.y0, s.x1, s.color);
+                break;
+            case DRAW_LINE:
+                dst.drawLine(s.x0, s.y0, s.x1, s.y1, s.color);
+                break;
+        }
+}
+
+template <typename T>
+static uint32_t drawBatched(T &dst, const Scene &scene) {
+    std::vector<tftSpan> spans;
+    for (const Shape &s : scene) {
+        size_t n = spans.size();
+        switch (s.kind) {
+            case FILL_RECT:
+                spans.push_back({s.x0, s.y0, s.x1, s.y1, s.color});
+                break;
+            case DRAW_RECT:
+                spans.resize(n + 4);
+                spans.resize(n + TFT_eSPI::rectSpans(&spans[n], s.x0, s.y0,
+                                                     s.x1, s.y1, s.color));
+                break;
+            case FILL_CIRCLE:
+                spans.resize(n + 2 * s.x1 + 1);
+                spans.resize(n + TFT_eSPI::circleSpans(&spans[n], s.x0, s.y0,
+                                                       s.x1, s.color));
+                break;
+            case DRAW_LINE:
+                spans.resize(n + std::max(abs(s.x1 - s.x0), abs(s.y1 - s.y0)) +
+                             1);
+                spans.resize(n + TFT_eSPI::lineSpans(&spans[n], s.x0, s.y0,
+                                                     s.x1, s.y1, s.color));
+                break;
+        }
+    }
+    return dst.drawSpans(spans.data(), spans.size());
+}
+
+static Scene randomScene(int w, int h) {
+    static const uint32_t colors[] = {TFT_RED, TFT_WHITE, TFT_NAVY,
+                                      TFT_YELLOW};
+    Scene scene;
+    for (int n = random(60); n > 0; n--) {
+        Shape s;
+        s.kind  = (ShapeKind)random(4);
+        s.x0    = (int)random(w + 40) - 20;
+        s.y0    = (int)random(h + 40) - 20;
+        s.color = colors[random(4)];
+        if (s.kind == FILL_CIRCLE) {
+            s.x1 = random(40);
+        } else if (s.kind == DRAW_LINE) {
+            s.x1 = (int)random(w + 40) - 20;
+            s.y1 = (int)random(h + 40) - 20;
+        } else {
+            // Snapped to a grid, like cells, with a few degenerate sizes
+            if (random(2)) {
+                s.x0 -= s.x0 % 8;
+                s.y0 -= s.y0 % 8;
+            }
+            s.x1 = (int)random(50) - 2;
+            s.y1 = (int)random(50) - 2;
+            if (random(2)) s.x1 = s.y1 = 8 * (1 + random(4));
+        }
+        scene.push_back(s);
+    }
+    return scene;
+}
+
+// The 8x8 board of the Battleship sketch: the cells, a few hits and misses,
+// and the cursor
+static Scene battleshipBoard() {
+    Scene scene;
+    const int cell = 26, x = 56, y = 16;
+    for (int row = 0; row < 8; row++)
+        for (int col = 0; col < 8; col++) {
+            int cx = x + col * cell, cy = y + row * cell;
+            scene.push_back({FILL_RECT, cx, cy, cell, cell, TFT_NAVY});
+            scene.push_back({DRAW_RECT, cx, cy, cell, cell, TFT_WHITE});
+            if ((row * 5 + col * 3) % 7 == 0)
+                scene.push_back({FILL_CIRCLE, cx + cell / 2, cy + cell / 2,
+                                 cell / 3, 0, TFT_RED});
+            else if ((row + col * 2) % 9 == 0)
+                scene.push_back({FILL_CIRCLE, cx + cell / 2, cy + cell / 2,
+                                 cell / 6, 0, TFT_WHITE});
+        }
+    scene.push_back({DRAW_RECT, x + 3 * cell, y + 5 * cell, cell, cell,
+                     TFT_YELLOW});
+    return scene;
+}
+
+/***************************************************************************************
+** Checks
+***************************************************************************************/
+static std::vector<uint16_t> panelMemory() {
+    const uint16_t *memory = Panel.frameBuffer();
+    return std::vector<uint16_t>(
+        memory, memory + VirtualPanel::WIDTH * VirtualPanel::HEIGHT);
+}
+
+static std::vector<uint16_t> spriteMemory(TFT_eSprite &sprite) {
+    std::vector<uint16_t> pixels;
+    for (int y = 0; y < sprite.height(); y++)
+        for (int x = 0; x < sprite.width(); x++)
+            pixels.push_back(sprite.readPixel(x, y));
+    return pixels;
+}
+
+static bool matchesOnPanel(const Scene &scene) {
+    uint16_t background = random(0x10000);
+    tft.fillScreen(background);
+    drawReference(tft, scene);
+    std::vector<uint16_t> expected = panelMemory();
+
+    tft.fillScreen(background);
+    uint32_t windows;
+    {
+        VirtualPanel::Call call("drawSpans");
+        windows = drawBatched(tft, scene);
+    }
+    CHECK(Panel.lastCall().windows == windows);
+    CHECK(Panel.lastCall().transactions <= 1);
+    return panelMemory() == expected;
+}
+
+static bool matchesOnSprite(const Scene &scene, uint8_t depth, int w, int h) {
+    TFT_eSprite expected(&tft), actual(&tft);
+    expected.setColorDepth(depth);
+    actual.setColorDepth(depth);
+    expected.createSprite(w, h);
+    actual.createSprite(w, h);
+    uint16_t background = random(0x10000);
+    expected.fillSprite(background);
+    actual.fillSprite(background);
+
+    drawReference(expected, scene);
+    drawBatched(actual, scene);
+    return spriteMemory(actual) == spriteMemory(expected);
+}
+
+static void checkAgainstReference(int cases) {
+    static const uint8_t depths[] = {1, 8, 16};
+    for (int i = 0; i < cases; i++) {
+        if (random(2)) {
+            Scene scene = randomScene(tft.width(), tft.height());
+            if (!matchesOnPanel(scene)) {
+                CHECK(!"drawSpans() differs from the reference on the panel");
+                fprintf(stderr, "  case %d, %u shapes\n", i,
+                        (unsigned)scene.size());
+            }
+        } else {
+            int w = 1 + random(160), h = 1 + random(120);
+            uint8_t depth = depths[random(3)];
+            Scene scene   = randomScene(w, h);
+            if (!matchesOnSprite(scene, depth, w, h)) {
+                CHECK(!"drawSpans() differs from the reference on a sprite");
+                fprintf(stderr, "  case %d, %u shapes, %dx%d at %u bpp\n", i,
+                        (unsigned)scene.size(), w, h, depth);
+            }
+        }
+    }
+}
+
+static void checkBoard() {
+    Scene board = battleshipBoard();
+
+    tft.fillScreen(TFT_BLACK);
+    {
+        VirtualPanel::Call call("reference");
+        drawReference(tft, board);
+    }
+    VirtualPanel::Stats reference  = Panel.lastCall();
+    std::vector<uint16_t> expected = panelMemory();
+
+    tft.fillScreen(TFT_BLACK);
+    uint32_t windows;
+    {
+        VirtualPanel::Call call("drawSpans");
+        windows = drawBatched(tft, board);
+    }
+    VirtualPanel::Stats batched = Panel.lastCall();
+
+    CHECK(panelMemory() == expected);
+    CHECK(batched.transactions == 1);
+    CHECK(batched.windows == windows);
+    CHECK(batched.windows < reference.windows);
+    printf("board: %u transactions and %u windows, %u and %u one by one\n",
+           batched.transactions, batched.windows, reference.transactions,
+           reference.windows);
+}
+
+int main() {
+    tft.begin();
+    tft.setRotation(1);
+
+    checkAgainstReference(800);
+    checkBoard();
+
+    // Nothing to draw
+    CHECK(tft.drawSpans(nullptr, 0) == 0);
+
+    return checkResult();
+}
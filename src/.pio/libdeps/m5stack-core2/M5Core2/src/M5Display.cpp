@@ -88,29 +88,64 @@ void M5Display::progressBar(int x, int y, int w, int h, uint8_t val) {
     fillRect(x + 1, y + 1, w * (((float)val) / 100.0), h - 1, 0x09F1);
 }
 
-#include "utility/qrcode.h"
 void M5Display::qrcode(const char *string, uint16_t x, uint16_t y,
                        uint8_t width, uint8_t version) {
-    // Create the QR code
-    QRCode qrcode;
-    uint8_t qrcodeData[qrcode_getBufferSize(version)];
-    qrcode_initText(&qrcode, qrcodeData, version, 0, string);
-
-    // Top quiet zone
-    uint8_t thickness   = width / qrcode.size;
-    uint16_t lineLength = qrcode.size * thickness;
-    uint8_t xOffset     = x + (width - lineLength) / 2;
-    uint8_t yOffset     = y + (width - lineLength) / 2;
-    fillRect(x, y, width, width, TFT_WHITE);
-
-    for (uint8_t y = 0; y < qrcode.size; y++) {
-        for (uint8_t x = 0; x < qrcode.size; x++) {
-            uint8_t q = qrcode_getModule(&qrcode, x, y);
-            if (q)
-                fillRect(x * thickness + xOffset, y * thickness + yOffset,
-                         thickness, thickness, TFT_BLACK);
+    // Create the QR code, unless it's the one drawn last time
+    if (_qrcodeData.empty() || _qrcode.version != version ||
+        _qrcodeText != string) {
+        _qrcodeData.resize(qrcode_getBufferSize(version));
+        qrcode_initText(&_qrcode, _qrcodeData.data(), version, 0, string);
+        _qrcodeText = string;
+    }
+    qrcode(&_qrcode, x, y, width);
+}
+
+void M5Display::qrcode(QRCode *qrcode, uint16_t x, uint16_t y,
+                       uint8_t width) {
+    uint8_t thickness   = width / qrcode->size;
+    uint16_t lineLength = qrcode->size * thickness;
+    uint16_t xOffset    = x + (width - lineLength) / 2;
+    uint16_t yOffset    = y + (width - lineLength) / 2;
+
+    // Quiet zone around the code
+    uint16_t before = xOffset - x;
+    uint16_t after  = width - lineLength - before;
+    fillRect(x, y, width, before, TFT_WHITE);
+    fillRect(x, yOffset + lineLength, width, after, TFT_WHITE);
+    fillRect(x, yOffset, before, lineLength, TFT_WHITE);
+    fillRect(xOffset + lineLength, yOffset, after, lineLength, TFT_WHITE);
+    if (!thickness) return;
+
+    // Each row of modules becomes a line of pixels, sent thickness times
+    bool visible =
+        xOffset + lineLength <= _width && yOffset + lineLength <= _height;
+    bool swap    = getSwapBytes();
+    uint16_t line[lineLength];
+
+    setSwapBytes(true);
+    startWrite();
+    for (uint8_t row = 0; row < qrcode->size; row++) {
+        uint16_t *pixel = line;
+        for (uint8_t col = 0; col < qrcode->size; col++) {
+            uint16_t color =
+                qrcode_getModule(qrcode, col, row) ? TFT_BLACK : TFT_WHITE;
+            for (uint8_t i = 0; i < thickness; i++) *pixel++ = color;
+        }
+
+        uint16_t top = yOffset + row * thickness;
+        if (visible) {
+            setWindow(xOffset, top, xOffset + lineLength - 1,
+                      top + thickness - 1);
+            for (uint8_t i = 0; i < thickness; i++)
+                writePixels(line, lineLength);
+        } else {
+            // pushImage() clips what's off the screen
+            for (uint8_t i = 0; i < thickness; i++)
+                pushImage(xOffset, top + i, lineLength, 1, line);
         }
     }
+    endWrite();
+    setSwapBytes(swap);
 }
 
 void M5Display::qrcode(const String &string, uint16_t x, uint16_t y,
@@ -274,43 +309,58 @@ static uint32_t jpgRead(JDEC *decoder, uint8_t *buf, uint32_t len) {
     return len;
 }
 
-static uint32_t jpgWrite(JDEC *decoder, void *bitmap, JRECT *rect) {
-    jpg_file_decoder_t *jpeg = (jpg_file_decoder_t *)decoder->device;
-    uint16_t x               = rect->left;
-    uint16_t y               = rect->top;
-    uint16_t w               = rect->right + 1 - x;
-    uint16_t h               = rect->bottom + 1 - y;
-    uint16_t oL = 0, oR = 0;
-    uint8_t *data = (uint8_t *)bitmap;
+// Clips a decoded block to the part of the image to draw. Returns false if
+// nothing is left; otherwise data points to the first visible row, and x, y,
+// w and h are the visible rows of the block, oL and oR the columns to skip.
+static bool jpgClip(jpg_file_decoder_t *jpeg, JRECT *rect, uint8_t **data,
+                    uint16_t *x, uint16_t *y, uint16_t *w, uint16_t *h,
+                    uint16_t *oL, uint16_t *oR) {
+    *x  = rect->left;
+    *y  = rect->top;
+    *w  = rect->right + 1 - *x;
+    *h  = rect->bottom + 1 - *y;
+    *oL = 0;
+    *oR = 0;
 
     if (rect->right < jpeg->offX) {
-        return 1;
+        return false;
     }
     if (rect->left >= (jpeg->offX + jpeg->outWidth)) {
-        return 1;
+        return false;
     }
     if (rect->bottom < jpeg->offY) {
-        return 1;
+        return false;
     }
     if (rect->top >= (jpeg->offY + jpeg->outHeight)) {
-        return 1;
+        return false;
     }
     if (rect->top < jpeg->offY) {
         uint16_t linesToSkip = jpeg->offY - rect->top;
-        data += linesToSkip * w * 3;
-        h -= linesToSkip;
-        y += linesToSkip;
+        *data += linesToSkip * *w * 3;
+        *h -= linesToSkip;
+        *y += linesToSkip;
     }
     if (rect->bottom >= (jpeg->offY + jpeg->outHeight)) {
         uint16_t linesToSkip =
             (rect->bottom + 1) - (jpeg->offY + jpeg->outHeight);
-        h -= linesToSkip;
+        *h -= linesToSkip;
     }
     if (rect->left < jpeg->offX) {
-        oL = jpeg->offX - rect->left;
+        *oL = jpeg->offX - rect->left;
     }
     if (rect->right >= (jpeg->offX + jpeg->outWidth)) {
-        oR = (rect->right + 1) - (jpeg->offX + jpeg->outWidth);
+        *oR = (rect->right + 1) - (jpeg->offX + jpeg->outWidth);
+    }
+    return true;
+}
+
+static uint32_t jpgWrite(JDEC *decoder, void *bitmap, JRECT *rect) {
+    jpg_file_decoder_t *jpeg = (jpg_file_decoder_t *)decoder->device;
+    uint16_t x, y, w, h, oL, oR;
+    uint8_t *data = (uint8_t *)bitmap;
+
+    if (!jpgClip(jpeg, rect, &data, &x, &y, &w, &h, &oL, &oR)) {
+        return 1;
     }
 
     uint16_t pixBuf[32];
@@ -348,7 +398,8 @@ static uint32_t jpgWrite(JDEC *decoder, void *bitmap, JRECT *rect) {
 }
 
 static bool jpgDecode(jpg_file_decoder_t *jpeg,
-                      uint32_t (*reader)(JDEC *, uint8_t *, uint32_t)) {
+                      uint32_t (*reader)(JDEC *, uint8_t *, uint32_t),
+                      uint32_t (*writer)(JDEC *, void *, JRECT *)) {
     static uint8_t work[3100];
     JDEC decoder;
 
@@ -374,7 +425,7 @@ static bool jpgDecode(jpg_file_decoder_t *jpeg,
     jpeg->outHeight =
         (jpgMaxHeight > jpeg->maxHeight) ? jpeg->maxHeight : jpgMaxHeight;
 
-    jres = jd_decomp(&decoder, jpgWrite, (uint8_t)jpeg->scale);
+    jres = jd_decomp(&decoder, writer, (uint8_t)jpeg->scale);
     if (jres != JDR_OK) {
         log_e("jd_decomp failed! %s", jd_errors[jres]);
         return false;
@@ -412,7 +463,7 @@ void M5Display::drawJpg(const uint8_t *jpg_data, size_t jpg_len, uint16_t x,
     jpeg.scale     = scale;
     jpeg.tft       = this;
 
-    jpgDecode(&jpeg, jpgRead);
+    jpgDecode(&jpeg, jpgRead, jpgWrite);
 }
 
 void M5Display::drawJpgFile(fs::FS &fs, const char *path, uint16_t x,
@@ -450,11 +501,275 @@ void M5Display::drawJpgFile(fs::FS &fs, const char *path, uint16_t x,
     jpeg.scale     = scale;
     jpeg.tft       = this;
 
-    jpgDecode(&jpeg, jpgReadFile);
+    jpgDecode(&jpeg, jpgReadFile, jpgWrite);
 
     file.close();
 }
 
+/*
+ * Pipelined JPEG
+ */
+
+// Rows of blocks are collected in strips. While a task on the other core sends
+// one strip out, the decoder fills the next one.
+#define JPG_PIPE_STRIPS     2
+#define JPG_PIPE_MCU_HEIGHT 16    // the tallest block tjpgd produces
+#define JPG_PIPE_DONE       0xFF  // tells the sending task to stop
+
+typedef struct {
+    uint16_t *pixels;  // native RGB565, outWidth pixels per row
+    int32_t top;       // image row of the first line, -1 when empty
+    uint16_t h;
+} jpg_strip_t;
+
+typedef struct {
+    jpg_file_decoder_t jpeg;  // first, so that the readers work unchanged
+    TFT_eSprite *sprite;      // the target, or NULL for the screen
+    jpg_strip_t strips[JPG_PIPE_STRIPS];
+    uint8_t current;         // index of the strip being filled
+    QueueHandle_t todo;      // strips to send, NULL without the task
+    QueueHandle_t done;      // strips free again
+    uint32_t flushTime;      // decoder time spent handing strips over
+    uint32_t transferTime;   // updated by the sending task only
+} jpg_pipeline_t;
+
+static void jpgSendStrip(jpg_pipeline_t *pipe, jpg_strip_t *strip) {
+    jpg_file_decoder_t *jpeg = &pipe->jpeg;
+    int32_t x                = jpeg->x;
+    int32_t y                = strip->top - jpeg->offY + jpeg->y;
+    uint32_t start           = micros();
+
+    if (pipe->sprite) {
+        // A sprite swaps the bytes of native colours unless told otherwise
+        bool swap = pipe->sprite->getSwapBytes();
+        pipe->sprite->setSwapBytes(false);
+        pipe->sprite->pushImage(x, y, jpeg->outWidth, strip->h, strip->pixels);
+        pipe->sprite->setSwapBytes(swap);
+    } else {
+        jpeg->tft->startWrite();
+        jpeg->tft->setWindow(x, y, x + jpeg->outWidth - 1, y + strip->h - 1);
+        jpeg->tft->writePixels(strip->pixels,
+                               (uint32_t)jpeg->outWidth * strip->h);
+        jpeg->tft->endWrite();
+    }
+
+    pipe->transferTime += micros() - start;
+    strip->top = -1;
+}
+
+// An SD card shares the bus with the screen. SPI transactions keep them apart,
+// so reading a file overlaps with decoding, but not with sending.
+static void jpgSendTask(void *arg) {
+    jpg_pipeline_t *pipe = (jpg_pipeline_t *)arg;
+    uint8_t index;
+
+    while (xQueueReceive(pipe->todo, &index, portMAX_DELAY) == pdTRUE &&
+           index != JPG_PIPE_DONE) {
+        jpgSendStrip(pipe, &pipe->strips[index]);
+        xQueueSend(pipe->done, &index, portMAX_DELAY);
+    }
+    xQueueSend(pipe->done, &index, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+// Hands the current strip over, and takes a free one
+static void jpgFlushStrip(jpg_pipeline_t *pipe) {
+    if (pipe->strips[pipe->current].top < 0) return;
+
+    uint32_t start = micros();
+    if (pipe->todo) {
+        xQueueSend(pipe->todo, &pipe->current, portMAX_DELAY);
+        xQueueReceive(pipe->done, &pipe->current, portMAX_DELAY);
+    } else {
+        jpgSendStrip(pipe, &pipe->strips[pipe->current]);
+    }
+    pipe->flushTime += micros() - start;
+}
+
+static uint32_t jpgPipeWrite(JDEC *decoder, void *bitmap, JRECT *rect) {
+    jpg_pipeline_t *pipe     = (jpg_pipeline_t *)decoder->device;
+    jpg_file_decoder_t *jpeg = &pipe->jpeg;
+    uint16_t x, y, w, h, oL, oR;
+    uint8_t *data = (uint8_t *)bitmap;
+
+    if (!jpgClip(jpeg, rect, &data, &x, &y, &w, &h, &oL, &oR)) {
+        return 1;
+    }
+
+    // Blocks come left to right, then top to bottom, so a block starting
+    // another row means that the strip is complete
+    if (pipe->strips[pipe->current].top != y) {
+        jpgFlushStrip(pipe);
+    }
+
+    jpg_strip_t *strip = &pipe->strips[pipe->current];
+    strip->top         = y;
+    strip->h           = h;
+
+    uint16_t *row = strip->pixels + (x + oL - jpeg->offX);
+    while (h--) {
+        uint16_t *pixel = row;
+        data += 3 * oL;
+        for (uint16_t line = w - (oL + oR); line; line--) {
+            *pixel++ = jpgColor(data);
+            data += 3;
+        }
+        data += 3 * oR;
+        row += jpeg->outWidth;
+    }
+    return 1;
+}
+
+static bool jpgInitPipeline(jpg_pipeline_t *pipe, M5Display *tft,
+                            TFT_eSprite *sprite, uint16_t x, uint16_t y,
+                            uint16_t maxWidth, uint16_t maxHeight,
+                            uint16_t offX, uint16_t offY, jpeg_div_t scale) {
+    int16_t targetWidth  = sprite ? sprite->width() : tft->width();
+    int16_t targetHeight = sprite ? sprite->height() : tft->height();
+
+    if ((x + maxWidth) > targetWidth || (y + maxHeight) > targetHeight) {
+        log_e("Bad dimensions given");
+        return false;
+    }
+
+    if (!maxWidth) {
+        maxWidth = targetWidth - x;
+    }
+    if (!maxHeight) {
+        maxHeight = targetHeight - y;
+    }
+
+    pipe->jpeg.index     = 0;
+    pipe->jpeg.x         = x;
+    pipe->jpeg.y         = y;
+    pipe->jpeg.maxWidth  = maxWidth;
+    pipe->jpeg.maxHeight = maxHeight;
+    pipe->jpeg.offX      = offX;
+    pipe->jpeg.offY      = offY;
+    pipe->jpeg.scale     = scale;
+    pipe->jpeg.tft       = tft;
+    pipe->sprite         = sprite;
+    return true;
+}
+
+static bool jpgDecodePipelined(jpg_pipeline_t *pipe,
+                               uint32_t (*reader)(JDEC *, uint8_t *, uint32_t),
+                               jpeg_timing_t *timing) {
+    uint32_t start = micros();
+
+    size_t stripSize =
+        (size_t)pipe->jpeg.maxWidth * JPG_PIPE_MCU_HEIGHT * sizeof(uint16_t);
+    uint8_t strips = 0;
+    while (strips < JPG_PIPE_STRIPS) {
+        pipe->strips[strips].pixels = (uint16_t *)malloc(stripSize);
+        if (!pipe->strips[strips].pixels) break;
+        pipe->strips[strips].top = -1;
+        strips++;
+    }
+    if (!strips) {
+        log_e("Not enough memory for a row of JPEG blocks");
+        return false;
+    }
+
+    pipe->current      = 0;
+    pipe->todo         = NULL;
+    pipe->done         = NULL;
+    pipe->flushTime    = 0;
+    pipe->transferTime = 0;
+
+    // Without the second strip or the task, each row of blocks is sent
+    // before the next one is decoded
+    TaskHandle_t task = NULL;
+    if (strips == JPG_PIPE_STRIPS) {
+        pipe->todo = xQueueCreate(JPG_PIPE_STRIPS, sizeof(uint8_t));
+        pipe->done = xQueueCreate(JPG_PIPE_STRIPS, sizeof(uint8_t));
+        if (pipe->todo && pipe->done) {
+            uint8_t next = 1;
+            xQueueSend(pipe->done, &next, 0);
+            xTaskCreatePinnedToCore(jpgSendTask, "jpgSend", 3072, pipe,
+                                    uxTaskPriorityGet(NULL), &task,
+                                    xPortGetCoreID() ? 0 : 1);
+        }
+        if (!task) {
+            if (pipe->todo) vQueueDelete(pipe->todo);
+            if (pipe->done) vQueueDelete(pipe->done);
+            pipe->todo = NULL;
+            pipe->done = NULL;
+        }
+    }
+
+    uint32_t decodeStart = micros();
+    bool ok = jpgDecode(&pipe->jpeg, reader, jpgPipeWrite);
+    uint32_t decodeTime = micros() - decodeStart - pipe->flushTime;
+
+    jpgFlushStrip(pipe);
+    if (task) {
+        uint8_t index = JPG_PIPE_DONE;
+        xQueueSend(pipe->todo, &index, portMAX_DELAY);
+        do {
+            xQueueReceive(pipe->done, &index, portMAX_DELAY);
+        } while (index != JPG_PIPE_DONE);
+        vQueueDelete(pipe->todo);
+        vQueueDelete(pipe->done);
+    }
+
+    for (uint8_t i = 0; i < strips; i++) {
+        free(pipe->strips[i].pixels);
+    }
+
+    if (timing) {
+        timing->decode   = decodeTime;
+        timing->transfer = pipe->transferTime;
+        timing->total    = micros() - start;
+    }
+    return ok;
+}
+
+bool M5Display::drawJpgPipelined(const uint8_t *jpg_data, size_t jpg_len,
+                                 uint16_t x, uint16_t y, uint16_t maxWidth,
+                                 uint16_t maxHeight, uint16_t offX,
+                                 uint16_t offY, jpeg_div_t scale,
+                                 TFT_eSprite *sprite, jpeg_timing_t *timing) {
+    jpg_pipeline_t pipe;
+
+    if (!jpgInitPipeline(&pipe, this, sprite, x, y, maxWidth, maxHeight, offX,
+                         offY, scale)) {
+        return false;
+    }
+
+    pipe.jpeg.src = jpg_data;
+    pipe.jpeg.len = jpg_len;
+
+    return jpgDecodePipelined(&pipe, jpgRead, timing);
+}
+
+bool M5Display::drawJpgPipelined(fs::FS &fs, const char *path, uint16_t x,
+                                 uint16_t y, uint16_t maxWidth,
+                                 uint16_t maxHeight, uint16_t offX,
+                                 uint16_t offY, jpeg_div_t scale,
+                                 TFT_eSprite *sprite, jpeg_timing_t *timing) {
+    jpg_pipeline_t pipe;
+
+    if (!jpgInitPipeline(&pipe, this, sprite, x, y, maxWidth, maxHeight, offX,
+                         offY, scale)) {
+        return false;
+    }
+
+    File file = fs.open(path);
+    if (!file) {
+        log_e("Failed to open file for reading");
+        return false;
+    }
+
+    pipe.jpeg.src = &file;
+    pipe.jpeg.len = file.size();
+
+    bool ok = jpgDecodePipelined(&pipe, jpgReadFile, timing);
+
+    file.close();
+    return ok;
+}
+
 /*
  * PNG
  */
@@ -473,8 +788,89 @@ typedef struct _png_draw_params {
     uint8_t alphaThreshold;
 
     M5Display *tft;
+
+    // Decoded pixels wait here and go out one run of opaque pixels at a time.
+    // Rows arrive in order, so one row is enough, pushed bufH times if the
+    // image is scaled up. An interlaced image fills its rows in 7 passes, so
+    // the whole destination area is kept until the end instead.
+    uint16_t *buf;     // native RGB565, bufW pixels per row
+    uint8_t *bufMask;  // 1 bit per pixel of buf: drawn and opaque
+    uint16_t bufW;
+    uint16_t bufRows;  // rows in buf: 1, or the destination height
+    int32_t bufY;      // destination row of buf, -1 when empty
+    uint16_t bufH;     // destination rows covered by a single-row buf
 } png_file_decoder_t;
 
+// Destination size of n source pixels, as placed by pngle_draw_callback()
+static uint32_t png_scaled_extent(uint32_t n, double scale) {
+    if (n == 0 || scale == 1.0) return n;
+    return (uint32_t)ceil((n - 1) * scale) + (uint32_t)ceil(scale);
+}
+
+static void png_flush(png_file_decoder_t *p) {
+    if (p->bufY < 0) return;
+
+    bool swap = p->tft->getSwapBytes();
+    p->tft->setSwapBytes(true);
+    p->tft->startWrite();
+    for (uint16_t row = 0; row < p->bufRows; row++) {
+        uint16_t *pixels = p->buf + (uint32_t)row * p->bufW;
+        uint8_t *mask    = p->bufMask + (uint32_t)row * ((p->bufW + 7) / 8);
+        uint16_t copies  = p->bufRows == 1 ? p->bufH : 1;
+        int32_t y        = p->y + p->bufY + row;
+
+        uint16_t i = 0;
+        while (i < p->bufW) {
+            if (!(mask[i >> 3] & (0x80 >> (i & 7)))) {
+                i++;
+                continue;
+            }
+            uint16_t start = i;
+            while (i < p->bufW && (mask[i >> 3] & (0x80 >> (i & 7)))) i++;
+            for (uint16_t c = 0; c < copies; c++)
+                p->tft->pushImage(p->x + start, y + c, i - start, 1,
+                                  pixels + start);
+        }
+        memset(mask, 0, (p->bufW + 7) / 8);
+    }
+    p->tft->endWrite();
+    p->tft->setSwapBytes(swap);
+
+    p->bufY = -1;
+}
+
+static void pngle_init_callback(pngle_t *pngle, uint32_t w, uint32_t h) {
+    png_file_decoder_t *p = (png_file_decoder_t *)pngle_get_user_data(pngle);
+
+    uint32_t bufW =
+        w > p->offX ? png_scaled_extent(w - p->offX, p->scale) : 0;
+    uint32_t destH =
+        h > p->offY ? png_scaled_extent(h - p->offY, p->scale) : 0;
+    if (bufW > p->maxWidth) bufW = p->maxWidth;
+    if (destH > p->maxHeight) destH = p->maxHeight;
+    if (!bufW || !destH) return;
+
+    p->bufW    = bufW;
+    p->bufRows = pngle_get_ihdr(pngle)->interlace ? destH : 1;
+
+    // Without the memory, pngle_draw_callback() draws each pixel by itself
+    size_t pixels = (size_t)p->bufW * p->bufRows;
+    size_t mask   = (size_t)(p->bufW + 7) / 8 * p->bufRows;
+    if (p->bufRows > 1 && psramFound()) {
+        p->buf     = (uint16_t *)ps_malloc(pixels * sizeof(uint16_t));
+        p->bufMask = (uint8_t *)ps_calloc(mask, 1);
+    } else {
+        p->buf     = (uint16_t *)malloc(pixels * sizeof(uint16_t));
+        p->bufMask = (uint8_t *)calloc(mask, 1);
+    }
+    if (!p->buf || !p->bufMask) {
+        free(p->buf);
+        free(p->bufMask);
+        p->buf     = NULL;
+        p->bufMask = NULL;
+    }
+}
+
 static void pngle_draw_callback(pngle_t *pngle, uint32_t x, uint32_t y,
                                 uint32_t w, uint32_t h, uint8_t rgba[4]) {
     png_file_decoder_t *p = (png_file_decoder_t *)pngle_get_user_data(pngle);
@@ -500,12 +896,44 @@ static void pngle_draw_callback(pngle_t *pngle, uint32_t x, uint32_t y,
     if (x + w >= p->maxWidth) w = p->maxWidth - x;
     if (y + h >= p->maxHeight) h = p->maxHeight - y;
 
-    x += p->x;
-    y += p->y;
+    if (rgba[3] < p->alphaThreshold) return;
+
+    if (!p->buf) {
+        p->tft->fillRect(x + p->x, y + p->y, w, h, color);
+        return;
+    }
 
-    if (rgba[3] >= p->alphaThreshold) {
-        p->tft->fillRect(x, y, w, h, color);
+    uint32_t row = 0;
+    if (p->bufRows == 1) {
+        if ((int32_t)y != p->bufY) {
+            png_flush(p);
+            p->bufY = y;
+            p->bufH = h;
+        }
+    } else {
+        p->bufY = 0;
+        row     = y;
     }
+
+    // Later pixels cover earlier ones, as if each was drawn right away
+    if (x + w > p->bufW) w = p->bufW - x;
+    uint16_t stride = (p->bufW + 7) / 8;
+    for (uint32_t r = row; r < row + h && r < p->bufRows; r++) {
+        for (uint32_t i = x; i < x + w; i++) {
+            p->buf[r * p->bufW + i] = color;
+            p->bufMask[r * stride + (i >> 3)] |= 0x80 >> (i & 7);
+        }
+        if (p->bufRows == 1) break;  // the other rows are copies
+    }
+}
+
+// Draws what is still buffered and releases the buffers
+static void png_finish(png_file_decoder_t *p) {
+    if (p->buf) png_flush(p);
+    free(p->buf);
+    free(p->bufMask);
+    p->buf     = NULL;
+    p->bufMask = NULL;
 }
 
 void M5Display::drawPngFile(fs::FS &fs, const char *path, uint16_t x,
@@ -538,8 +966,12 @@ void M5Display::drawPngFile(fs::FS &fs, const char *path, uint16_t x,
     png.scale          = scale;
     png.alphaThreshold = alphaThreshold;
     png.tft            = this;
+    png.buf            = NULL;
+    png.bufMask        = NULL;
+    png.bufY           = -1;
 
     pngle_set_user_data(pngle, &png);
+    pngle_set_init_callback(pngle, pngle_init_callback);
     pngle_set_draw_callback(pngle, pngle_draw_callback);
 
     // Feed data to pngle
@@ -557,6 +989,7 @@ void M5Display::drawPngFile(fs::FS &fs, const char *path, uint16_t x,
         if (remain > 0) memmove(buf, buf + fed, remain);
     }
 
+    png_finish(&png);
     pngle_destroy(pngle);
     file.close();
 }
@@ -603,8 +1036,12 @@ void M5Display::drawPngUrl(const char *url, uint16_t x, uint16_t y,
     png.scale          = scale;
     png.alphaThreshold = alphaThreshold;
     png.tft            = this;
+    png.buf            = NULL;
+    png.bufMask        = NULL;
+    png.bufY           = -1;
 
     pngle_set_user_data(pngle, &png);
+    pngle_set_init_callback(pngle, pngle_init_callback);
     pngle_set_draw_callback(pngle, pngle_draw_callback);
 
     // Feed data to pngle
@@ -631,6 +1068,7 @@ void M5Display::drawPngUrl(const char *url, uint16_t x, uint16_t y,
         }
     }
 
+    png_finish(&png);
     pngle_destroy(pngle);
     http.end();
 }
@@ -9,6 +9,7 @@
 #include "utility/Config.h"  // This is where Core2 defines would be
 #include "utility/In_eSPI.h"
 #include "utility/Sprite.h"
+#include "utility/qrcode.h"
 
 typedef enum {
     JPEG_DIV_NONE,
@@ -18,6 +19,14 @@ typedef enum {
     JPEG_DIV_MAX
 } jpeg_div_t;
 
+// Time spent by drawJpgPipelined(), in microseconds. Decoding and transfer
+// overlap, so decode + transfer can exceed total.
+typedef struct {
+    uint32_t decode;    // in the decoder, reading the input included
+    uint32_t transfer;  // sending the pixels to the screen or sprite
+    uint32_t total;
+} jpeg_timing_t;
+
 struct DisplayState {
     uint8_t textfont, textsize, datum;
     const GFXfont *gfxFont;
@@ -79,6 +88,10 @@ class M5Display : public TFT_eSPI {
                 uint8_t width = 220, uint8_t version = 6);
     void qrcode(const String &string, uint16_t x = 50, uint16_t y = 10,
                 uint8_t width = 220, uint8_t version = 6);
+    // Draws a code made with qrcode_initText(), which can be kept and drawn
+    // again without generating it
+    void qrcode(QRCode *qrcode, uint16_t x = 50, uint16_t y = 10,
+                uint8_t width = 220);
 
     void drawBmp(fs::FS &fs, const char *path, uint16_t x, uint16_t y);
     void drawBmpFile(fs::FS &fs, const char *path, uint16_t x, uint16_t y);
@@ -109,6 +122,24 @@ class M5Display : public TFT_eSPI {
                      uint16_t maxHeight = 0, uint16_t offX = 0,
                      uint16_t offY = 0, jpeg_div_t scale = JPEG_DIV_NONE);
 
+    // Like drawJpg(), but a row of blocks is sent while the next one is
+    // decoded. With a sprite, the image goes into it instead of the screen,
+    // and x, y, maxWidth and maxHeight are in sprite coordinates.
+    bool drawJpgPipelined(const uint8_t *jpg_data, size_t jpg_len,
+                          uint16_t x = 0, uint16_t y = 0,
+                          uint16_t maxWidth = 0, uint16_t maxHeight = 0,
+                          uint16_t offX = 0, uint16_t offY = 0,
+                          jpeg_div_t scale = JPEG_DIV_NONE,
+                          TFT_eSprite *sprite = NULL,
+                          jpeg_timing_t *timing = NULL);
+
+    bool drawJpgPipelined(fs::FS &fs, const char *path, uint16_t x = 0,
+                          uint16_t y = 0, uint16_t maxWidth = 0,
+                          uint16_t maxHeight = 0, uint16_t offX = 0,
+                          uint16_t offY = 0, jpeg_div_t scale = JPEG_DIV_NONE,
+                          TFT_eSprite *sprite = NULL,
+                          jpeg_timing_t *timing = NULL);
+
     void drawPngFile(fs::FS &fs, const char *path, uint16_t x = 0,
                      uint16_t y = 0, uint16_t maxWidth = 0,
                      uint16_t maxHeight = 0, uint16_t offX = 0,
@@ -134,6 +165,11 @@ class M5Display : public TFT_eSPI {
    private:
     std::vector<DisplayState> _displayStateStack;
 
+    // The last code drawn by qrcode(), kept until the text or version changes
+    QRCode _qrcode;
+    std::vector<uint8_t> _qrcodeData;
+    String _qrcodeText;
+
 #ifdef M5Stack_M5Core2
 
 #ifdef TFT_eSPI_TOUCH_EMULATION
@@ -1823,6 +1823,226 @@ void TFT_eSPI::fillCircleHelper(int32_t x0, int32_t y0, int32_t r,
     }
 }
 
+/***************************************************************************************
+** Function name:           rectSpans
+** Description:             Spans of a rectangle outline, like drawRect()
+***************************************************************************************/
+uint32_t TFT_eSPI::rectSpans(tftSpan *spans, int32_t x, int32_t y, int32_t w,
+                             int32_t h, uint32_t color) {
+    spans[0] = {x, y, w, 1, color};
+    spans[1] = {x, y + h - 1, w, 1, color};
+    // Avoid drawing corner pixels twice
+    spans[2] = {x, y + 1, 1, h - 2, color};
+    spans[3] = {x + w - 1, y + 1, 1, h - 2, color};
+    return 4;
+}
+
+/***************************************************************************************
+** Function name:           circleSpans
+** Description:             Spans of a filled circle, like fillCircle()
+***************************************************************************************/
+// Widen the line of a row to half pixels each side of the centre
+static inline void widenSpan(tftSpan *row, int32_t x0, int32_t half) {
+    if (half + half + 1 > row->w) {
+        row->x = x0 - half;
+        row->w = half + half + 1;
+    }
+}
+
+uint32_t TFT_eSPI::circleSpans(tftSpan *spans, int32_t x0, int32_t y0,
+                               int32_t r, uint32_t color) {
+    if (r < 0) return 0;
+
+    // One line per row, as wide as the widest that fillCircle() draws there
+    int32_t rows = r + r + 1;
+    tftSpan *mid = spans + r;
+    for (int32_t i = 0; i < rows; i++) spans[i] = {x0, y0 - r + i, 0, 1, color};
+
+    int32_t x  = 0;
+    int32_t dx = 1;
+    int32_t dy = r + r;
+    int32_t p  = -(r >> 1);
+
+    widenSpan(mid, x0, r);
+
+    while (x < r) {
+        if (p >= 0) {
+            dy -= 2;
+            p -= dy;
+            r--;
+        }
+
+        dx += 2;
+        p += dx;
+
+        x++;
+
+        widenSpan(mid + x, x0, r);
+        widenSpan(mid - x, x0, r);
+        widenSpan(mid + r, x0, x);
+        widenSpan(mid - r, x0, x);
+    }
+
+    // Rows that no line reached
+    uint32_t n = 0;
+    for (int32_t i = 0; i < rows; i++)
+        if (spans[i].w) spans[n++] = spans[i];
+    return n;
+}
+
+/***************************************************************************************
+** Function name:           lineSpans
+** Description:             Spans of a line, like drawLine()
+***************************************************************************************/
+// The runs of Bresenham's algorithm, each a horizontal or vertical span
+uint32_t TFT_eSPI::lineSpans(tftSpan *spans, int32_t x0, int32_t y0,
+                             int32_t x1, int32_t y1, uint32_t color) {
+    uint32_t n    = 0;
+    boolean steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        swap_coord(x0, y0);
+        swap_coord(x1, y1);
+    }
+
+    if (x0 > x1) {
+        swap_coord(x0, x1);
+        swap_coord(y0, y1);
+    }
+
+    int32_t dx = x1 - x0, dy = abs(y1 - y0);
+
+    int32_t err = dx >> 1, ystep = -1, xs = x0, dlen = 0;
+
+    if (y0 < y1) ystep = 1;
+
+    for (; x0 <= x1; x0++) {
+        dlen++;
+        err -= dy;
+        if (err < 0) {
+            err += dx;
+            if (steep)
+                spans[n++] = {y0, xs, 1, dlen, color};
+            else
+                spans[n++] = {xs, y0, dlen, 1, color};
+            dlen = 0;
+            y0 += ystep;
+            xs = x0 + 1;
+        }
+    }
+    if (dlen) {
+        if (steep)
+            spans[n++] = {y0, xs, 1, dlen, color};
+        else
+            spans[n++] = {xs, y0, dlen, 1, color};
+    }
+    return n;
+}
+
+/***************************************************************************************
+** Function name:           drawSpans
+** Description:             Merge spans and draw them in one transaction
+***************************************************************************************/
+// How far back drawSpans() looks for a span to merge into, and how many times
+// it goes over the spans
+#define SPAN_MERGE_WINDOW 64
+#define SPAN_MERGE_PASSES 4
+
+static inline bool spansOverlap(const tftSpan *a, const tftSpan *b) {
+    return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h &&
+           b->y < a->y + a->h;
+}
+
+// Grow a to cover b, if together they make a rectangle
+static bool mergeSpan(tftSpan *a, const tftSpan *b) {
+    int32_t ax1 = a->x + a->w, ay1 = a->y + a->h;
+    int32_t bx1 = b->x + b->w, by1 = b->y + b->h;
+
+    if (b->x >= a->x && bx1 <= ax1 && b->y >= a->y && by1 <= ay1) return true;
+
+    if (a->x >= b->x && ax1 <= bx1 && a->y >= b->y && ay1 <= by1) {
+        *a = *b;
+        return true;
+    }
+
+    if (a->x == b->x && a->w == b->w && b->y <= ay1 && a->y <= by1) {
+        if (b->y < a->y) a->y = b->y;
+        a->h = (by1 > ay1 ? by1 : ay1) - a->y;
+        return true;
+    }
+
+    if (a->y == b->y && a->h == b->h && b->x <= ax1 && a->x <= bx1) {
+        if (b->x < a->x) a->x = b->x;
+        a->w = (bx1 > ax1 ? bx1 : ax1) - a->x;
+        return true;
+    }
+
+    return false;
+}
+
+// The spans are drawn as if one after the other, so a span is only merged
+// into an earlier one when no span in between overlaps it with another colour.
+// Merged spans can merge again (e.g. the edges of a row of cells only match
+// those of the next row once whole), hence a few passes.
+// The array is overwritten with the merged spans.
+uint32_t TFT_eSPI::drawSpans(tftSpan *spans, uint32_t count) {
+    int32_t w = width();
+    int32_t h = height();
+
+    uint32_t n = count;
+    for (uint8_t pass = 0; pass < SPAN_MERGE_PASSES; pass++) {
+        uint32_t merges = 0;
+        uint32_t kept   = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            tftSpan s = spans[i];
+
+            // Clipping
+            if (s.x < 0) {
+                s.w += s.x;
+                s.x = 0;
+            }
+            if (s.y < 0) {
+                s.h += s.y;
+                s.y = 0;
+            }
+            if (s.x + s.w > w) s.w = w - s.x;
+            if (s.y + s.h > h) s.h = h - s.y;
+            if ((s.w < 1) || (s.h < 1)) continue;
+
+            bool merged = false;
+            for (uint32_t j = kept; j > 0 && kept - j < SPAN_MERGE_WINDOW; j--) {
+                tftSpan *t = &spans[j - 1];
+                if (t->color == s.color) {
+                    if (mergeSpan(t, &s)) {
+                        merged = true;
+                        break;
+                    }
+                } else if (spansOverlap(t, &s)) {
+                    break;
+                }
+            }
+            if (merged)
+                merges++;
+            else
+                spans[kept++] = s;
+        }
+        n = kept;
+        if (!merges) break;
+    }
+
+    // spi_begin();          // Sprite class can use this function, avoiding
+    // spi_begin()
+    inTransaction = true;
+
+    for (uint32_t i = 0; i < n; i++)
+        fillRect(spans[i].x, spans[i].y, spans[i].w, spans[i].h,
+                 spans[i].color);
+
+    inTransaction = false;
+    spi_end();  // Does nothing if Sprite class uses this function
+
+    return n;
+}
+
 /***************************************************************************************
 ** Function name:           drawEllipse
 ** Description:             Draw a ellipse outline
@@ -4551,9 +4771,9 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y,
     if ((font > 1) && (font < 9) && ((uniCode < 32) || (uniCode > 127)))
         return 0;
 
-    int32_t width          = 0;
-    int32_t height         = 0;
-    uint32_t flash_address = 0;
+    int32_t width           = 0;
+    int32_t height          = 0;
+    uintptr_t flash_address = 0;
     uniCode -= 32;
 
 #ifdef LOAD_FONT2
@@ -4571,7 +4791,7 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y,
     {
         if ((font > 2) && (font < 9)) {
             flash_address = pgm_read_dword(
-                (const void *)(pgm_read_dword(&(fontdata[font].chartbl)) +
+                (const uint8_t *const *)(pgm_read_dword(&(fontdata[font].chartbl)) +
                                uniCode * sizeof(void *)));
             width = pgm_read_byte(
                 (uint8_t *)pgm_read_dword(&(fontdata[font].widthtbl)) +
@@ -6022,6 +6242,8 @@ void TFT_eSPI::unloadFont(void) {
         gBitmap = NULL;
     }
 
+    clearGlyphCache();
+
     if (fontFile) fontFile.close();
     fontLoaded = false;
 }
@@ -6216,6 +6438,19 @@ void TFT_eSPI::drawGlyph(uint16_t code) {
         if (textwrapY && ((cursor_y + gFont.yAdvance) >= _height)) cursor_y = 0;
         if (cursor_x == 0) cursor_x -= gdX[gNum];
 
+        int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
+        int16_t cx = cursor_x + gdX[gNum];
+
+        // A cached tile can't be used if the background is read back
+        if (glyphCache.budget && !getColor) {
+            glyphTile *tile = getGlyphTile(gNum, fg, bg);
+            if (tile) {
+                pushGlyphTile(tile, cx, cy);
+                cursor_x += gxAdvance[gNum];
+                return;
+            }
+        }
+
         fontFile.seek(gBitmap[gNum],
                       fs::SeekSet);  // This is taking >30ms for a significant
                                      // position shift
@@ -6225,9 +6460,6 @@ void TFT_eSPI::drawGlyph(uint16_t code) {
         int16_t xs  = 0;
         uint32_t dl = 0;
 
-        int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
-        int16_t cx = cursor_x + gdX[gNum];
-
         startWrite();  // Avoid slow ESP32 transaction overhead for every pixel
 
         for (int y = 0; y < gHeight[gNum]; y++) {
@@ -6281,6 +6513,181 @@ void TFT_eSPI::drawGlyph(uint16_t code) {
     }
 }
 
+/***************************************************************************************
+** Function name:           setGlyphCacheSize
+** Description:             Set the memory budget of the glyph cache, 0 turns it
+*off
+*************************************************************************************x*/
+void TFT_eSPI::setGlyphCacheSize(uint32_t bytes) {
+    glyphCache.budget = bytes;
+    while (glyphCacheTail && glyphCache.used > glyphCache.budget)
+        evictGlyphTile();
+}
+
+/***************************************************************************************
+** Function name:           getGlyphCacheStats
+** Description:             Get the hit and miss counts and the memory in use
+*************************************************************************************x*/
+TFT_eSPI::glyphCacheStats TFT_eSPI::getGlyphCacheStats(void) {
+    return glyphCache;
+}
+
+/***************************************************************************************
+** Function name:           resetGlyphCacheStats
+** Description:             Zero the hit, miss and eviction counts
+*************************************************************************************x*/
+void TFT_eSPI::resetGlyphCacheStats(void) {
+    glyphCache.hits      = 0;
+    glyphCache.misses    = 0;
+    glyphCache.evictions = 0;
+}
+
+/***************************************************************************************
+** Function name:           clearGlyphCache
+** Description:             Free all the cached glyph tiles
+*************************************************************************************x*/
+void TFT_eSPI::clearGlyphCache(void) {
+    while (glyphCacheTail) evictGlyphTile();
+}
+
+/***************************************************************************************
+** Function name:           evictGlyphTile
+** Description:             Free the least recently used glyph tile
+*************************************************************************************x*/
+void TFT_eSPI::evictGlyphTile(void) {
+    glyphTile *tile = glyphCacheTail;
+
+    glyphCacheTail = tile->prev;
+    if (glyphCacheTail)
+        glyphCacheTail->next = NULL;
+    else
+        glyphCacheHead = NULL;
+
+    glyphCache.used -= tile->size;
+    glyphCache.evictions++;
+    free(tile);
+}
+
+/***************************************************************************************
+** Function name:           getGlyphTile
+** Description:             Find the tile of a glyph in the cache, or make it from
+*the font file. Returns NULL if it doesn't fit in the cache
+*************************************************************************************x*/
+TFT_eSPI::glyphTile *TFT_eSPI::getGlyphTile(uint16_t gNum, uint16_t fg,
+                                            uint16_t bg) {
+    for (glyphTile *tile = glyphCacheHead; tile; tile = tile->next) {
+        if (tile->gNum != gNum || tile->fg != fg || tile->bg != bg) continue;
+
+        glyphCache.hits++;
+
+        // Move to the front, the least recently used tile stays at the back
+        if (tile != glyphCacheHead) {
+            tile->prev->next = tile->next;
+            if (tile->next)
+                tile->next->prev = tile->prev;
+            else
+                glyphCacheTail = tile->prev;
+            tile->prev           = NULL;
+            tile->next           = glyphCacheHead;
+            glyphCacheHead->prev = tile;
+            glyphCacheHead       = tile;
+        }
+        return tile;
+    }
+
+    glyphCache.misses++;
+
+    // The colours of the pixels, then a bit for each pixel to draw
+    uint32_t pixels = gWidth[gNum] * gHeight[gNum];
+    uint32_t size   = sizeof(glyphTile) + pixels * 2 + (pixels + 7) / 8;
+    if (size > glyphCache.budget) return NULL;
+
+    while (glyphCache.used + size > glyphCache.budget) evictGlyphTile();
+
+    glyphTile *tile = (glyphTile *)malloc(size);
+    if (!tile) return NULL;
+
+    tile->gNum   = gNum;
+    tile->fg     = fg;
+    tile->bg     = bg;
+    tile->width  = gWidth[gNum];
+    tile->height = gHeight[gNum];
+    tile->size   = size;
+
+    uint16_t *colors = (uint16_t *)(tile + 1);
+    uint8_t *mask    = (uint8_t *)(colors + pixels);
+    memset(mask, 0, (pixels + 7) / 8);
+
+    fontFile.seek(gBitmap[gNum], fs::SeekSet);
+
+    uint8_t pbuffer[tile->width];
+    uint32_t i = 0;
+    for (int y = 0; y < tile->height; y++) {
+        fontFile.read(pbuffer, tile->width);
+        for (int x = 0; x < tile->width; x++, i++) {
+            if (pbuffer[x]) {
+                colors[i] = alphaBlend(pbuffer[x], fg, bg);
+                mask[i >> 3] |= 0x80 >> (i & 7);
+            }
+        }
+    }
+
+    tile->prev = NULL;
+    tile->next = glyphCacheHead;
+    if (glyphCacheHead)
+        glyphCacheHead->prev = tile;
+    else
+        glyphCacheTail = tile;
+    glyphCacheHead = tile;
+    glyphCache.used += size;
+
+    return tile;
+}
+
+/***************************************************************************************
+** Function name:           pushGlyphTile
+** Description:             Draw a cached glyph, a span of pixels at a time
+*************************************************************************************x*/
+void TFT_eSPI::pushGlyphTile(glyphTile *tile, int32_t x, int32_t y) {
+    uint16_t *colors = (uint16_t *)(tile + 1);
+    uint8_t *mask    = (uint8_t *)(colors + tile->width * tile->height);
+
+    startWrite();
+
+    for (int32_t ty = 0; ty < tile->height; ty++) {
+        if ((y + ty < 0) || (y + ty >= _height)) continue;
+
+        uint32_t row = ty * tile->width;
+        int32_t tx   = 0;
+        while (tx < tile->width) {
+            // Skip the pixels left transparent
+            uint32_t i = row + tx;
+            if (!(mask[i >> 3] & (0x80 >> (i & 7)))) {
+                tx++;
+                continue;
+            }
+
+            int32_t start = tx;
+            do {
+                tx++;
+                i++;
+            } while (tx < tile->width && (mask[i >> 3] & (0x80 >> (i & 7))));
+
+            // Clip the span to the screen
+            int32_t xs = x + start;
+            int32_t xe = x + tx;
+            if (xs < 0) xs = 0;
+            if (xe > _width) xe = _width;
+            if (xs >= xe) continue;
+
+            setWindow(xs, y + ty, xe - 1, y + ty);
+            pushColors(colors + row + (xs - x), xe - xs, true);
+        }
+    }
+
+    endWrite();
+}
+
 /***************************************************************************************
 ** Function name:           showFont
 ** Description:             Page through all characters in font, td ms between
@@ -668,6 +668,15 @@ typedef struct {
     int16_t tch_spi_freq;
 } setup_t;
 
+// A solid rectangle, the unit of drawSpans()
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+    uint32_t color;
+} tftSpan;
+
 // This is a structure to conveniently hold information on the default fonts
 // Stores pointer to font character image address table, width table and height
 
@@ -816,6 +825,19 @@ class TFT_eSPI : public Print {
 
         commandList(const uint8_t *addr);
 
+    // Batched drawing: the *Spans() functions write the spans of a shape to
+    // an array and return how many they wrote, then drawSpans() merges the
+    // spans and draws them in one transaction, as if drawn one by one. It
+    // returns the number of address windows sent.
+    static uint32_t rectSpans(tftSpan *spans, int32_t x, int32_t y, int32_t w,
+                              int32_t h, uint32_t color),  // At most 4
+        circleSpans(tftSpan *spans, int32_t x0, int32_t y0, int32_t r,
+                    uint32_t color),  // Filled, at most 2 * r + 1
+        lineSpans(tftSpan *spans, int32_t x0, int32_t y0, int32_t x1,
+                  int32_t y1,
+                  uint32_t color);  // At most max(|x1 - x0|, |y1 - y0|) + 1
+    uint32_t drawSpans(tftSpan *spans, uint32_t count);
+
     uint8_t readcommand8(uint8_t cmd_function, uint8_t index = 0);
     uint16_t readcommand16(uint8_t cmd_function, uint8_t index = 0);
     uint32_t readcommand32(uint8_t cmd_function, uint8_t index = 0);
@@ -1034,6 +1056,23 @@ class TFT_eSPI : public Print {
 
     void showFont(uint32_t td);
 
+    // Keep recently drawn glyphs as ready to send tiles, so that drawing the
+    // same text again skips reading and blending the font file. Tiles are
+    // made for a glyph and a pair of colours, and the least recently used
+    // ones are freed to stay within bytes. 0, the default, turns it off.
+    void setGlyphCacheSize(uint32_t bytes);
+
+    typedef struct {
+        uint32_t hits;       // glyphs drawn from a cached tile
+        uint32_t misses;     // glyphs read from the font file
+        uint32_t evictions;  // tiles freed to make room
+        uint32_t used;       // bytes held by the tiles
+        uint32_t budget;     // bytes allowed by setGlyphCacheSize()
+    } glyphCacheStats;
+
+    glyphCacheStats getGlyphCacheStats(void);
+    void resetGlyphCacheStats(void);
+
     // This is for the whole font
     typedef struct {
         uint16_t gCount;      // Total number of characters
@@ -1067,6 +1106,30 @@ class TFT_eSPI : public Print {
     void loadMetrics(uint16_t gCount);
     uint32_t readInt32(void);
 
+    // A glyph pre-blended for a foreground and background colour, in a list
+    // ordered from the most to the least recently used. The tile is followed
+    // in memory by width * height colours, then a bit per pixel, set for the
+    // pixels to draw.
+    typedef struct glyphTile {
+        struct glyphTile *prev;
+        struct glyphTile *next;
+        uint32_t size;  // bytes, tile header included
+        uint16_t gNum;
+        uint16_t fg;
+        uint16_t bg;
+        uint8_t width;
+        uint8_t height;
+    } glyphTile;
+
+    glyphTile *glyphCacheHead  = NULL;
+    glyphTile *glyphCacheTail  = NULL;
+    glyphCacheStats glyphCache = {0, 0, 0, 0, 0};
+
+    glyphTile *getGlyphTile(uint16_t gNum, uint16_t fg, uint16_t bg);
+    void pushGlyphTile(glyphTile *tile, int32_t x, int32_t y);
+    void evictGlyphTile(void);
+    void clearGlyphCache(void);
+
     fs::FS &fontFS = SPIFFS;
     bool spiffs    = true;
 #endif
@@ -61,6 +61,9 @@ void *TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
 
     if (w < 1 || h < 1) return NULL;
 
+    // A 4 bpp Sprite can't be drawn without a palette
+    if (_bpp == 4 && !_colorMap && !createPalette()) return NULL;
+
     _iwidth = _dwidth = _bitwidth = w;
     _iheight = _dheight = h;
 
@@ -91,6 +94,7 @@ void *TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
 
     if (_img8) {
         _created = true;
+        allocDirtyTiles();
         return _img8;
     }
 
@@ -127,6 +131,15 @@ void *TFT_eSprite::callocSprite(int16_t w, int16_t h, uint8_t frames) {
             // auto assignation to psram
             ptr8 = (uint8_t *)heap_caps_calloc(w * h + 1, sizeof(uint8_t),
                                                MALLOC_CAP_8BIT);
+    } else if (_bpp == 4) {
+        // Two pixels a byte, the left one in the high nibble, and each line
+        // starts on a byte
+        int32_t bytes = ((w + 1) >> 1) * h + 1;
+        if (psramFound() && _usePsram)
+            ptr8 = (uint8_t *)ps_calloc(bytes, sizeof(uint8_t));
+        else
+            ptr8 = (uint8_t *)heap_caps_calloc(bytes, sizeof(uint8_t),
+                                               MALLOC_CAP_8BIT);
     } else  // Must be 1 bpp
     {
         //_dwidth   Display width+height in pixels always in rotation 0
@@ -168,7 +181,7 @@ void *TFT_eSprite::frameBuffer(int8_t f) {
 
     if (_bpp == 16) return _img;
 
-    if (_bpp == 8) return _img8;
+    if (_bpp == 8 || _bpp == 4) return _img8;
 
     if (f == 2)
         _img8 = _img8_2;
@@ -180,21 +193,31 @@ void *TFT_eSprite::frameBuffer(int8_t f) {
 
 /***************************************************************************************
 ** Function name:           setColorDepth
-** Description:             Set bits per pixel for colour (1, 8 or 16)
+** Description:             Set bits per pixel for colour (1, 4, 8 or 16)
 *************************************************************************************x*/
 
 void *TFT_eSprite::setColorDepth(int8_t b) {
     // Can't change an existing sprite's colour depth so delete it
     if (_created) free(_img8_1);
 
+    uint8_t oldBpp = _bpp;
+
     // Now define the new colour depth
     if (b > 8)
         _bpp = 16;  // Bytes per pixel
-    else if (b > 1)
+    else if (b > 4)
         _bpp = 8;
+    else if (b > 1)
+        _bpp = 4;
     else
         _bpp = 1;
 
+    // The palette has one entry per value of the old depth
+    if (_bpp != oldBpp) {
+        free(_colorMap);
+        _colorMap = NULL;
+    }
+
     // If it existed, re-create the sprite with the new colour depth
     if (_created) {
         _created = false;
@@ -206,7 +229,7 @@ void *TFT_eSprite::setColorDepth(int8_t b) {
 
 /***************************************************************************************
 ** Function name:           getColorDepth
-** Description:             Get bits per pixel for colour (1, 8 or 16)
+** Description:             Get bits per pixel for colour (1, 4, 8 or 16)
 *************************************************************************************x*/
 
 int8_t TFT_eSprite::getColorDepth(void) {
@@ -216,6 +239,115 @@ int8_t TFT_eSprite::getColorDepth(void) {
         return 0;
 }
 
+/***************************************************************************************
+** Function name:           createPalette
+** Description:             Give a 4 or 8 bpp Sprite a palette of colours
+*************************************************************************************x*/
+bool TFT_eSprite::createPalette(const uint16_t *colors, uint16_t count) {
+    if (_bpp != 4 && _bpp != 8) return false;
+
+    uint16_t size = 1 << _bpp;
+    if (!_colorMap) {
+        _colorMap = (uint16_t *)malloc(size * sizeof(uint16_t));
+        if (!_colorMap) {
+            log_e("No memory for a palette of %u colours", size);
+            return false;
+        }
+    }
+
+    // The 16 colours of In_eSPI.h in CGA order: bit 3 bright, then red,
+    // green and blue
+    static const uint16_t defaultColors[16] = {
+        TFT_BLACK,    TFT_NAVY,    TFT_DARKGREEN, TFT_DARKCYAN,
+        TFT_MAROON,   TFT_PURPLE,  TFT_OLIVE,     TFT_LIGHTGREY,
+        TFT_DARKGREY, TFT_BLUE,    TFT_GREEN,     TFT_CYAN,
+        TFT_RED,      TFT_MAGENTA, TFT_YELLOW,    TFT_WHITE};
+    uint8_t blue[] = {0, 11, 21, 31};
+    for (uint16_t i = 0; i < size; i++) {
+        uint16_t color;
+        if (i < count)
+            color = colors[i];
+        else if (_bpp == 4)
+            color = defaultColors[i];
+        else
+            color = (i & 0xE0) << 8 | (i & 0xC0) << 5 | (i & 0x1C) << 6 |
+                    (i & 0x1C) << 3 | blue[i & 0x03];
+        _colorMap[i] = (color >> 8) | (color << 8);
+    }
+
+    // The indices now stand for other colours
+    markDirty(0, 0, _iwidth, _iheight);
+    return true;
+}
+
+/***************************************************************************************
+** Function name:           setPaletteColor
+** Description:             Change one colour of the palette
+*************************************************************************************x*/
+void TFT_eSprite::setPaletteColor(uint8_t index, uint16_t color) {
+    if (!_colorMap || index >= (1 << _bpp)) return;
+
+    _colorMap[index] = (color >> 8) | (color << 8);
+    markDirty(0, 0, _iwidth, _iheight);
+}
+
+/***************************************************************************************
+** Function name:           getPaletteColor
+** Description:             Return the 565 colour of a palette index
+*************************************************************************************x*/
+uint16_t TFT_eSprite::getPaletteColor(uint8_t index) {
+    if (!_colorMap || index >= (1 << _bpp)) return 0;
+
+    uint16_t color = _colorMap[index];
+    return (color >> 8) | (color << 8);
+}
+
+/***************************************************************************************
+** Function name:           packColor
+** Description:             Convert a colour to the byte an 8 bpp Sprite stores
+*************************************************************************************x*/
+uint8_t TFT_eSprite::packColor(uint32_t color) {
+    if (_colorMap) return (uint8_t)color;
+
+    return (uint8_t)((color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
+                     (color & 0x0018) >> 3);
+}
+
+/***************************************************************************************
+** Function name:           paletteIndex
+** Description:             Find the palette entry nearest to a 565 colour
+*************************************************************************************x*/
+uint8_t TFT_eSprite::paletteIndex(uint16_t color) {
+    uint8_t best     = 0;
+    uint32_t bestErr = 0xFFFFFFFF;
+
+    // Red and blue are doubled to weigh the same as the 6 bits of green
+    for (uint16_t i = 0; i < (1 << _bpp); i++) {
+        uint16_t entry = (_colorMap[i] >> 8) | (_colorMap[i] << 8);
+        int32_t dr     = ((entry >> 11) - (color >> 11)) * 2;
+        int32_t dg     = ((entry >> 5) & 0x3F) - ((color >> 5) & 0x3F);
+        int32_t db     = ((entry & 0x1F) - (color & 0x1F)) * 2;
+        uint32_t err   = dr * dr + dg * dg + db * db;
+        if (err < bestErr) {
+            if (!err) return i;
+            bestErr = err;
+            best    = i;
+        }
+    }
+
+    return best;
+}
+
+/***************************************************************************************
+** Function name:           blendColor
+** Description:             Blend two colours, or pick one for indexed Sprites
+*************************************************************************************x*/
+uint16_t TFT_eSprite::blendColor(uint8_t alpha, uint16_t fg, uint16_t bg) {
+    if (_colorMap) return alpha > 127 ? fg : bg;
+
+    return alphaBlend(alpha, fg, bg);
+}
+
 /***************************************************************************************
 ** Function name:           setBitmapColor
 ** Description:             Set the foreground foreground and background colour
@@ -234,6 +366,10 @@ void TFT_eSprite::deleteSprite(void) {
     if (!_created) return;
 
     free(_img8_1);
+    free(_dirty);
+    _dirty = NULL;
+    free(_colorMap);
+    _colorMap = NULL;
 
     _created = false;
 }
@@ -270,72 +406,15 @@ int16_t TFT_eSprite::getPivotY(void) {
 bool TFT_eSprite::pushRotated(int16_t angle, int32_t transp) {
     if (!_created) return false;
 
-    // Trig values for the rotation
-    float radAngle = -angle * 0.0174532925;  // Convert degrees to radians
-    float sinra    = sin(radAngle);
-    float cosra    = cos(radAngle);
+    bool oldSwapBytes = _tft->getSwapBytes();
+    _tft->setSwapBytes(false);
+    _tft->startWrite();  // ESP32: avoid transaction overhead for every span
 
-    // Bounding box parameters
-    int16_t min_x;
-    int16_t min_y;
-    int16_t max_x;
-    int16_t max_y;
-
-    // Get the bounding box of this rotated source Sprite relative to Sprite
-    // pivot
-    getRotatedBounds(sinra, cosra, width(), height(), _xpivot, _ypivot, &min_x,
-                     &min_y, &max_x, &max_y);
-
-    // Move bounding box so source Sprite pivot coincides with TFT pivot
-    min_x += _tft->_xpivot;
-    max_x += _tft->_xpivot;
-    min_y += _tft->_ypivot;
-    max_y += _tft->_ypivot;
-
-    // Test only to show bounding box on TFT
-    // _tft->drawRect(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1,
-    // TFT_GREEN);
-
-    // Return if bounding box is outside of TFT area
-    if (min_x > _tft->width()) return true;
-    if (min_y > _tft->height()) return true;
-    if (max_x < 0) return true;
-    if (max_y < 0) return true;
-
-    // Clip bounding box to be within TFT area
-    if (min_x < 0) min_x = 0;
-    if (min_y < 0) min_y = 0;
-    if (max_x > _tft->width()) max_x = _tft->width();
-    if (max_y > _tft->height()) max_y = _tft->height();
-
-    _tft->startWrite();  // ESP32: avoid transaction overhead for every tft
-                         // pixel
-
-    // Scan destination bounding box and fetch transformed pixels from source
-    // Sprite
-    for (int32_t x = min_x; x <= max_x; x++) {
-        int32_t xt        = x - _tft->_xpivot;
-        float cxt         = cosra * xt + _xpivot;
-        float sxt         = sinra * xt + _ypivot;
-        bool column_drawn = false;
-        for (int32_t y = min_y; y <= max_y; y++) {
-            int32_t yt = y - _tft->_ypivot;
-            int32_t xs = (int32_t)round(cxt - sinra * yt);
-            // Do not calculate ys unless xs is in bounds
-            if (xs >= 0 && xs < width()) {
-                int32_t ys = (int32_t)round(sxt + cosra * yt);
-                // Check if ys is in bounds
-                if (ys >= 0 && ys < height()) {
-                    int32_t rp = readPixel(xs, ys);
-                    if (rp != transp) _tft->drawPixel(x, y, rp);
-                    column_drawn = true;
-                }
-            } else if (column_drawn)
-                y = max_y;  // Skip remaining column pixels
-        }
-    }
+    pushRotatedSpans(NULL, angle, transp, _tft->_xpivot, _tft->_ypivot,
+                     _tft->width(), _tft->height());
 
     _tft->endWrite();  // ESP32: end transaction
+    _tft->setSwapBytes(oldSwapBytes);
 
     return true;
 }
@@ -348,6 +427,56 @@ bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, int32_t transp) {
     if (!_created) return false;       // Check this Sprite is created
     if (!spr->_created) return false;  // Ckeck destination Sprite is created
 
+    bool oldSwapBytes = spr->getSwapBytes();
+    spr->setSwapBytes(true);
+
+    pushRotatedSpans(spr, angle, transp, spr->_xpivot, spr->_ypivot,
+                     spr->width(), spr->height());
+
+    spr->setSwapBytes(oldSwapBytes);
+
+    return true;
+}
+
+/***************************************************************************************
+** Function name:           clipRotatedSpan
+** Description:             Narrow the steps k0..k1 of a scanline to those where
+**                          the 16.16 source coordinate pos + k * step is in 0..size-1
+*************************************************************************************x*/
+static int32_t floorDiv(int64_t a, int64_t b) {
+    return (int32_t)(a / b - ((a % b != 0) && ((a < 0) != (b < 0))));
+}
+
+static void clipRotatedSpan(int64_t pos, int32_t step, int32_t size,
+                            int32_t *k0, int32_t *k1) {
+    int64_t limit = (int64_t)size << 16;
+
+    if (step == 0) {
+        if (pos < 0 || pos >= limit) *k1 = *k0 - 1;
+        return;
+    }
+
+    int32_t first, last;
+    if (step > 0) {
+        first = -floorDiv(pos, step);  // ceil(-pos / step)
+        last  = floorDiv(limit - 1 - pos, step);
+    } else {
+        first = floorDiv(pos - limit, -step) + 1;
+        last  = floorDiv(pos, -step);
+    }
+    if (first > *k0) *k0 = first;
+    if (last < *k1) *k1 = last;
+}
+
+/***************************************************************************************
+** Function name:           pushRotatedSpans
+** Description:             Draw the rotated copy of the Sprite one scanline at a
+**                          time, to spr or to the TFT if spr is NULL
+*************************************************************************************x*/
+void TFT_eSprite::pushRotatedSpans(TFT_eSprite *spr, int16_t angle,
+                                   int32_t transp, int16_t xpivot,
+                                   int16_t ypivot, int16_t dwidth,
+                                   int16_t dheight) {
     // Trig values for the rotation
     float radAngle = -angle * 0.0174532925;  // Convert degrees to radians
     float sinra    = sin(radAngle);
@@ -359,59 +488,106 @@ bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, int32_t transp) {
     int16_t max_x;
     int16_t max_y;
 
-    // Get the bounding box of this rotated source Sprite
+    // Get the bounding box of this rotated source Sprite relative to Sprite
+    // pivot
     getRotatedBounds(sinra, cosra, width(), height(), _xpivot, _ypivot, &min_x,
                      &min_y, &max_x, &max_y);
 
     // Move bounding box so source Sprite pivot coincides with destination
-    // Sprite pivot
-    min_x += spr->_xpivot;
-    max_x += spr->_xpivot;
-    min_y += spr->_ypivot;
-    max_y += spr->_ypivot;
-
-    // Test only to show bounding box
-    // spr->fillSprite(TFT_BLACK);
-    // spr->drawRect(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1,
-    // TFT_GREEN);
-
-    // Return if bounding box is completely outside of destination Sprite
-    if (min_x > spr->width()) return true;
-    if (min_y > spr->height()) return true;
-    if (max_x < 0) return true;
-    if (max_y < 0) return true;
-
-    // Clip bounding box if it is partially within destination Sprite
+    // pivot
+    min_x += xpivot;
+    max_x += xpivot;
+    min_y += ypivot;
+    max_y += ypivot;
+
+    // Return if bounding box is outside of destination area
+    if (min_x >= dwidth) return;
+    if (min_y >= dheight) return;
+    if (max_x < 0) return;
+    if (max_y < 0) return;
+
+    // Clip bounding box to be within destination area
     if (min_x < 0) min_x = 0;
     if (min_y < 0) min_y = 0;
-    if (max_x > spr->width()) max_x = spr->width();
-    if (max_y > spr->height()) max_y = spr->height();
-
-    // Scan destination bounding box and fetch transformed pixels from source
-    // Sprite
-    for (int32_t x = min_x; x <= max_x; x++) {
-        int32_t xt        = x - spr->_xpivot;
-        float cxt         = cosra * xt + _xpivot;
-        float sxt         = sinra * xt + _ypivot;
-        bool column_drawn = false;
-        for (int32_t y = min_y; y <= max_y; y++) {
-            int32_t yt = y - spr->_ypivot;
-            int32_t xs = (int32_t)round(cxt - sinra * yt);
-            // Do not calculate ys unless xs is in bounds
-            if (xs >= 0 && xs < width()) {
-                int32_t ys = (int32_t)round(sxt + cosra * yt);
-                // Check if ys is in bounds
-                if (ys >= 0 && ys < height()) {
-                    int32_t rp = readPixel(xs, ys);
-                    if (rp != transp) spr->drawPixel(x, y, rp);
-                    column_drawn = true;
-                }
-            } else if (column_drawn)
-                y = max_y;  // Skip the remaining pixels below the Sprite
+    if (max_x >= dwidth) max_x = dwidth - 1;
+    if (max_y >= dheight) max_y = dheight - 1;
+
+    // The source position in 16.16 fixed point moves by (cos, sin) for each
+    // destination pixel along a scanline, and by (-sin, cos) between
+    // scanlines. The extra half pixel makes the truncation round.
+    int32_t dx = (int32_t)lround(cosra * 65536);
+    int32_t dy = (int32_t)lround(sinra * 65536);
+    int64_t x0 = (int64_t)_xpivot * 65536 + 0x8000 +
+                 (int64_t)dx * (min_x - xpivot) -
+                 (int64_t)dy * (min_y - ypivot);
+    int64_t y0 = (int64_t)_ypivot * 65536 + 0x8000 +
+                 (int64_t)dy * (min_x - xpivot) +
+                 (int64_t)dx * (min_y - ypivot);
+    int32_t sw = width();
+    int32_t sh = height();
+
+    // Pixels are sent as stored in a 16 bit Sprite, with the bytes swapped.
+    // An indexed Sprite compares transp with the palette index instead, as
+    // pushSprite() does.
+    int32_t stored = transp < 0 ? -1 : (uint16_t)(transp << 8 | transp >> 8);
+    uint16_t line[max_x - min_x + 1];
+
+    for (int32_t y = min_y; y <= max_y; y++, x0 -= dy, y0 += dx) {
+        // Only the pixels falling inside this Sprite are visited
+        int32_t k0 = 0;
+        int32_t k1 = max_x - min_x;
+        clipRotatedSpan(x0, dx, sw, &k0, &k1);
+        clipRotatedSpan(y0, dy, sh, &k0, &k1);
+        if (k0 > k1) continue;
+
+        int32_t xs  = (int32_t)(x0 + (int64_t)dx * k0);
+        int32_t ys  = (int32_t)(y0 + (int64_t)dy * k0);
+        int32_t run = k0;  // first pixel of the span in line
+        for (int32_t k = k0; k <= k1; k++, xs += dx, ys += dy) {
+            uint16_t color;
+            bool transparent;
+            if (_bpp == 16) {
+                color       = _img[(xs >> 16) + (ys >> 16) * _iwidth];
+                transparent = color == stored;
+            } else if (_colorMap) {
+                uint16_t index = readPixelValue(xs >> 16, ys >> 16);
+                color          = _colorMap[index];  // Already swapped
+                transparent    = index == transp;
+            } else {
+                color       = readPixel(xs >> 16, ys >> 16);
+                color       = color << 8 | color >> 8;
+                transparent = color == stored;
+            }
+
+            if (transparent) {
+                if (k > run)
+                    pushRotatedSpan(spr, min_x + run, y, line + run, k - run);
+                run = k + 1;
+                continue;
+            }
+            line[k] = color;
         }
+        if (k1 >= run)
+            pushRotatedSpan(spr, min_x + run, y, line + run, k1 + 1 - run);
     }
+}
 
-    return true;
+/***************************************************************************************
+** Function name:           pushRotatedSpan
+** Description:             Push a span of pixels with swapped bytes to spr, or
+**                          to the TFT if spr is NULL
+*************************************************************************************x*/
+void TFT_eSprite::pushRotatedSpan(TFT_eSprite *spr, int32_t x, int32_t y,
+                                  uint16_t *line, int32_t len) {
+    if (!spr) {
+        _tft->pushImage(x, y, len, 1, line);
+    } else if (spr->_bpp > 1) {
+        spr->pushImage(x, y, len, 1, line);
+    } else {
+        // pushImage() would take the line for a bitmap
+        for (int32_t i = 0; i < len; i++)
+            spr->drawPixel(x + i, y, line[i] << 8 | line[i] >> 8);
+    }
 }
 
 /***************************************************************************************
@@ -467,7 +643,18 @@ void TFT_eSprite::getRotatedBounds(float sina, float cosa, int16_t w, int16_t h,
 void TFT_eSprite::pushSprite(int32_t x, int32_t y) {
     if (!_created) return;
 
-    if (_bpp == 16) {
+    if (_dirty) {
+        pushDirtyTiles(x, y);
+        return;
+    }
+
+    if (_colorMap) {
+        _tft->startWrite();
+        pushSpriteRect(x, y, 0, 0, _iwidth, _iheight);
+        _tft->endWrite();
+    }
+
+    else if (_bpp == 16) {
         bool oldSwapBytes = _tft->getSwapBytes();
         _tft->setSwapBytes(false);
         _tft->pushImage(x, y, _iwidth, _iheight, _img);
@@ -491,15 +678,247 @@ void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transp) {
         _tft->setSwapBytes(false);
         _tft->pushImage(x, y, _iwidth, _iheight, _img, transp);
         _tft->setSwapBytes(oldSwapBytes);
-    } else if (_bpp == 8) {
+    } else if (_bpp == 8 && !_colorMap) {
         transp = (uint8_t)((transp & 0xE000) >> 8 | (transp & 0x0700) >> 6 |
                            (transp & 0x0018) >> 3);
         _tft->pushImage(x, y, _dwidth, _dheight, _img8, (uint8_t)transp,
                         (bool)true);
+    } else if (_colorMap) {
+        // Send the runs of each line that aren't the transparent index
+        _tft->startWrite();
+        for (int32_t ry = 0; ry < _iheight; ry++) {
+            int32_t rx = 0;
+            while (rx < _iwidth) {
+                while (rx < _iwidth && readPixelValue(rx, ry) == transp) rx++;
+                int32_t run = rx;
+                while (rx < _iwidth && readPixelValue(rx, ry) != transp) rx++;
+                if (rx > run) pushSpriteRect(x, y, run, ry, rx - run, 1);
+            }
+        }
+        _tft->endWrite();
     } else
         _tft->pushImage(x, y, _dwidth, _dheight, _img8, 0, (bool)false);
 }
 
+/***************************************************************************************
+** Function name:           setDirtyTiles
+** Description:             Set the tile size for partial pushes, 0 for off
+*************************************************************************************x*/
+void TFT_eSprite::setDirtyTiles(uint8_t size) {
+    _tileShift = 0;
+    if (size) {
+        _tileShift = 3;
+        while (_tileShift < 7 && (2 << _tileShift) <= size) _tileShift++;
+    }
+    allocDirtyTiles();
+}
+
+void TFT_eSprite::allocDirtyTiles(void) {
+    free(_dirty);
+    _dirty       = NULL;
+    _tilesPushed = false;
+
+    if (!_tileShift || !_created || _bpp == 1) return;
+
+    _tilesX = (_iwidth + (1 << _tileShift) - 1) >> _tileShift;
+    _tilesY = (_iheight + (1 << _tileShift) - 1) >> _tileShift;
+
+    // Without memory for the map every push sends the whole Sprite
+    _dirty = (uint8_t *)malloc(_tilesX * _tilesY);
+    if (_dirty) memset(_dirty, 1, _tilesX * _tilesY);
+}
+
+/***************************************************************************************
+** Function name:           markDirty
+** Description:             Mark the tiles under a rectangle as changed
+*************************************************************************************x*/
+void TFT_eSprite::markDirty(int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (!_dirty) return;
+
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if ((x + w) > _iwidth) w = _iwidth - x;
+    if ((y + h) > _iheight) h = _iheight - y;
+    if ((w < 1) || (h < 1)) return;
+
+    int32_t tx0 = x >> _tileShift;
+    int32_t tx1 = (x + w - 1) >> _tileShift;
+    int32_t ty0 = y >> _tileShift;
+    int32_t ty1 = (y + h - 1) >> _tileShift;
+
+    for (int32_t ty = ty0; ty <= ty1; ty++)
+        memset(_dirty + ty * _tilesX + tx0, 1, tx1 - tx0 + 1);
+}
+
+/***************************************************************************************
+** Function name:           pushDirtyTiles
+** Description:             Send the dirty tiles, merged into rectangles, in one
+**                          transaction
+*************************************************************************************x*/
+void TFT_eSprite::pushDirtyTiles(int32_t x, int32_t y) {
+    // The screen only holds the clean tiles where they were last pushed
+    if (!_tilesPushed || x != _tilesPushX || y != _tilesPushY)
+        memset(_dirty, 1, _tilesX * _tilesY);
+    _tilesPushed = true;
+    _tilesPushX  = x;
+    _tilesPushY  = y;
+
+    // Bytes a full push would send, to work out the saving
+    int32_t vx0 = x < 0 ? 0 : x;
+    int32_t vy0 = y < 0 ? 0 : y;
+    int32_t vx1 = x + _iwidth;
+    int32_t vy1 = y + _iheight;
+    if (vx1 > _tft->width()) vx1 = _tft->width();
+    if (vy1 > _tft->height()) vy1 = _tft->height();
+    uint32_t full =
+        (vx1 > vx0 && vy1 > vy0) ? (vx1 - vx0) * (vy1 - vy0) * 2 : 0;
+
+    uint32_t sent = 0;
+    _tft->startWrite();
+
+    for (int32_t ty = 0; ty < _tilesY; ty++) {
+        uint8_t *row = _dirty + ty * _tilesX;
+        for (int32_t tx = 0; tx < _tilesX; tx++) {
+            if (!row[tx]) continue;
+
+            // Widen along the row, then grow down while the rows below are
+            // dirty across the whole width. The tiles taken are cleared,
+            // so each one is sent once.
+            int32_t tw = 1;
+            while (tx + tw < _tilesX && row[tx + tw]) tw++;
+
+            int32_t th = 1;
+            while (ty + th < _tilesY) {
+                uint8_t *below = row + th * _tilesX + tx;
+                int32_t i      = 0;
+                while (i < tw && below[i]) i++;
+                if (i < tw) break;
+                th++;
+            }
+
+            for (int32_t i = 0; i < th; i++)
+                memset(row + i * _tilesX + tx, 0, tw);
+
+            int32_t rx = tx << _tileShift;
+            int32_t ry = ty << _tileShift;
+            int32_t rw = tw << _tileShift;
+            int32_t rh = th << _tileShift;
+            if (rx + rw > _iwidth) rw = _iwidth - rx;
+            if (ry + rh > _iheight) rh = _iheight - ry;
+            sent += pushSpriteRect(x, y, rx, ry, rw, rh);
+
+            _tileStats.rects++;
+            _tileStats.tiles += tw * th;
+            tx += tw - 1;
+        }
+    }
+
+    _tft->endWrite();
+
+    _tileStats.pushes++;
+    _tileStats.sent += sent;
+    _tileStats.saved += full - sent;
+    _tileStats.lastSent  = sent;
+    _tileStats.lastSaved = full - sent;
+}
+
+/***************************************************************************************
+** Function name:           pushSpriteRect
+** Description:             Send a rectangle of the Sprite pushed at x, y, clipped to
+**                          the screen, inside a transaction
+*************************************************************************************x*/
+uint32_t TFT_eSprite::pushSpriteRect(int32_t x, int32_t y, int32_t rx,
+                                     int32_t ry, int32_t rw, int32_t rh) {
+    if (x + rx < 0) {
+        rw += x + rx;
+        rx = -x;
+    }
+    if (y + ry < 0) {
+        rh += y + ry;
+        ry = -y;
+    }
+    if (x + rx + rw > _tft->width()) rw = _tft->width() - x - rx;
+    if (y + ry + rh > _tft->height()) rh = _tft->height() - y - ry;
+    if ((rw < 1) || (rh < 1)) return 0;
+
+    _tft->setWindow(x + rx, y + ry, x + rx + rw - 1, y + ry + rh - 1);
+
+    if (_bpp == 16) {
+        // The pixels are stored with their bytes swapped, ready to send
+        uint16_t *data = _img + ry * _iwidth + rx;
+        for (int32_t i = 0; i < rh; i++) {
+            _tft->pushColors(data, rw, false);
+            data += _iwidth;
+        }
+    } else if (_bpp == 4) {
+        // Look each nibble up in the palette, which is ready to send
+        int32_t stride = (_iwidth + 1) >> 1;
+        uint16_t lineBuf[rw];
+        uint8_t *data = _img8 + ry * stride + (rx >> 1);
+        for (int32_t i = 0; i < rh; i++) {
+            uint8_t *pair  = data;
+            uint16_t *line = lineBuf;
+            int32_t n      = rw;
+            if (rx & 1) {
+                *line++ = _colorMap[*pair++ & 0x0F];
+                n--;
+            }
+            while (n > 1) {
+                *line++ = _colorMap[*pair >> 4];
+                *line++ = _colorMap[*pair++ & 0x0F];
+                n -= 2;
+            }
+            if (n) *line = _colorMap[*pair >> 4];
+            _tft->pushColors(lineBuf, rw, false);
+            data += stride;
+        }
+    } else if (_colorMap) {
+        uint16_t lineBuf[rw];
+        uint8_t *data = _img8 + ry * _iwidth + rx;
+        for (int32_t i = 0; i < rh; i++) {
+            for (int32_t j = 0; j < rw; j++) lineBuf[j] = _colorMap[data[j]];
+            _tft->pushColors(lineBuf, rw, false);
+            data += _iwidth;
+        }
+    } else {
+        // Expand RGB332 like TFT_eSPI::pushImage() does
+        uint8_t blue[] = {0, 11, 21, 31};
+        uint16_t lineBuf[rw];
+        uint8_t *data = _img8 + ry * _iwidth + rx;
+        for (int32_t i = 0; i < rh; i++) {
+            uint8_t *linePtr = (uint8_t *)lineBuf;
+            for (int32_t j = 0; j < rw; j++) {
+                uint8_t color = data[j];
+                *linePtr++ =
+                    (color & 0x1C) >> 2 | (color & 0xC0) >> 3 | (color & 0xE0);
+                *linePtr++ = (color & 0x1C) << 3 | blue[color & 0x03];
+            }
+            _tft->pushColors(lineBuf, rw, false);
+            data += _iwidth;
+        }
+    }
+
+    return rw * rh * 2;
+}
+
+/***************************************************************************************
+** Function name:           getDirtyTileStats
+** Description:             Return the partial push statistics
+*************************************************************************************x*/
+TFT_eSprite::dirtyTileStats TFT_eSprite::getDirtyTileStats(void) {
+    return _tileStats;
+}
+
+void TFT_eSprite::resetDirtyTileStats(void) {
+    memset(&_tileStats, 0, sizeof(_tileStats));
+}
+
 /***************************************************************************************
 ** Function name:           readPixel
 ** Description:             Read 565 colour of a pixel at defined coordinates
@@ -508,6 +927,11 @@ uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) {
     if ((x < 0) || (x >= _iwidth) || (y < 0) || (y >= _iheight) || !_created)
         return 0;
 
+    if (_colorMap) {
+        uint16_t color = _colorMap[readPixelValue(x, y)];
+        return (color >> 8) | (color << 8);
+    }
+
     if (_bpp == 16) {
         uint16_t color = _img[x + y * _iwidth];
         return (color >> 8) | (color << 8);
@@ -542,6 +966,24 @@ uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) {
     return color >> 7;
 }
 
+/***************************************************************************************
+** Function name:           readPixelValue
+** Description:             Read the palette index or stored value of a pixel
+*************************************************************************************x*/
+uint16_t TFT_eSprite::readPixelValue(int32_t x, int32_t y) {
+    if ((x < 0) || (x >= _iwidth) || (y < 0) || (y >= _iheight) || !_created)
+        return 0;
+
+    if (_bpp == 4) {
+        uint8_t pair = _img8[(x >> 1) + y * ((_iwidth + 1) >> 1)];
+        return (x & 1) ? pair & 0x0F : pair >> 4;
+    }
+
+    if (_bpp == 8) return _img8[x + y * _iwidth];
+
+    return readPixel(x, y);
+}
+
 /***************************************************************************************
 ** Function name:           pushImage
 ** Description:             push 565 colour image into a defined area of a
@@ -576,6 +1018,8 @@ void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h,
     if (xs + ws >= (int32_t)_iwidth) ws = _iwidth - xs;
     if (ys + hs >= (int32_t)_iheight) hs = _iheight - ys;
 
+    markDirty(xs, ys, ws, hs);
+
     if (_bpp == 16)  // Plot a 16 bpp image into a 16 bpp Sprite
     {
         for (int32_t yp = yo; yp < yo + hs; yp++) {
@@ -588,6 +1032,25 @@ void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h,
             }
             ys++;
         }
+    } else if (_colorMap)  // Match a 16 bpp image to the palette
+    {
+        // Images repeat colours, so the last match is kept
+        uint16_t last = 0;
+        uint8_t index = paletteIndex(last);
+        for (int32_t yp = yo; yp < yo + hs; yp++) {
+            x = xs;
+            for (int32_t xp = xo; xp < xo + ws; xp++) {
+                uint16_t color = data[xp + yp * w];
+                if (_iswapBytes) color = color << 8 | color >> 8;
+                if (color != last) {
+                    last  = color;
+                    index = paletteIndex(color);
+                }
+                drawPixel(x, ys, index);
+                x++;
+            }
+            ys++;
+        }
     } else if (_bpp == 8)  // Plot a 16 bpp image into a 8 bpp Sprite
     {
         for (int32_t yp = yo; yp < yo + hs; yp++) {
@@ -672,6 +1135,8 @@ void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h,
     if (xs + ws >= (int32_t)_iwidth) ws = _iwidth - xs;
     if (ys + hs >= (int32_t)_iheight) hs = _iheight - ys;
 
+    markDirty(xs, ys, ws, hs);
+
     if (_bpp == 16)  // Plot a 16 bpp image into a 16 bpp Sprite
     {
         for (int32_t yp = yo; yp < yo + hs; yp++) {
@@ -684,6 +1149,25 @@ void TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h,
             }
             ys++;
         }
+    } else if (_colorMap)  // Match a 16 bpp image to the palette
+    {
+        // Images repeat colours, so the last match is kept
+        uint16_t last = 0;
+        uint8_t index = paletteIndex(last);
+        for (int32_t yp = yo; yp < yo + hs; yp++) {
+            x = xs;
+            for (int32_t xp = xo; xp < xo + ws; xp++) {
+                uint16_t color = pgm_read_word(data + xp + yp * w);
+                if (_iswapBytes) color = color << 8 | color >> 8;
+                if (color != last) {
+                    last  = color;
+                    index = paletteIndex(color);
+                }
+                drawPixel(x, ys, index);
+                x++;
+            }
+            ys++;
+        }
     }
 
     else if (_bpp == 8)  // Plot a 16 bpp image into a 8 bpp Sprite
@@ -785,6 +1269,9 @@ void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
         _ys = y0;
         _xe = x1;
         _ye = y1;
+
+        // pushColor() and writeColor() are expected to fill the window
+        markDirty(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
     }
 
     _xptr = _xs;
@@ -803,9 +1290,7 @@ void TFT_eSprite::pushColor(uint32_t color) {
         _img[_xptr + _yptr * _iwidth] = (uint16_t)(color >> 8) | (color << 8);
 
     else if (_bpp == 8)
-        _img8[_xptr + _yptr * _iwidth] =
-            (uint8_t)((color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                      (color & 0x0018) >> 3);
+        _img8[_xptr + _yptr * _iwidth] = packColor(color);
 
     else
         drawPixel(_xptr, _yptr, color);
@@ -844,11 +1329,10 @@ void TFT_eSprite::pushColor(uint32_t color, uint16_t len) {
         pixelColor = (uint16_t)(color >> 8) | (color << 8);
 
     else if (_bpp == 8)
-        pixelColor = (color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                     (color & 0x0018) >> 3;
+        pixelColor = packColor(color);
 
     else
-        pixelColor = (uint16_t)color;  // for 1bpp
+        pixelColor = (uint16_t)color;  // for 1 and 4 bpp
 
     while (len--) writeColor(pixelColor);
 }
@@ -875,7 +1359,7 @@ void TFT_eSprite::writeColor(uint16_t color) {
     // Write 16 bit RGB 565 encoded colour to RAM
     if (_bpp == 16) _img[_xptr + _yptr * _iwidth] = color;
 
-    // Write 8 bit RGB 332 encoded colour to RAM
+    // Write 8 bit RGB 332 encoded colour or palette index to RAM
     else if (_bpp == 8)
         _img8[_xptr + _yptr * _iwidth] = (uint8_t)color;
 
@@ -935,6 +1419,8 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy) {
         return;
     }
 
+    markDirty(_sx, _sy, _sw, _sh);
+
     // Fetch the scroll area width and height set by setScrollRect()
     uint32_t w = _sw - abs(dx);  // line width to copy
     uint32_t h = _sh - abs(dy);  // lines to copy
@@ -978,15 +1464,17 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy) {
             typ += iw;
             fyp += iw;
         }
-    } else if (_bpp == 1) {
+    } else if (_bpp == 1 || _bpp == 4) {
         if (dx > 0) {
-            tx += w;
-            fx += w;
+            tx += w - 1;
+            fx += w - 1;
         }              // Start from right edge
         while (h--) {  // move pixels one by one
             for (uint16_t xp = 0; xp < w; xp++) {
-                if (dx <= 0) drawPixel(tx + xp, ty, readPixel(fx + xp, fy));
-                if (dx > 0) drawPixel(tx - xp, ty, readPixel(fx - xp, fy));
+                if (dx <= 0)
+                    drawPixel(tx + xp, ty, readPixelValue(fx + xp, fy));
+                if (dx > 0)
+                    drawPixel(tx - xp, ty, readPixelValue(fx - xp, fy));
             }
             if (dy <= 0) {
                 ty++;
@@ -997,7 +1485,7 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy) {
             }
         }
     } else
-        return;  // Not 1, 8 or 16 bpp
+        return;  // Not 1, 4, 8 or 16 bpp
 
     // Fill the gap left by the scrolling
     if (dx > 0) fillRect(_sx, _sy, dx, _sh, _scolor);
@@ -1017,14 +1505,16 @@ void TFT_eSprite::fillScreen(uint32_t color) {
 void TFT_eSprite::fillSprite(uint32_t color) {
     if (!_created) return;
 
+    markDirty(0, 0, _iwidth, _iheight);
+
     // Use memset if possible as it is super fast
     if (((uint8_t)color == (uint8_t)(color >> 8)) && _bpp == 16)
         memset(_img, (uint8_t)color, _iwidth * _iheight * 2);
-    else if (_bpp == 8) {
-        color = (color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                (color & 0x0018) >> 3;
-        memset(_img8, (uint8_t)color, _iwidth * _iheight);
-    } else if (_bpp == 1) {
+    else if (_bpp == 8)
+        memset(_img8, packColor(color), _iwidth * _iheight);
+    else if (_bpp == 4)
+        memset(_img8, (color & 0x0F) * 0x11, ((_iwidth + 1) >> 1) * _iheight);
+    else if (_bpp == 1) {
         if (color)
             memset(_img8, 0xFF, (_iwidth >> 3) * _iheight + 1);
         else
@@ -1117,13 +1607,19 @@ void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color) {
     if ((x < 0) || (y < 0) || !_created) return;
     if ((x >= _iwidth) || (y >= _iheight)) return;
 
+    if (_dirty) _dirty[(y >> _tileShift) * _tilesX + (x >> _tileShift)] = 1;
+
     if (_bpp == 16) {
         color                 = (color >> 8) | (color << 8);
         _img[x + y * _iwidth] = (uint16_t)color;
     } else if (_bpp == 8) {
-        _img8[x + y * _iwidth] =
-            (uint8_t)((color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                      (color & 0x0018) >> 3);
+        _img8[x + y * _iwidth] = packColor(color);
+    } else if (_bpp == 4) {
+        uint8_t *pair = _img8 + (x >> 1) + y * ((_iwidth + 1) >> 1);
+        if (x & 1)
+            *pair = (*pair & 0xF0) | (color & 0x0F);
+        else
+            *pair = (*pair & 0x0F) | (color & 0x0F) << 4;
     } else  // 1 bpp
     {
         if (_rotation == 1) {
@@ -1225,6 +1721,8 @@ void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h,
 
     if (h < 1) return;
 
+    markDirty(x, y, 1, h);
+
     if (_bpp == 16) {
         color      = (color >> 8) | (color << 8);
         int32_t yp = x + _iwidth * y;
@@ -1233,9 +1731,17 @@ void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h,
             yp += _iwidth;
         }
     } else if (_bpp == 8) {
-        color = (color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                (color & 0x0018) >> 3;
+        color = packColor(color);
         while (h--) _img8[x + _iwidth * y++] = (uint8_t)color;
+    } else if (_bpp == 4) {
+        int32_t stride = (_iwidth + 1) >> 1;
+        uint8_t *pair  = _img8 + (x >> 1) + y * stride;
+        uint8_t keep   = (x & 1) ? 0xF0 : 0x0F;  // the other pixel
+        color          = ((color & 0x0F) * 0x11) & ~keep;
+        while (h--) {
+            *pair = (*pair & keep) | color;
+            pair += stride;
+        }
     } else {
         while (h--) {
             drawPixel(x, y, color);
@@ -1261,13 +1767,15 @@ void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w,
 
     if (w < 1) return;
 
+    markDirty(x, y, w, 1);
+
     if (_bpp == 16) {
         color = (color >> 8) | (color << 8);
         while (w--) _img[_iwidth * y + x++] = (uint16_t)color;
     } else if (_bpp == 8) {
-        color = (color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                (color & 0x0018) >> 3;
-        memset(_img8 + _iwidth * y + x, (uint8_t)color, w);
+        memset(_img8 + _iwidth * y + x, packColor(color), w);
+    } else if (_bpp == 4) {
+        fillRect(x, y, w, 1, color);
     } else {
         while (w--) {
             drawPixel(x, y, color);
@@ -1300,6 +1808,8 @@ void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
 
     if ((w < 1) || (h < 1)) return;
 
+    markDirty(x, y, w, h);
+
     int32_t yp = _iwidth * y + x;
 
     if (_bpp == 16) {
@@ -1315,12 +1825,30 @@ void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
             memcpy(_img + yp, _img + ys, w << 1);
         }
     } else if (_bpp == 8) {
-        color = (color & 0xE000) >> 8 | (color & 0x0700) >> 6 |
-                (color & 0x0018) >> 3;
+        color = packColor(color);
         while (h--) {
             memset(_img8 + yp, (uint8_t)color, w);
             yp += _iwidth;
         }
+    } else if (_bpp == 4) {
+        // An odd first column is the low nibble of its byte and an even last
+        // column the high one; the whole bytes between are set at once
+        int32_t stride = (_iwidth + 1) >> 1;
+        uint8_t *line  = _img8 + (x >> 1) + y * stride;
+        uint8_t index  = color & 0x0F;
+        int32_t head   = x & 1;
+        int32_t bytes  = (w - head) >> 1;
+        int32_t tail   = (w - head) & 1;
+        while (h--) {
+            uint8_t *pair = line;
+            if (head) {
+                *pair = (*pair & 0xF0) | index;
+                pair++;
+            }
+            memset(pair, index * 0x11, bytes);
+            if (tail) pair[bytes] = (pair[bytes] & 0x0F) | index << 4;
+            line += stride;
+        }
     } else {
         while (h--) {
             int32_t ww = w;
@@ -1626,11 +2154,11 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color,
                                 bg = getColor(x + xo + xx, y + yo + yy);
                             if (size == 1) {
                                 drawPixel(x + xo + xx, y + yo + yy,
-                                          alphaBlend(alphamap[c], fg, bg));
+                                          blendColor(alphamap[c], fg, bg));
                             } else {
                                 fillRect(x + (xo16 + xx) * size,
                                          y + (yo16 + yy) * size, size, size,
-                                         alphaBlend(alphamap[c], fg, bg));
+                                         blendColor(alphamap[c], fg, bg));
                             }
                         }
                         bits <<= 2;
@@ -1744,9 +2272,9 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y,
     if ((font > 1) && (font < 9) && ((uniCode < 32) || (uniCode > 127)))
         return 0;
 
-    int32_t width          = 0;
-    int32_t height         = 0;
-    uint32_t flash_address = 0;
+    int32_t width           = 0;
+    int32_t height          = 0;
+    uintptr_t flash_address = 0;
     uniCode -= 32;
 
 #ifdef LOAD_FONT2
@@ -1767,7 +2295,7 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y,
             // This is slower than above but is more convenient for the RLE
             // fonts
             flash_address = pgm_read_dword(
-                (const void *)(pgm_read_dword(&(fontdata[font].chartbl)) +
+                (const uint8_t *const *)(pgm_read_dword(&(fontdata[font].chartbl)) +
                                uniCode * sizeof(void *)));
             width = pgm_read_byte(
                 (uint8_t *)pgm_read_dword(&(fontdata[font].widthtbl)) +
@@ -1853,8 +2381,7 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y,
         if (_bpp == 16)
             color = (textcolor >> 8) | (textcolor << 8);
         else if (_bpp == 8)
-            color = ((textcolor & 0xE000) >> 8 | (textcolor & 0x0700) >> 6 |
-                     (textcolor & 0x0018) >> 3);
+            color = packColor(textcolor);
         int32_t px = 0,
                 py = pY;  // To hold character block start and end column and
                           // row values
@@ -1983,7 +2510,7 @@ void TFT_eSprite::drawGlyph(uint16_t code) {
                                       y + this->cursor_y +
                                           this->gFont.maxAscent -
                                           this->gdY[gNum],
-                                      alphaBlend(pixel, fg, bg));
+                                      blendColor(pixel, fg, bg));
                         else if (pixel > 127)
                             drawPixel(x + this->cursor_x + this->gdX[gNum],
                                       y + this->cursor_y +
@@ -2055,6 +2582,7 @@ void TFT_eSprite::drawColorBitmap(int32_t x0, int32_t y0, int32_t w, int32_t h,
         ga          = (g2 * (16 - alpha) + g1 * alpha) / 16;
         ba          = (b2 * (16 - alpha) + b1 * alpha) / 16;
         DataBuff[c] = color565(ra, ga, ba);
+        if (_colorMap) DataBuff[c] = paletteIndex(DataBuff[c]);
     }
 
     for (int i = 0; i < len; i++) {
@@ -2093,6 +2621,7 @@ void TFT_eSprite::drawColorBitmapAlpha(int32_t x0, int32_t y0, int32_t w,
         ga          = (g2 * (16 - alpha) + g1 * alpha) / 16;
         ba          = (b2 * (16 - alpha) + b1 * alpha) / 16;
         DataBuff[c] = color565(ra, ga, ba);
+        if (_colorMap) DataBuff[c] = paletteIndex(DataBuff[c]);
     }
 
     for (int i = 0; i < len; i++) {
@@ -31,8 +31,8 @@ class TFT_eSprite : public TFT_eSPI {
 
     // Create a sprite of width x height pixels, return a pointer to the RAM
     // area Sketch can cast returned value to (uint16_t*) for 16 bit depth if
-    // needed RAM required is 1 byte per pixel for 8 bit colour depth, 2 bytes
-    // for 16 bit
+    // needed RAM required is half a byte per pixel for 4 bit colour depth,
+    // 1 byte for 8 bit, 2 bytes for 16 bit
     void *createSprite(int16_t width, int16_t height, uint8_t frames = 1);
 
     // Delete the sprite to free up the RAM
@@ -41,12 +41,24 @@ class TFT_eSprite : public TFT_eSPI {
     // Select the frame buffer for graphics
     void *frameBuffer(int8_t f);
 
-    // Set or get the colour depth to 8 or 16 bits. Can be used to change depth
-    // an existing sprite, but clears it to black, returns a new pointer if
-    // sprite is re-created.
+    // Set or get the colour depth to 1, 4, 8 or 16 bits. Can be used to
+    // change depth an existing sprite, but clears it to black, returns a new
+    // pointer if sprite is re-created.
     void *setColorDepth(int8_t b);
     int8_t getColorDepth(void);
 
+    // Indexed colour. A 4 bpp Sprite always has a palette of 16 colours, an
+    // 8 bpp one swaps RGB332 for a palette of 256 when createPalette() is
+    // called. The colours given to the drawing functions are then palette
+    // indices, pushImage() takes the closest entry for each pixel and
+    // readPixel() returns the 565 colour. Anti-aliased text picks the
+    // foreground or the background instead of blending. Without colours the
+    // palette is the 16 colours of In_eSPI.h, black to white, or RGB332;
+    // entries past count keep those. Returns false without memory.
+    bool createPalette(const uint16_t *colors = NULL, uint16_t count = 0);
+    void setPaletteColor(uint8_t index, uint16_t color);
+    uint16_t getPaletteColor(uint8_t index);
+
     void setBitmapColor(uint16_t c, uint16_t b);
 
     void drawPixel(int32_t x, int32_t y, uint32_t color);
@@ -93,10 +105,15 @@ class TFT_eSprite : public TFT_eSPI {
     void getSprite2Buff(uint16_t *ptr, int32_t x, int32_t y, int32_t w,
                         int32_t h);
 
-    // Push a rotated copy of Sprite to TFT with optional transparent colour
+    // Push a rotated copy of Sprite to TFT with optional transparent colour.
+    // The source position is stepped in 16.16 fixed point. At angles other
+    // than multiples of 90, a destination pixel that falls exactly halfway
+    // between two source pixels can round to the other one than the float
+    // version did, which changes a few pixels along the edges. For indexed
+    // Sprites transp is a palette index, as for pushSprite().
     bool pushRotated(int16_t angle, int32_t transp = -1);
     // Push a rotated copy of Sprite to another different Sprite with optional
-    // transparent colour
+    // transparent colour (a palette index for indexed Sprites)
     bool pushRotated(TFT_eSprite *spr, int16_t angle, int32_t transp = -1);
     // Set and get the pivot point for this Sprite
     void setPivot(int16_t x, int16_t y);
@@ -109,6 +126,9 @@ class TFT_eSprite : public TFT_eSPI {
 
     // Read the colour of a pixel at x,y and return value in 565 format
     uint16_t readPixel(int32_t x0, int32_t y0);
+    // Read the value stored for a pixel: the palette index, the RGB332 byte
+    // of an 8 bpp Sprite without a palette, or as readPixel() for 1 and 16 bpp
+    uint16_t readPixelValue(int32_t x, int32_t y);
 
     // Write an image (colour bitmap) to the sprite
     void pushImage(int32_t x0, int32_t y0, int32_t w, int32_t h,
@@ -124,10 +144,35 @@ class TFT_eSprite : public TFT_eSPI {
 
     // Push the sprite to the TFT screen, this fn calls pushImage() in the TFT
     // class. Optionally a "transparent" colour can be defined, pixels of that
-    // colour will not be rendered
+    // colour will not be rendered (a palette index for indexed Sprites)
     void pushSprite(int32_t x, int32_t y);
     void pushSprite(int32_t x, int32_t y, uint16_t transparent);
 
+    // Only send the parts of the Sprite that changed since the last push. The
+    // Sprite is divided in tiles of size x size pixels (a power of 2 from 8
+    // to 128), drawing marks the tiles it touches, and pushSprite(x, y) sends
+    // the marked ones, merged into rectangles. Everything is sent when the
+    // Sprite is pushed somewhere else. 0, the default, turns it off. For 4, 8
+    // and 16 bpp Sprites.
+    void setDirtyTiles(uint8_t size);
+
+    // Mark an area as changed, after writing to the buffer directly or
+    // drawing over the Sprite on the screen
+    void markDirty(int32_t x, int32_t y, int32_t w, int32_t h);
+
+    typedef struct {
+        uint32_t pushes;     // pushSprite() calls with tiles on
+        uint32_t rects;      // rectangles sent
+        uint32_t tiles;      // dirty tiles sent
+        uint32_t sent;       // pixel bytes sent
+        uint32_t saved;      // pixel bytes of the clean tiles left out
+        uint32_t lastSent;   // pixel bytes sent by the last push
+        uint32_t lastSaved;  // pixel bytes left out by the last push
+    } dirtyTileStats;
+
+    dirtyTileStats getDirtyTileStats(void);
+    void resetDirtyTileStats(void);
+
     int16_t drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font),
         drawChar(uint16_t uniCode, int32_t x, int32_t y);
 
@@ -166,13 +211,38 @@ class TFT_eSprite : public TFT_eSPI {
     // Reserve memory for the Sprite and return a pointer
     void *callocSprite(int16_t width, int16_t height, uint8_t frames = 1);
 
+    // Draw a rotated copy of the Sprite with the destination pivot at
+    // xpivot, ypivot, into spr or onto the TFT if spr is NULL
+    void pushRotatedSpans(TFT_eSprite *spr, int16_t angle, int32_t transp,
+                          int16_t xpivot, int16_t ypivot, int16_t dwidth,
+                          int16_t dheight);
+    void pushRotatedSpan(TFT_eSprite *spr, int32_t x, int32_t y,
+                         uint16_t *line, int32_t len);
+
+    // Size the tile map for the Sprite, or free it
+    void allocDirtyTiles(void);
+    // Send the dirty tiles of a Sprite pushed at x, y
+    void pushDirtyTiles(int32_t x, int32_t y);
+    // Send a rectangle of the Sprite, return the number of bytes sent
+    uint32_t pushSpriteRect(int32_t x, int32_t y, int32_t rx, int32_t ry,
+                            int32_t rw, int32_t rh);
+
+    // The byte an 8 bpp Sprite stores for a colour: RGB332 or the index
+    uint8_t packColor(uint32_t color);
+    // The palette entry closest to a 565 colour
+    uint8_t paletteIndex(uint16_t color);
+    // alphaBlend(), or the nearer of fg and bg for indexed Sprites
+    uint16_t blendColor(uint8_t alpha, uint16_t fg, uint16_t bg);
+
    protected:
-    uint8_t _bpp;      // bits per pixel (1, 8 or 16)
+    uint8_t _bpp;      // bits per pixel (1, 4, 8 or 16)
     uint16_t *_img;    // pointer to 16 bit sprite
     uint8_t *_img8;    // pointer to  8 bit sprite
     uint8_t *_img8_1;  // pointer to  frame 1
     uint8_t *_img8_2;  // pointer to  frame 2
 
+    uint16_t *_colorMap = NULL;  // palette, bytes swapped ready to send
+
     int16_t _xpivot;  // x pivot point coordinate
     int16_t _ypivot;  // y pivot point coordinate
 
@@ -187,6 +257,15 @@ class TFT_eSprite : public TFT_eSPI {
     uint32_t _sw, _sh;                         // w,h for scroll zone
     uint32_t _scolor;  // gap fill colour for scroll zone
 
+    uint8_t *_dirty     = NULL;  // one byte per tile, non-zero if changed
+    uint8_t _tileShift  = 0;     // log2 of the tile size, 0 if off
+    int32_t _tilesX     = 0;     // tiles across and down
+    int32_t _tilesY     = 0;
+    bool _tilesPushed   = false;  // the screen shows the clean tiles at
+    int32_t _tilesPushX = 0;      // _tilesPushX, _tilesPushY
+    int32_t _tilesPushY = 0;
+    dirtyTileStats _tileStats = {0, 0, 0, 0, 0, 0, 0};
+
     boolean _iswapBytes;  // Swap the byte order for Sprite pushImage()
 
     int32_t _iwidth,
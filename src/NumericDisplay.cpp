@@ -0,0 +1,158 @@
+#include "../include/NumericDisplay.h"
+
+////////////////////////////////////////////////////////////////////
+// NumericDisplay Variable inits
+////////////////////////////////////////////////////////////////////
+uint32_t NumericDisplay::cellsDrawn = 0;
+uint32_t NumericDisplay::cellsSkipped = 0;
+
+//////////////////////////////////////////////////////////////////////
+// The charset lists the characters to pre-render, for example
+// "0123456789.-FC". Others can still be printed, but are drawn with
+// the font every time.
+//////////////////////////////////////////////////////////////////////
+NumericDisplay::NumericDisplay(const char *charset) : charset(charset) {
+}
+
+NumericDisplay::~NumericDisplay() {
+    atlas.deleteSprite();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Render the atlas for a text size and colors. Calling it again with
+// the same parameters does nothing, so it can be called on every
+// frame; with new ones, the next print() redraws every character.
+// Returns false if there is no memory for the atlas, in which case
+// print() falls back to drawing with the font.
+//////////////////////////////////////////////////////////////////////
+bool NumericDisplay::begin(M5GFX *disp, uint8_t size, uint16_t fg, uint16_t bg) {
+    if (disp == display && size == textSize && fg == textColor && bg == bgColor)
+        return atlasReady;
+
+    display = disp;
+    textSize = size;
+    textColor = fg;
+    bgColor = bg;
+    dirty = true;
+
+    // Cells are as wide as the widest character, so the font doesn't
+    // have to be monospaced
+    atlas.deleteSprite();
+    atlas.setColorDepth(16);
+    atlas.setTextSize(size);
+    cellWidth = 0;
+    for (const char *c = charset; *c; c++) {
+        char s[2] = {*c, 0};
+        cellWidth = max(cellWidth, (int)atlas.textWidth(s));
+    }
+    cellHeight = atlas.fontHeight();
+
+    // One column of cells, so that the pixels of a cell are contiguous
+    // and can be sent with a single pushImage()
+    int count = strlen(charset);
+    atlas.setPsram(true);
+    atlasReady = atlas.createSprite(cellWidth, cellHeight * count) != nullptr;
+    if (!atlasReady) {
+        atlas.setPsram(false);
+        atlasReady = atlas.createSprite(cellWidth, cellHeight * count) != nullptr;
+    }
+    if (!atlasReady) {
+        Serial.printf("\tERROR: no memory for a %dx%d numeric display atlas\n", cellWidth, cellHeight * count);
+        return false;
+    }
+
+    atlas.fillSprite(bg);
+    atlas.setTextColor(fg, bg);
+    for (int i = 0; i < count; i++)
+        atlas.drawChar(charset[i], 0, i * cellHeight);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set the top left corner of the first character
+//////////////////////////////////////////////////////////////////////
+void NumericDisplay::setPosition(int xPos, int yPos) {
+    if (xPos != x || yPos != y)
+        dirty = true;
+    x = xPos;
+    y = yPos;
+}
+
+//////////////////////////////////////////////////////////////////////
+// The width of a text of the given length, once begin() has sized the
+// cells, so that what is drawn next to it can stay clear
+//////////////////////////////////////////////////////////////////////
+int NumericDisplay::width(int chars) {
+    return chars * cellWidth;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Tell the widget that the screen under it was cleared (e.g. by
+// fillScreen), so the next print() draws every character again but
+// doesn't need to erase the old ones
+//////////////////////////////////////////////////////////////////////
+void NumericDisplay::invalidate() {
+    shown[0] = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Draw the text, only sending the characters that differ from the
+// last call, and erasing the ones left over from a longer text
+//////////////////////////////////////////////////////////////////////
+void NumericDisplay::print(const char *text) {
+    if (display == nullptr)
+        return;
+
+    int len = strlen(text);
+    if (len > MAX_CHARS)
+        len = MAX_CHARS;
+    int shownLen = strlen(shown);
+
+    for (int i = 0; i < max(len, shownLen); i++) {
+        char c = i < len ? text[i] : 0;
+        if (!dirty && i < shownLen && c == shown[i]) {
+            cellsSkipped++;
+            continue;
+        }
+
+        int cellX = x + i * cellWidth;
+        if (c)
+            drawCell(c, cellX);
+        else
+            display->fillRect(cellX, y, cellWidth, cellHeight, bgColor);
+        cellsDrawn++;
+    }
+
+    memcpy(shown, text, len);
+    shown[len] = 0;
+    dirty = false;
+}
+
+void NumericDisplay::printf(const char *format, ...) {
+    char text[MAX_CHARS + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    print(text);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Copy the atlas cell of a character to the display
+//////////////////////////////////////////////////////////////////////
+void NumericDisplay::drawCell(char c, int cellX) {
+    const char *found = strchr(charset, c);
+    if (atlasReady && found != nullptr) {
+        // 16-bit sprites hold their pixels byte swapped, ready to send
+        const lgfx::swap565_t *cells = static_cast<const lgfx::swap565_t *>(atlas.getBuffer());
+        int index = found - charset;
+        display->pushImage(cellX, y, cellWidth, cellHeight, cells + index * cellWidth * cellHeight);
+        return;
+    }
+
+    // Not pre-rendered: draw it with the font
+    display->fillRect(cellX, y, cellWidth, cellHeight, bgColor);
+    display->setTextSize(textSize);
+    display->setTextColor(textColor, bgColor);
+    display->drawChar(c, cellX, y);
+}
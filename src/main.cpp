@@ -13,6 +13,8 @@
 #include "../include/I2C_RW.h"
 #include <Wire.h>
 
+#include "../include/NumericDisplay.h"
+
 ////////////////////////////////////////////////////////////////////
 // Variables
 ////////////////////////////////////////////////////////////////////
@@ -45,6 +47,26 @@ double tempMin;
 double tempMax;
 bool isFahrenheit = true;
 
+// The parts of the OpenWeather response that we display: the parser writes
+// them straight into this struct, so no JsonDocument is built on updates
+struct WeatherReport {
+    char main[16];
+    char icon[8];
+    char name[32];
+    double temp;
+    double tempMin;
+    double tempMax;
+};
+
+static const JsonField<WeatherReport> weatherReportFields[] = {
+    ARDUINOJSON_FIELD(WeatherReport, main, "weather.0.main"),
+    ARDUINOJSON_FIELD(WeatherReport, icon, "weather.0.icon"),
+    ARDUINOJSON_FIELD(WeatherReport, name, "name"),
+    ARDUINOJSON_FIELD(WeatherReport, temp, "main.temp"),
+    ARDUINOJSON_FIELD(WeatherReport, tempMin, "main.temp_min"),
+    ARDUINOJSON_FIELD(WeatherReport, tempMax, "main.temp_max"),
+};
+
 int zipcode = 91016;
 int zipcodeArray[5] = {9, 1, 0, 1, 6};
 
@@ -60,6 +82,20 @@ WiFiUDP ntpUDP;
 NTPClient timeClient(ntpUDP, "pool.ntp.org", -8 * 3600, 60000);
 String lastSyncTime = "Not synced";
 
+// Numbers that change between updates are drawn from pre-rendered
+// characters; the rest of a screen is only drawn when it is entered
+// or when what it shows changes
+NumericDisplay hiTempDisplay("0123456789-FC");
+NumericDisplay nowTempDisplay("0123456789-FC");
+NumericDisplay loTempDisplay("0123456789-FC");
+NumericDisplay syncTimeDisplay("0123456789:APM");
+NumericDisplay sensorTempDisplay("0123456789.-FC");
+NumericDisplay sensorHumDisplay("0123456789.%");
+bool weatherScreenDrawn = false;
+bool sensorScreenDrawn = false;
+String drawnWeatherIcon;
+String drawnCityName;
+
 ///// Project 2
 int const I2C_FREQ = 400000;
 
@@ -177,6 +213,7 @@ void loop() {
 
         // switch to sensor screen only from weather
         if (displayState == WEATHER) {
+            sensorScreenDrawn = false;
             drawSensorDisplay();
             displayState = SENSOR;
             timerDelay = 5000;  // 5-second updates for sensor screen
@@ -189,12 +226,20 @@ void loop() {
         if (WiFi.status() == WL_CONNECTED) {
             if (displayState == WEATHER) {
                 fetchWeatherDetails();
+                NumericDisplay::cellsDrawn = NumericDisplay::cellsSkipped = 0;
+                unsigned long frameStart = micros();
                 drawWeatherDisplay();
+                Serial.printf("Weather frame: %lu us (%lu cells drawn, %lu unchanged)\n",
+                              micros() - frameStart, (unsigned long)NumericDisplay::cellsDrawn, (unsigned long)NumericDisplay::cellsSkipped);
             }
             if (displayState == SENSOR) {
                 // redraw on change
                 if ((lastHum != SENSOR_HUMIDITY || lastTemp != SENSOR_TEMPERATURE) || millis() - lastTime > 5000) {
+                    NumericDisplay::cellsDrawn = NumericDisplay::cellsSkipped = 0;
+                    unsigned long frameStart = micros();
                     drawSensorDisplay();
+                    Serial.printf("Sensor frame: %lu us (%lu cells drawn, %lu unchanged)\n",
+                                  micros() - frameStart, (unsigned long)NumericDisplay::cellsDrawn, (unsigned long)NumericDisplay::cellsSkipped);
                 }
             }
         }
@@ -238,20 +283,16 @@ void fetchWeatherDetails() {
     String serverURL = urlOpenWeather + "zip=" + zipcode + ",us&units=imperial&appid=" + apiKey;
     String response = httpGETRequest(serverURL.c_str());
 
-    const size_t jsonCapacity = 768 + 250;
-    DynamicJsonDocument objResponse(jsonCapacity);
-    DeserializationError error = deserializeJson(objResponse, response);
+    WeatherReport report = {};
+    DeserializationError error = deserializeJsonFields(report, response.c_str(), response.length(), weatherReportFields);
     if (error) return;
 
-    JsonArray arrWeather = objResponse["weather"];
-    JsonObject objWeather0 = arrWeather[0];
-    strWeatherDesc = objWeather0["main"].as<String>();
-    strWeatherIcon = objWeather0["icon"].as<String>();
-    cityName = objResponse["name"].as<String>();
-    JsonObject objMain = objResponse["main"];
-    tempNow = objMain["temp"];
-    tempMin = objMain["temp_min"];
-    tempMax = objMain["temp_max"];
+    strWeatherDesc = report.main;
+    strWeatherIcon = report.icon;
+    cityName = report.name;
+    tempNow = report.temp;
+    tempMin = report.tempMin;
+    tempMax = report.tempMax;
 }
 
 /////////////////////////////////////////////////////////////////
@@ -270,63 +311,81 @@ void drawWeatherDisplay() {
         backgroundColor = TFT_NAVY;
         primaryTextColor = TFT_WHITE;
     }
-    M5.Lcd.fillScreen(backgroundColor);
-
-    //////////////////////////////////////////////////////////////////
-    // Draw the weather icon on the right side of the screen
-    //////////////////////////////////////////////////////////////////
-    int iconSize = 100; // Size of the weather icon
-    int iconX = M5.Lcd.width() - iconSize - 20; // Position icon on the right with some padding
-    int iconY = 20; // Position icon at the top with some padding
-    drawWeatherImage(strWeatherIcon, 3, iconX, iconY, iconSize, iconSize);
 
-    //////////////////////////////////////////////////////////////////
-    // Draw the temperatures and city name
-    //////////////////////////////////////////////////////////////////
     int pad = 20; // Increased padding for better spacing
     int textX = pad;
     int textY = pad;
+    int timestampY = sHeight - 30;  // 30 px from bottom
 
-    tempNow = isFahrenheit ? tempNow : (tempNow - 32) * 5 / 9;
-    tempMin = isFahrenheit ? tempMin : (tempMin - 32) * 5 / 9;
-    tempMax = isFahrenheit ? tempMax : (tempMax - 32) * 5 / 9;
+    // The background, icon and labels only change with the weather
+    // icon or the city, so they are not redrawn on every update
+    bool redrawAll = !weatherScreenDrawn || strWeatherIcon != drawnWeatherIcon || cityName != drawnCityName;
+    if (redrawAll) {
+        M5.Lcd.fillScreen(backgroundColor);
+
+        //////////////////////////////////////////////////////////////////
+        // Draw the weather icon on the right side of the screen
+        //////////////////////////////////////////////////////////////////
+        int iconSize = 100; // Size of the weather icon
+        int iconX = M5.Lcd.width() - iconSize - 20; // Position icon on the right with some padding
+        int iconY = 20; // Position icon at the top with some padding
+        drawWeatherImage(strWeatherIcon, 3, iconX, iconY, iconSize, iconSize);
+
+        // Draw the "HI" and "LO" labels
+        M5.Display.setTextSize(2);
+        M5.Display.setCursor(textX, textY);
+        M5.Display.setTextColor(TFT_RED);
+        M5.Display.print("HI: ");
+        M5.Display.setCursor(textX, textY + 100);
+        M5.Display.setTextColor(TFT_BLUE);
+        M5.Display.print("LO: ");
+
+        // Draw city name
+        M5.Display.setCursor(textX, textY + 130);
+        M5.Display.setTextColor(primaryTextColor);
+        M5.Display.setTextWrap(true); // Enable text wrapping for long city names
+        M5.Display.printf("%s\n", cityName.c_str());
+
+        //    Draw last sync time label (added code)
+        //    Example: "Last Sync: 05:23:45PM"
+        //    We'll put it near the bottom of the screen
+        M5.Lcd.setCursor(pad, timestampY);
+        M5.Lcd.setTextColor(syncTextColor);
+        M5.Lcd.print("Last Sync: ");
+
+        weatherScreenDrawn = true;
+        drawnWeatherIcon = strWeatherIcon;
+        drawnCityName = cityName;
+    }
 
-    // Draw "LO" temperature
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextColor(TFT_RED);
-    M5.Display.setTextSize(2);
-    M5.Display.printf("HI: %.0f%s\n", tempMax, unit);
-
-    // Draw current temperature
-    textY += 30; // Adjust vertical spacing
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextColor(primaryTextColor);
-    M5.Display.setTextSize(6); // Larger font size for current temperature
-    M5.Display.printf("%.0f%s\n", tempNow, unit);
-
-    // Draw "HI" temperature
-    textY += 70; // Adjust vertical spacing
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextColor(TFT_BLUE);
+    //////////////////////////////////////////////////////////////////
+    // Draw the temperatures and the sync time
+    //////////////////////////////////////////////////////////////////
     M5.Display.setTextSize(2);
-    M5.Display.printf("LO: %.0f%s\n", tempMin, unit);
+    int labelWidth = M5.Display.textWidth("HI: ");
+    hiTempDisplay.begin(&M5.Display, 2, TFT_RED, backgroundColor);
+    nowTempDisplay.begin(&M5.Display, 6, primaryTextColor, backgroundColor); // Larger font size for current temperature
+    loTempDisplay.begin(&M5.Display, 2, TFT_BLUE, backgroundColor);
+    syncTimeDisplay.begin(&M5.Display, 2, syncTextColor, backgroundColor);
+    hiTempDisplay.setPosition(textX + labelWidth, textY);
+    nowTempDisplay.setPosition(textX, textY + 30);
+    loTempDisplay.setPosition(textX + labelWidth, textY + 100);
+    syncTimeDisplay.setPosition(pad + M5.Display.textWidth("Last Sync: "), timestampY);
+    if (redrawAll) {
+        hiTempDisplay.invalidate();
+        nowTempDisplay.invalidate();
+        loTempDisplay.invalidate();
+        syncTimeDisplay.invalidate();
+    }
 
-    // Draw city name
-    textY += 30; // Adjust vertical spacing
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextColor(primaryTextColor);
-    M5.Display.setTextSize(2);
-    M5.Display.setTextWrap(true); // Enable text wrapping for long city names
-    M5.Display.printf("%s\n", cityName.c_str());
+    tempNow = isFahrenheit ? tempNow : (tempNow - 32) * 5 / 9;
+    tempMin = isFahrenheit ? tempMin : (tempMin - 32) * 5 / 9;
+    tempMax = isFahrenheit ? tempMax : (tempMax - 32) * 5 / 9;
 
-    //    Draw last sync time (added code)
-    //    Example: "Last Sync: 05:23:45PM"
-    //    We'll put it near the bottom of the screen
-    int timestampY = sHeight - 30;  // 30 px from bottom
-    M5.Lcd.setCursor(pad, timestampY);
-    M5.Lcd.setTextSize(2);
-    M5.Lcd.setTextColor(syncTextColor);
-    M5.Lcd.printf("Last Sync: %s", lastSyncTime.c_str());
+    hiTempDisplay.printf("%.0f%s", tempMax, unit.c_str());
+    nowTempDisplay.printf("%.0f%s", tempNow, unit.c_str());
+    loTempDisplay.printf("%.0f%s", tempMin, unit.c_str());
+    syncTimeDisplay.print(lastSyncTime.c_str());
 }
 
 /////////////////////////////////////////////////////////////////
@@ -465,6 +524,7 @@ void drawWeatherImage(String iconId, int resizeMult, int xOffset, int yOffset, i
 }
 
 void changeToWeather() {
+    weatherScreenDrawn = false;
     fetchWeatherDetails();
     delay(10);
     drawWeatherDisplay();
@@ -536,49 +596,52 @@ void updateDisplayBrightness() {
 
 /////////////////////////////////////////////////////////////////
 void drawSensorDisplay() {
-    // Draw display
-    M5.Lcd.fillScreen(TFT_WHITE);
-
     int pad = 20;
     int textX = pad;
     int textY = pad;
 
-    // Header
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextColor(TFT_RED);
-    M5.Display.setTextSize(2);
-    M5.Display.println("Live Sensor Readings");
+    // The values are at most 6 characters ("-40.0F", "100.0%"), and the
+    // labels are only drawn when the screen is entered, so they go past
+    // the widest value instead of where the values could overwrite them
+    sensorTempDisplay.begin(&M5.Display, 4, TFT_DARKGREY, TFT_WHITE);
+    sensorHumDisplay.begin(&M5.Display, 4, TFT_DARKGREY, TFT_WHITE);
+    int labelX = textX + max(sensorTempDisplay.width(6), sensorHumDisplay.width(6)) + 12;
+
+    // Draw display, the labels only when the screen is entered
+    if (!sensorScreenDrawn) {
+        M5.Lcd.fillScreen(TFT_WHITE);
+
+        // Header
+        M5.Display.setCursor(textX, textY);
+        M5.Display.setTextColor(TFT_RED);
+        M5.Display.setTextSize(2);
+        M5.Display.println("Live Sensor Readings");
+
+        // Labels
+        M5.Display.setTextColor(TFT_DARKGREY);
+        M5.Display.setCursor(labelX, textY + 40);
+        M5.Display.print("Temperature");
+        M5.Display.setCursor(labelX, textY + 120);
+        M5.Display.print("Humidity");
+
+        // Timestamp
+        M5.Display.setCursor(pad, sHeight - 30);
+        M5.Display.printf("Last Sync: %s", lastSyncTime.c_str());
+
+        sensorTempDisplay.invalidate();
+        sensorHumDisplay.invalidate();
+        sensorScreenDrawn = true;
+    }
+
+    sensorTempDisplay.setPosition(textX, textY + 40);
+    sensorHumDisplay.setPosition(textX, textY + 120);
 
     // Temperature
-    textY += 40;
     float displayTemp = isFahrenheit ? (SENSOR_TEMPERATURE * 9/5) + 32 : SENSOR_TEMPERATURE;
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextColor(TFT_DARKGREY);
-    M5.Display.setTextSize(4);
-    M5.Display.printf("%.1f%s\n", displayTemp, unit);
+    sensorTempDisplay.printf("%.1f%s", displayTemp, unit.c_str());
 
     // Humidity
-    textY += 80;
-    M5.Display.setCursor(textX, textY);
-    M5.Display.setTextSize(4);
-    M5.Display.printf("%.1f%%\n", SENSOR_HUMIDITY);
-
-    // Labels
-    textY = pad + 40;
-    M5.Display.setCursor(textX + 120, textY);
-    M5.Display.setTextSize(2);
-    M5.Display.print("Temperature");
-
-    textY += 80;
-    M5.Display.setCursor(textX + 120, textY);
-    M5.Display.print("Humidity");
-
-    // Timestamp
-    textY = sHeight - 30;
-    M5.Display.setCursor(pad, textY);
-    M5.Display.setTextColor(TFT_DARKGREY);
-    M5.Display.setTextSize(2);
-    M5.Display.printf("Last Sync: %s", lastSyncTime.c_str());
+    sensorHumDisplay.printf("%.1f%%", SENSOR_HUMIDITY);
 }
 
 //////////////////////////////////////////////////////////////////////////////////